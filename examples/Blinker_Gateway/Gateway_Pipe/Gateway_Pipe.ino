@@ -0,0 +1,291 @@
+/* *****************************************************************
+ *
+ * Download latest Blinker library here:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * 
+ * Blinker is a cross-hardware, cross-platform solution for the IoT. 
+ * It provides APP, device and server support, 
+ * and uses public cloud services for data transmission and storage.
+ * It can be used in smart home, data monitoring and other fields 
+ * to help users build Internet of Things projects better and faster.
+ * 
+ * Make sure installed 2.5.0 or later ESP8266/Arduino package,
+ * if use ESP8266 with Blinker.
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * Docs: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************
+ * 
+ * Blinker 库下载地址:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * Blinker 是一套跨硬件、跨平台的物联网解决方案，提供APP端、设备端、
+ * 服务器端支持，使用公有云服务进行数据传输存储。可用于智能家居、
+ * 数据监测等领域，可以帮助用户更好更快地搭建物联网项目。
+ * 
+ * 如果使用 ESP8266 接入 Blinker,
+ * 请确保安装了 2.5.0 或更新的 ESP8266/Arduino 支持包。
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * 文档: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************/
+
+#define BLINKER_GATEWAY
+#define BLINKER_SUB_TLV
+
+#include <Blinker.h>
+#include <Adapters/BlinkerSubStream.h>
+
+/*
+ Link test of the gateway routing, no network is needed.
+ The real gateway runs over string pipes: the app link and every
+ sub device are BlinkerSubStream objects, the downstream link is shared
+ so every node sees every frame, all nodes share one upstream link.
+ Frames are line based like on a serial link.
+ The max frame check needs about 50KB of heap, use an ESP32.
+ */
+
+#define NODE_NUM    4
+
+// the gateway only link methods, nothing uses them here
+class PipeStream : public BlinkerSubStream
+{
+    public :
+        int aliPrint(const String & data)   { return false; }
+        int duerPrint(const String & data)  { return false; }
+        int bPrint(char * name, const String & data) { return false; }
+        int autoPrint(uint32_t id)  { return false; }
+        void sharers(const String & data) {}
+        int aligenieAvail()         { return false; }
+        int duerAvail()             { return false; }
+        int needFreshShare()        { return false; }
+        BlinkerSupervisor * link()  { return NULL; }
+        char * deviceName()         { return ""; }
+        char * authKey()            { return ""; }
+        int init()                  { return true; }
+        int mConnected()            { return true; }
+        void freshAlive()           {}
+};
+
+PipeStream app;
+PipeStream node[NODE_NUM + 1];
+
+String appDown;
+String appUp;
+String down[NODE_NUM + 1];
+String up;
+
+uint8_t active = 0;
+uint16_t failed = 0;
+
+void check(bool state, const String & what)
+{
+    if (state) return;
+
+    failed++;
+    BLINKER_LOG("FAIL: ", what);
+}
+
+void pipeWrite(String & pipe, const String & frame)
+{
+    pipe += frame;
+    pipe += '\n';
+}
+
+String pipeRead(String & pipe)
+{
+    int end = pipe.indexOf('\n');
+
+    if (end < 0) return "";
+
+    String frame = pipe.substring(0, end);
+    pipe.remove(0, end + 1);
+
+    return frame;
+}
+
+int appAvail()                      { return appDown.length(); }
+String appRead()                    { String data = appDown; appDown = ""; return data; }
+void appPrint(const String & data)  { appUp += data; }
+
+int gatewayAvail()                  { return up.indexOf('\n') >= 0; }
+String gatewayRead()                { return pipeRead(up); }
+
+void gatewayPrint(const String & frame)
+{
+    for (uint8_t num = 1; num <= NODE_NUM; num++) pipeWrite(down[num], frame);
+}
+
+// node callbacks act for the node in active
+int nodeAvail()                     { return down[active].indexOf('\n') >= 0; }
+String nodeRead()                   { return pipeRead(down[active]); }
+void nodePrint(const String & frame){ pipeWrite(up, frame); }
+
+// next frame the node accepts, foreign frames are filtered
+bool nodeGet(uint8_t num, String & json)
+{
+    active = num;
+
+    while (nodeAvail())
+    {
+        if (node[num].available())
+        {
+            json = node[num].lastRead();
+            node[num].flush();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void nodeSend(uint8_t num, const String & json)
+{
+    char data[128];
+
+    json.toCharArray(data, sizeof(data));
+    node[num].print(data, false);
+}
+
+// app message in, gateway output to the app back
+String gatewayPass(const String & data)
+{
+    appDown = data;
+    appUp = "";
+
+    Blinker.gatewayPoll();
+
+    while (up.length()) Blinker.gatewayPoll();
+
+    delay(BLINKER_MSG_AUTOFORMAT_TIMEOUT + 10);
+    Blinker.gatewayPoll();
+
+    return appUp;
+}
+
+String nodeName(uint8_t num)
+{
+    return "node" + String(num);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    BLINKER_DEBUG.stream(Serial);
+
+    String json, data;
+    uint8_t id;
+
+    app.attachAvailable(appAvail);
+    app.attachRead(appRead);
+    app.attachPrint(appPrint);
+
+    Blinker.transport(app);
+    Blinker.attachGatewayAvailable(gatewayAvail);
+    Blinker.attachGatewayRead(gatewayRead);
+    Blinker.attachGatewayPrint(gatewayPrint);
+
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        char name[BLINKER_SUB_DEVICE_NS_SIZE];
+
+        nodeName(num).toCharArray(name, sizeof(name));
+        check(Blinker.attachSubDevice(name) == num, "attach " + nodeName(num));
+
+        node[num].attachAvailable(nodeAvail);
+        node[num].attachRead(nodeRead);
+        node[num].attachPrint(nodePrint);
+        node[num].subAddress(num);
+    }
+
+    // one app message is split by node, each frame only reaches its node
+    data = "{";
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        if (num > 1) data += ",";
+        data += "\"" + nodeName(num) + "/btn-abc\":\"tap\",\"" + nodeName(num) + "/num-abc\":" + String(num);
+    }
+    data += "}";
+
+    gatewayPass(data);
+
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        check(nodeGet(num, json) && json == "{\"btn-abc\":\"tap\",\"num-abc\":" + String(num) + "}", \
+            "json down " + nodeName(num) + ": " + json);
+        check(!nodeGet(num, json), "foreign frame " + nodeName(num));
+    }
+
+    // a state request is broadcast to every node
+    gatewayPass("{\"get\":\"state\"}");
+
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        check(nodeGet(num, json) && json == "{\"get\":\"state\"}", "broadcast " + nodeName(num));
+    }
+
+    // nodes answer in tlv, the gateway names their keys for the app
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        nodeSend(num, "{\"btn-abc\":\"on\",\"cnt\":-" + String(num) + "}");
+    }
+
+    data = gatewayPass("");
+
+    for (uint8_t num = 1; num <= NODE_NUM; num++)
+    {
+        check(data.indexOf("\"" + nodeName(num) + "/btn-abc\":\"on\"") >= 0 && \
+            data.indexOf("\"" + nodeName(num) + "/cnt\":-" + String(num)) >= 0, \
+            "tlv up " + nodeName(num) + ": " + data);
+
+        // a dictionary sync the gateway may have asked for
+        while (nodeGet(num, json)) check(json == "{}", "sync " + nodeName(num) + ": " + json);
+    }
+
+    // the gateway now talks tlv to them, twice so the second pass
+    // uses the key dictionary
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        data = "{";
+        for (uint8_t num = 1; num <= NODE_NUM; num++)
+        {
+            if (num > 1) data += ",";
+            data += "\"" + nodeName(num) + "/btn-abc\":\"off\",\"" + nodeName(num) + "/rgb-abc\":[255,0," + String(num) + "]";
+        }
+        data += "}";
+
+        gatewayPass(data);
+
+        for (uint8_t num = 1; num <= NODE_NUM; num++)
+        {
+            check(nodeGet(num, json) && json == "{\"btn-abc\":\"off\",\"rgb-abc\":[255,0," + String(num) + "]}", \
+                "tlv down " + nodeName(num) + ": " + json);
+            check(!nodeGet(num, json), "tlv foreign frame " + nodeName(num));
+        }
+    }
+
+    // unframed data still passes
+    check(STRING_frame_decode("{\"raw\":1}", id, json) == BLINKER_FRAME_RAW && json == "{\"raw\":1}", "raw");
+
+    // the length field holds 14 bits, a longer frame is refused
+    String big;
+    big.reserve(BLINKER_FRAME_MAX_LEN + 1);
+    for (uint16_t num = 0; num < BLINKER_FRAME_MAX_LEN; num++) big += 'a';
+
+    String frame = STRING_frame_encode(1, big);
+    check(frame.length() == BLINKER_FRAME_MAX_LEN + BLINKER_FRAME_HEAD_SIZE, "max frame");
+    check(STRING_frame_decode(frame, id, json) == BLINKER_FRAME_JSON && json.length() == BLINKER_FRAME_MAX_LEN, "max frame decode");
+
+    big += 'a';
+    check(STRING_frame_encode(1, big).length() == 0, "oversized frame");
+
+    BLINKER_LOG("gateway pipe test failed: ", failed);
+}
+
+void loop() {
+}
@@ -90,6 +90,12 @@ void setup()
     Blinker.attachGatewayAvailable(gatewayAvail);
     Blinker.attachGatewayRead(gatewayRead);
     Blinker.attachGatewayPrint(gatewayPrint);
+
+    /*
+    Widgets of a sub device use keys like "node1/btn-abc",
+    sub device "node1" gets id 1, set it by Blinker.subAddress(1)
+    */
+    Blinker.attachSubDevice("node1");
 }
 
 void loop() {
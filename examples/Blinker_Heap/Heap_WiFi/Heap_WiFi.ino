@@ -0,0 +1,101 @@
+/* *****************************************************************
+ *
+ * Download latest Blinker library here:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * 
+ * Blinker is a cross-hardware, cross-platform solution for the IoT. 
+ * It provides APP, device and server support, 
+ * and uses public cloud services for data transmission and storage.
+ * It can be used in smart home, data monitoring and other fields 
+ * to help users build Internet of Things projects better and faster.
+ * 
+ * Make sure installed 2.5.0 or later ESP8266/Arduino package,
+ * if use ESP8266 with Blinker.
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * Docs: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************
+ * 
+ * Blinker 库下载地址:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * Blinker 是一套跨硬件、跨平台的物联网解决方案，提供APP端、设备端、
+ * 服务器端支持，使用公有云服务进行数据传输存储。可用于智能家居、
+ * 数据监测等领域，可以帮助用户更好更快地搭建物联网项目。
+ * 
+ * 如果使用 ESP8266 接入 Blinker,
+ * 请确保安装了 2.5.0 或更新的 ESP8266/Arduino 支持包。
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * 文档: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************/
+
+#define BLINKER_WIFI
+// 统计 Blinker 库的堆内存分配
+#define BLINKER_HEAP_TRACK
+
+#include <Blinker.h>
+
+char auth[] = "Your Device Secret Key";
+char ssid[] = "Your WiFi network SSID or name";
+char pswd[] = "Your WiFi network WPA password or WEP key";
+
+// 新建组件对象
+BlinkerButton Button1("btn-abc");
+BlinkerNumber Number1("num-abc");
+
+int counter = 0;
+uint16_t heap_base = 0;
+uint32_t check_time = 0;
+
+// 按下按键即会执行该函数, 每次上报都会申请并释放发送缓存
+void button1_callback(const String & state)
+{
+    BLINKER_LOG("get button state: ", state);
+
+    counter++;
+    Number1.print(counter);
+    Number1.text(state);
+}
+
+void setup()
+{
+    // 初始化串口
+    Serial.begin(115200);
+    BLINKER_DEBUG.stream(Serial);
+
+    // 初始化blinker
+    Blinker.begin(auth, ssid, pswd);
+
+    Button1.attach(button1_callback);
+
+    // 组件名称常驻内存, 以此为基准
+    heap_base = BLINKER_HEAP.leaks();
+}
+
+void loop() {
+    Blinker.run();
+
+    // 每 10 秒检查一次, 消息发出后除基准外不应再有未释放的内存块
+    if (millis() - check_time >= 10000)
+    {
+        check_time = millis();
+
+        uint16_t leaks = BLINKER_HEAP.leaks() - heap_base;
+
+        if (leaks == 0)
+        {
+            BLINKER_LOG("heap ok");
+        }
+        else
+        {
+            BLINKER_LOG("heap leaks: ", leaks);
+            Blinker.heapReport();
+        }
+    }
+}
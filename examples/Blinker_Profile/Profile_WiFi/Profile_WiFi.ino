@@ -0,0 +1,86 @@
+/* *****************************************************************
+ *
+ * Download latest Blinker library here:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * 
+ * Blinker is a cross-hardware, cross-platform solution for the IoT. 
+ * It provides APP, device and server support, 
+ * and uses public cloud services for data transmission and storage.
+ * It can be used in smart home, data monitoring and other fields 
+ * to help users build Internet of Things projects better and faster.
+ * 
+ * Make sure installed 2.5.0 or later ESP8266/Arduino package,
+ * if use ESP8266 with Blinker.
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * Docs: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************
+ * 
+ * Blinker 库下载地址:
+ * https://github.com/blinker-iot/blinker-library/archive/master.zip
+ * 
+ * Blinker 是一套跨硬件、跨平台的物联网解决方案，提供APP端、设备端、
+ * 服务器端支持，使用公有云服务进行数据传输存储。可用于智能家居、
+ * 数据监测等领域，可以帮助用户更好更快地搭建物联网项目。
+ * 
+ * 如果使用 ESP8266 接入 Blinker,
+ * 请确保安装了 2.5.0 或更新的 ESP8266/Arduino 支持包。
+ * https://github.com/esp8266/Arduino/releases
+ * 
+ * 文档: https://doc.blinker.app/
+ *       https://github.com/blinker-iot/blinker-doc/wiki
+ * 
+ * *****************************************************************/
+
+#define BLINKER_WIFI
+// 统计 Blinker.run() 各阶段耗时
+#define BLINKER_PROFILE
+
+#include <Blinker.h>
+
+char auth[] = "Your Device Secret Key";
+char ssid[] = "Your WiFi network SSID or name";
+char pswd[] = "Your WiFi network WPA password or WEP key";
+
+// 新建组件对象
+BlinkerButton Button1("btn-abc");
+BlinkerText Text1("tex-abc");
+
+uint32_t dump_time = 0;
+
+// 按下按键即会上报并清空统计结果
+void button1_callback(const String & state)
+{
+    BLINKER_LOG("get button state: ", state);
+
+    Text1.print(Blinker.profile());
+    Blinker.profileReset();
+}
+
+void setup()
+{
+    // 初始化串口
+    Serial.begin(115200);
+    BLINKER_DEBUG.stream(Serial);
+
+    // 初始化blinker
+    Blinker.begin(auth, ssid, pswd);
+
+    Button1.attach(button1_callback);
+}
+
+void loop() {
+    Blinker.run();
+
+    // 每 10 秒打印一次统计结果,
+    // 各阶段为 log2 直方图(us), worst 为最慢一次循环及其处理的消息
+    if (millis() - dump_time >= 10000)
+    {
+        dump_time = millis();
+
+        BLINKER_LOG("profile: ", Blinker.profile());
+    }
+}
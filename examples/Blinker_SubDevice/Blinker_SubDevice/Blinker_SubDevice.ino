@@ -36,6 +36,7 @@
  * *****************************************************************/
 
 #define BLINKER_SUBDEVICE
+// #define BLINKER_SUB_TLV  // compact binary frames, needs Blinker.subAddress()
 
 #include <Blinker.h>
 
@@ -88,6 +89,11 @@ void setup()
     Blinker.attachSubAvailable(subDeviceAvail);
     Blinker.attachSubRead(subDeviceRead);
     Blinker.attachSubPrint(subDevicePrint);
+
+    /*
+    Id given by Blinker.attachSubDevice() on the gateway
+    */
+    Blinker.subAddress(1);
 }
 
 void loop() {
@@ -16,6 +16,8 @@
 
 #include "modules/ArduinoJson/ArduinoJson.h"
 
+#include "Blinker/BlinkerJson.h"
+
 class BlinkerAIR202LP : public BlinkerStream
 {
     public :
@@ -46,6 +48,7 @@ class BlinkerAIR202LP : public BlinkerStream
         char * authKey() { return _authKey; }
         int init() { return isGPRSinit; }
         int deviceRegister() { return connectServer(); }
+        int restore(const char* _key, const char* _name);
 
     private :
         bool isGPRSinit = false;
@@ -110,7 +113,7 @@ int BlinkerAIR202LP::print(char * data, bool needCheck)
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& data_rp = jsonBuffer.parseObject(payload);
 
     if (data_rp.success())
@@ -167,7 +170,7 @@ void BlinkerAIR202LP::dataGet()
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& data_rp = jsonBuffer.parseObject(payload);
 
     if (data_rp.success())
@@ -212,6 +215,24 @@ void BlinkerAIR202LP::begin(const char* _key, const char* _type, String _imei)
     // strcpy(authKey, _deviceType);
 }
 
+// credentials kept from an earlier wake, no round trip to the server
+int BlinkerAIR202LP::restore(const char* _key, const char* _name)
+{
+    if (_isAuthKey) free(_authKey);
+    _authKey = (char*)malloc((strlen(_key)+1)*sizeof(char));
+    strcpy(_authKey, _key);
+    _isAuthKey = true;
+
+    if (isGPRSinit) free(_deviceName);
+    _deviceName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+    strcpy(_deviceName, _name);
+    isGPRSinit = true;
+
+    BLINKER_LOG_ALL(BLINKER_F("restore deviceName: "), _deviceName);
+
+    return true;
+}
+
 void BlinkerAIR202LP::initStream(Stream& s, bool state, blinker_callback_t func)
 {
     stream = &s;
@@ -266,7 +287,7 @@ int BlinkerAIR202LP::connectServer()
         BLINKER_LOG_ALL(payload);
         BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(payload);
 
         if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -322,7 +343,7 @@ int BlinkerAIR202LP::connectServer()
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
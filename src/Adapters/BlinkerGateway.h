@@ -21,12 +21,16 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerGateway.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Functions/BlinkerWlanCache.h"
 
 enum b_config_t {
     COMM,
@@ -96,6 +100,7 @@ class BlinkerGateway : public BlinkerStream
         int init() { if (!isMQTTinit) checkInit(); return isMQTTinit; }
         int reRegister() { return connectServer(); }
         void freshAlive() { kaTime = millis(); isAlive = true; }
+        BlinkerSupervisor * link() { return &_link; }
         void sharers(const String & data);
         int  needFreshShare() {
             if (_needCheckShare)
@@ -139,9 +144,10 @@ class BlinkerGateway : public BlinkerStream
         int checkDuerPrintSpan();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
+        BlinkerSupervisor   _link;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
+        BlinkerWlanCache    _wlanCache;
         bool        _isWiFiInit = false;
         bool        _isBegin = false;
         b_config_t  _configType = COMM;
@@ -268,6 +274,10 @@ void webSocketEvent_MQTT(uint8_t num, WStype_t type, \
             // webSocket_MQTT.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -285,44 +295,24 @@ int BlinkerGateway::connect()
 {
     if (!checkInit()) return false;
 
-    int8_t ret;
-
     webSocket_MQTT.loop();
 
-    if (mqtt_MQTT->connected())
-    {
-        return true;
-    }
+    if (_link.connected()) return true;
 
-    disconnect();
+    int8_t ret = _link.connect();
 
-    if ((millis() - latestTime) < BLINKER_MQTT_CONNECT_TIMESLOT && latestTime > 0)
+    if (ret == MQTT_CONNECT_WAIT)
     {
         yield();
         return false;
     }
 
-    BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
-
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_ID_MQTT: "), MQTT_ID_MQTT);
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_NAME_MQTT: "), MQTT_NAME_MQTT);
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_KEY_MQTT: "), MQTT_KEY_MQTT);
-
-    #if defined(ESP8266)
-        client_mqtt.setInsecure();
-        ::delay(10);
-    #endif
-
-    if ((ret = mqtt_MQTT->connect()) != 0)
+    if (ret != 0)
     {
         BLINKER_LOG(mqtt_MQTT->connectErrorString(ret));
-        BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
-                    BLINKER_MQTT_CONNECT_TIMESLOT/1000, \
-                    BLINKER_F(" seconds..."));
 
-        if (ret == 4) reRegister();
+        if (ret == 4 || _link.failNum() % 12 == 0) reRegister();
 
-        this->latestTime = millis();
         return false;
     }
 
@@ -351,7 +341,7 @@ int BlinkerGateway::connected()
         return *isHandle;
     }
 
-    return mqtt_MQTT->connected() || *isHandle;
+    return _link.connected() || *isHandle;
 }
 
 int BlinkerGateway::mConnected()
@@ -359,14 +349,14 @@ int BlinkerGateway::mConnected()
     if (!checkInit()) return false;
 
     if (!isMQTTinit) return false;
-    else return mqtt_MQTT->connected();
+    else return _link.connected();
 }
 
 void BlinkerGateway::disconnect()
 {
     if (!checkInit()) return;
 
-    mqtt_MQTT->disconnect();
+    _link.disconnect();
 
     if (*isHandle) webSocket_MQTT.disconnect();
 }
@@ -375,21 +365,7 @@ void BlinkerGateway::ping()
 {
     if (!checkInit()) return;
 
-    BLINKER_LOG(BLINKER_F("MQTT Ping!"));
-
-    BLINKER_LOG_FreeHeap_ALL();
-
-    if (!mqtt_MQTT->ping())
-    {
-        disconnect();
-        // delay(100);
-
-        // connect();
-    }
-    else
-    {
-        this->latestTime = millis();
-    }
+    _link.keepAlive(latestTime);
 }
 
 int BlinkerGateway::available()
@@ -400,16 +376,8 @@ int BlinkerGateway::available()
 
     checkKA();
 
-    // if (!mqtt_MQTT->connected() || 
-    //     (millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-    if ((millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-    {
-        ping();
-    }
-    else
-    {
-        subscribe();
-    }
+    ping();
+    subscribe();
 
     if (isAvail_MQTT)
     {
@@ -469,13 +437,13 @@ void BlinkerGateway::subscribe()
     if (!isMQTTinit) return;
 
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_MQTT->readSubscription(10)))
+    while ((subscription = mqtt_MQTT->readSubscription(0)))
     {
         if (subscription == iotSub_MQTT)
         {
             BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_MQTT->lastread);
 
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_MQTT->lastread));
 
             String _uuid = root["fromDevice"];
@@ -521,31 +489,28 @@ void BlinkerGateway::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
-                    {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
+                    int8_t num = _sharers.find(_uuid.c_str());
 
-                            kaTime = millis();
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
+                    {
+                        _sharerFrom = num;
 
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
-                            
-                            _needCheckShare = false;
+                        kaTime = millis();
 
-                            break;
-                        }
-                        else
-                        {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                                        check is from bridge/share device, \
-                                        data: "), dataGet);
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
+                                    check is from bridge/share device, \
+                                    data: "), dataGet);
 
-                            _needCheckShare = true;
-                        }
+                        _needCheckShare = true;
                     }
                 }
                 // else
@@ -660,36 +625,18 @@ int BlinkerGateway::print(char * data, bool needCheck)
         //     // payload += BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
         // }
 
-        uint16_t num = strlen(data);
-
-        data[num+8] = '\0';
-
-        for(uint16_t c_num = num; c_num > 0; c_num--)
-        {
-            data[c_num+7] = data[c_num-1];
-        }
-
-        String data_add = BLINKER_F("{\"data\":");
-        for(uint8_t c_num = 0; c_num < 8; c_num++)
-        {
-            data[c_num] = data_add[c_num];
-        }
+        // the envelope is sent around data, data itself is not moved
+        const char * toDevice = UUID_MQTT;
 
-        data_add = BLINKER_F(",\"fromDevice\":\"");
-        strcat(data, data_add.c_str());
-        strcat(data, MQTT_ID_MQTT);
-        data_add = BLINKER_F("\",\"toDevice\":\"");
-        strcat(data, data_add.c_str());
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
-        }
-        else
-        {
-            strcat(data, UUID_MQTT);
+            toDevice = _sharers.uuid(_sharerFrom);
         }
-        data_add = BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
-        strcat(data, data_add.c_str());
+
+        Adafruit_MQTT_Segment payload[] = {
+            "{\"data\":", data, ",\"fromDevice\":\"", MQTT_ID_MQTT,
+            "\",\"toDevice\":\"", toDevice, "\",\"deviceType\":\"OwnApp\"}"
+        };
 
         _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
 
@@ -724,7 +671,7 @@ int BlinkerGateway::print(char * data, bool needCheck)
                 }
             }
 
-            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data))
+            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, payload, sizeof(payload)/sizeof(payload[0])))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1248,40 +1195,26 @@ void BlinkerGateway::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (uint8_t num = _sharerCount; num > 0; num--)
-        {
-            delete _sharers[num - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 int BlinkerGateway::connectServer() {
@@ -1544,7 +1477,7 @@ int BlinkerGateway::connectServer() {
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1583,8 +1516,8 @@ int BlinkerGateway::connectServer() {
         free(DEVICE_NAME_MQTT);
         free(BLINKER_PUB_TOPIC_MQTT);
         free(BLINKER_SUB_TOPIC_MQTT);
-        free(mqtt_MQTT);
-        free(iotSub_MQTT);
+        delete mqtt_MQTT;
+        delete iotSub_MQTT;
 
         isMQTTinit = false;
     }
@@ -1795,6 +1728,7 @@ int BlinkerGateway::connectServer() {
     this->latestTime = millis() - BLINKER_MQTT_CONNECT_TIMESLOT;
     // if (!isMQTTinit)
     mqtt_MQTT->subscribe(iotSub_MQTT);
+    _link.attach(mqtt_MQTT);
 
     #if defined(ESP8266)
         // client_s->stop();
@@ -1942,7 +1876,7 @@ int BlinkerGateway::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
@@ -1975,11 +1909,14 @@ bool BlinkerGateway::checkInit()
 
                     // BLINKER_LOG(BLINKER_F("checkInit..."));
 
+                    _wlanCache.poll();
+
                     return false;
                 }
                 BLINKER_LOG(BLINKER_F("WiFi Connected."));
                 BLINKER_LOG(BLINKER_F("IP Address: "));
                 BLINKER_LOG(WiFi.localIP());
+                _wlanCache.save();
                 _isWiFiInit = true;
                 _connectTime = 0;
 
@@ -2020,6 +1957,7 @@ bool BlinkerGateway::checkInit()
                             BLINKER_LOG(BLINKER_F("WiFi Connected."));
                             BLINKER_LOG(BLINKER_F("IP Address: "));
                             BLINKER_LOG(WiFi.localIP());
+                            _wlanCache.save();
                             _isWiFiInit = true;
                             _connectTime = 0;
 
@@ -2058,6 +1996,7 @@ bool BlinkerGateway::checkInit()
                             BLINKER_LOG(BLINKER_F("WiFi Connected."));
                             BLINKER_LOG(BLINKER_F("IP Address: "));
                             BLINKER_LOG(WiFi.localIP());
+                            _wlanCache.save();
                             _isWiFiInit = true;
                             _connectTime = 0;
 
@@ -2387,7 +2326,7 @@ void BlinkerGateway::checkAPCFG()
 bool BlinkerGateway::parseUrl(String data)
 {
     BLINKER_LOG(BLINKER_F("APCONFIG data: "), data);
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& wifi_data = jsonBuffer.parseObject(data);
 
     if (!wifi_data.success()) {
@@ -2430,12 +2369,7 @@ void BlinkerGateway::connectWiFi(const char* _ssid, const char* _pswd)
         WiFi.setHostname(_hostname.c_str());
     #endif
 
-    if (_pswd && strlen(_pswd)) {
-        WiFi.begin(_ssid, _pswd);
-    }
-    else {
-        WiFi.begin(_ssid);
-    }
+    _wlanCache.begin(_ssid, _pswd);
 
     // while (WiFi.status() != WL_CONNECTED) {
     //     ::delay(50);
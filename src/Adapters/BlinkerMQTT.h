@@ -21,12 +21,18 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerMQTT.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+#include "Functions/BlinkerWlanCache.h"
+#include "Blinker/BlinkerRegCache.h"
 
 enum b_config_t {
     COMM,
@@ -78,6 +84,8 @@ class BlinkerMQTT : public BlinkerStream
         // bool extraAvailable();
         void subscribe();
         char * lastRead();
+        JsonObject * lastObject();
+        void hold(bool state);
         void flush();
         int print(char * data, bool needCheck = true);
         int bPrint(char * name, const String & data);
@@ -96,6 +104,7 @@ class BlinkerMQTT : public BlinkerStream
         int init() { if (!isMQTTinit) checkInit(); return isMQTTinit; }
         int reRegister() { return connectServer(); }
         void freshAlive() { kaTime = millis(); isAlive = true; }
+        BlinkerSupervisor * link() { return &_link; }
         void sharers(const String & data);
         int  needFreshShare() {
             if (_needCheckShare)
@@ -128,6 +137,10 @@ class BlinkerMQTT : public BlinkerStream
         bool isMQTTinit = false;
 
         int connectServer();
+        String registerGet();
+        String regId() { return STRING_format(_authKey) + _aliType + _duerType; }
+        // copies data to at and moves at past it
+        char * arenaCopy(char * & at, const String & data);
         void mDNSInit();
         void checkKA();
         int checkAliKA();
@@ -140,9 +153,12 @@ class BlinkerMQTT : public BlinkerStream
         int checkPrintLimit();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
+        BlinkerSupervisor   _link;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
+        BlinkerWlanCache    _wlanCache;
+        BlinkerRegCache     _regCache;
+        bool        _isRegCached = false;
         bool        _isWiFiInit = false;
         bool        _isBegin = false;
         b_config_t  _configType = COMM;
@@ -184,8 +200,6 @@ class BlinkerMQTT : public BlinkerStream
         WiFiClient _apClient;
         #endif
 
-        uint8_t     reconnect_time = 0;
-
         uint32_t    _print_time = 0;
         uint8_t     _print_times = 0;
 };
@@ -199,6 +213,8 @@ char*       UUID_MQTT;
 char*       DEVICE_NAME_MQTT;
 char*       BLINKER_PUB_TOPIC_MQTT;
 char*       BLINKER_SUB_TOPIC_MQTT;
+// the block all of the above point into
+char*       MQTT_ARENA_MQTT;
 uint16_t    MQTT_PORT_MQTT;
 
 #if defined(ESP8266)
@@ -216,8 +232,12 @@ Adafruit_MQTT_Subscribe* iotSub_MQTT;
 #define WS_SERVERPORT       81
 WebSocketsServer webSocket_MQTT = WebSocketsServer(WS_SERVERPORT);
 
-char*    msgBuf_MQTT;
+char     msgBuf_MQTT[BLINKER_MAX_READ_SIZE];
 bool     isFresh_MQTT = false;
+// in-situ parse tree of the last mqtt message, points into lastread
+BlinkerJsonBuffer   jsonBuf_MQTT;
+JsonObject*         dataObj_MQTT = NULL;
+bool                isHold_MQTT = false;
 bool     isConnect_MQTT = false;
 bool     isAvail_MQTT = false;
 uint8_t  ws_num_MQTT = 0;
@@ -256,9 +276,9 @@ void webSocketEvent_MQTT(uint8_t num, WStype_t type, \
                             BLINKER_F(", length: "), length);
 
             if (length < BLINKER_MAX_READ_SIZE) {
-                if (isFresh_MQTT) free(msgBuf_MQTT);
-                msgBuf_MQTT = (char*)malloc((length+1)*sizeof(char));
-                strcpy(msgBuf_MQTT, (char*)payload);
+                memcpy(msgBuf_MQTT, payload, length);
+                msgBuf_MQTT[length] = '\0';
+                dataObj_MQTT = NULL;
                 isAvail_MQTT = true;
                 isFresh_MQTT = true;
             }
@@ -274,6 +294,10 @@ void webSocketEvent_MQTT(uint8_t num, WStype_t type, \
             // webSocket_MQTT.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -291,54 +315,26 @@ int BlinkerMQTT::connect()
 {
     if (!checkInit()) return false;
 
-    int8_t ret;
-
     webSocket_MQTT.loop();
 
-    if (mqtt_MQTT->connected())
-    {
-        return true;
-    }
+    if (_link.connected()) return true;
 
-    disconnect();
+    int8_t ret = _link.connect();
 
-    if ((millis() - latestTime) < BLINKER_MQTT_CONNECT_TIMESLOT && latestTime > 0)
+    if (ret == MQTT_CONNECT_WAIT)
     {
         yield();
         return false;
     }
 
-    BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
-
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_ID_MQTT: "), MQTT_ID_MQTT);
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_NAME_MQTT: "), MQTT_NAME_MQTT);
-    // BLINKER_LOG_ALL(BLINKER_F("MQTT_KEY_MQTT: "), MQTT_KEY_MQTT);
-
-    #if defined(ESP8266)
-        client_mqtt.setInsecure();
-        ::delay(10);
-    #endif
-
-    if ((ret = mqtt_MQTT->connect()) != 0)
+    if (ret != 0)
     {
         BLINKER_LOG(mqtt_MQTT->connectErrorString(ret));
-        BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
-                    BLINKER_MQTT_CONNECT_TIMESLOT/1000, \
-                    BLINKER_F(" seconds..."));
 
-        if (ret == 4) reRegister();
+        if (ret == 4 || _link.failNum() % 12 == 0) reRegister();
 
-        this->latestTime = millis();
-        reconnect_time += 1;
-        if (reconnect_time >= 12)
-        {
-            reRegister();
-            reconnect_time = 0;
-        }
         return false;
     }
-    
-    reconnect_time = 0;
 
     BLINKER_LOG(BLINKER_F("MQTT Connected!"));
     BLINKER_LOG_FreeHeap();
@@ -365,7 +361,7 @@ int BlinkerMQTT::connected()
         return *isHandle;
     }
 
-    return mqtt_MQTT->connected() || *isHandle;
+    return _link.connected() || *isHandle;
 }
 
 int BlinkerMQTT::mConnected()
@@ -373,14 +369,14 @@ int BlinkerMQTT::mConnected()
     if (!checkInit()) return false;
 
     if (!isMQTTinit) return false;
-    else return mqtt_MQTT->connected();
+    else return _link.connected();
 }
 
 void BlinkerMQTT::disconnect()
 {
     if (!checkInit()) return;
 
-    mqtt_MQTT->disconnect();
+    _link.disconnect();
 
     if (*isHandle) webSocket_MQTT.disconnect();
 }
@@ -389,21 +385,7 @@ void BlinkerMQTT::ping()
 {
     if (!checkInit()) return;
 
-    BLINKER_LOG(BLINKER_F("MQTT Ping!"));
-
-    BLINKER_LOG_FreeHeap_ALL();
-
-    if (!mqtt_MQTT->ping())
-    {
-        disconnect();
-        // delay(100);
-
-        // connect();
-    }
-    else
-    {
-        this->latestTime = millis();
-    }
+    _link.keepAlive(latestTime);
 }
 
 int BlinkerMQTT::available()
@@ -412,20 +394,18 @@ int BlinkerMQTT::available()
 
     webSocket_MQTT.loop();
 
+    if (isMQTTinit && _isRegCached && _regCache.expired())
+    {
+        _regCache.erase();
+        reRegister();
+    }
+
     checkKA();
 #if defined(ESP8266)
     MDNS.update();
 #endif
-    // if (!mqtt_MQTT->connected() || 
-    //     (millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-    if ((millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-    {
-        ping();
-    }
-    else
-    {
-        subscribe();
-    }
+    ping();
+    subscribe();
 
     if (isAvail_MQTT)
     {
@@ -484,23 +464,57 @@ void BlinkerMQTT::subscribe()
 
     if (!isMQTTinit) return;
 
+    // last message still in dispatch, its parse tree points into lastread
+    if (isHold_MQTT) return;
+
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_MQTT->readSubscription(10)))
+    while ((subscription = mqtt_MQTT->readSubscription(0)))
     {
         if (subscription == iotSub_MQTT)
         {
-            BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_MQTT->lastread);
+            char * _msg = (char *)iotSub_MQTT->lastread;
+
+            BLINKER_LOG_ALL(BLINKER_F("Got: "), _msg);
+
+            // copy out the raw data text before the parse below rewrites it
+            uint16_t _start, _end;
+            msgBuf_MQTT[0] = '\0';
+
+            if (JSON_find_value(_msg, BLINKER_CMD_DATA, _start, _end) && \
+                (_end - _start) < BLINKER_MAX_READ_SIZE)
+            {
+                memcpy(msgBuf_MQTT, _msg + _start, _end - _start);
+                msgBuf_MQTT[_end - _start] = '\0';
+            }
+
+            dataObj_MQTT = NULL;
+            jsonBuf_MQTT.clear();
+            JsonObject& root = jsonBuf_MQTT.parseObject(_msg);
+
+            if (!root.success())
+            {
+                BLINKER_ERR_LOG_ALL(BLINKER_F("parse failed"));
 
-            DynamicJsonBuffer jsonBuffer;
-            JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_MQTT->lastread));
+                continue;
+            }
+
+            const char * _uuid = root[BLINKER_CMD_FROMDEVICE];
+            if (!_uuid) _uuid = "";
+
+            JsonObject& dataGet = root[BLINKER_CMD_DATA];
+            dataObj_MQTT = dataGet.success() ? &dataGet : NULL;
 
-            String _uuid = root["fromDevice"];
-            String dataGet = root["data"];
+            // a string data comes out unquoted, as before
+            if (!dataObj_MQTT && root[BLINKER_CMD_DATA].is<const char*>())
+            {
+                strncpy(msgBuf_MQTT, root[BLINKER_CMD_DATA].as<const char*>(), BLINKER_MAX_READ_SIZE - 1);
+                msgBuf_MQTT[BLINKER_MAX_READ_SIZE - 1] = '\0';
+            }
 
-            BLINKER_LOG_ALL(BLINKER_F("data: "), dataGet);
+            BLINKER_LOG_ALL(BLINKER_F("data: "), msgBuf_MQTT);
             BLINKER_LOG_ALL(BLINKER_F("fromDevice: "), _uuid);
 
-            if (strcmp(_uuid.c_str(), UUID_MQTT) == 0)
+            if (strcmp(_uuid, UUID_MQTT) == 0)
             {
                 BLINKER_LOG_ALL(BLINKER_F("Authority uuid"));
 
@@ -510,7 +524,7 @@ void BlinkerMQTT::subscribe()
 
                 _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
             }
-            else if (_uuid == BLINKER_CMD_ALIGENIE)
+            else if (strcmp(_uuid, BLINKER_CMD_ALIGENIE) == 0)
             {
                 BLINKER_LOG_ALL(BLINKER_F("form AliGenie"));
 
@@ -518,7 +532,7 @@ void BlinkerMQTT::subscribe()
                 isAliAlive = true;
                 isAliAvail = true;
             }
-            else if (_uuid == BLINKER_CMD_DUEROS)
+            else if (strcmp(_uuid, BLINKER_CMD_DUEROS) == 0)
             {
                 BLINKER_LOG_ALL(BLINKER_F("form DuerOS"));
 
@@ -526,7 +540,7 @@ void BlinkerMQTT::subscribe()
                 isDuerAlive = true;
                 isDuerAvail = true;
             }
-            else if (_uuid == BLINKER_CMD_SERVERCLIENT)
+            else if (strcmp(_uuid, BLINKER_CMD_SERVERCLIENT) == 0)
             {
                 BLINKER_LOG_ALL(BLINKER_F("form Sever"));
 
@@ -537,59 +551,39 @@ void BlinkerMQTT::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
-                    {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
+                    int8_t num = _sharers.find(_uuid);
 
-                            kaTime = millis();
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
+                    {
+                        _sharerFrom = num;
 
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
-                            
-                            _needCheckShare = false;
+                        kaTime = millis();
 
-                            break;
-                        }
-                        else
-                        {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                                        check is from bridge/share device, \
-                                        data: "), dataGet);
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
+                                    check is from bridge/share device, \
+                                    data: "), msgBuf_MQTT);
 
-                            _needCheckShare = true;
-                        }
+                        _needCheckShare = true;
                     }
                 }
-                // else
-                // {
-                    // dataGet = String((char *)iotSub_MQTT->lastread);
-                    root.printTo(dataGet);
-
-                //     BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                //                         check is from bridge/share device, \
-                //                         data: "), dataGet);
-
-                //     // return;
 
-                //     // isBavail = true;
-
-                //     _needCheckShare = true;
-                // }
+                // bridge/share messages are handed on whole
+                root.printTo(msgBuf_MQTT, BLINKER_MAX_READ_SIZE);
+                dataObj_MQTT = &root;
 
                 isAvail_MQTT = true;
                 isAlive = true;
             }
 
-            // memset(msgBuf_MQTT, 0, BLINKER_MAX_READ_SIZE);
-            // memcpy(msgBuf_MQTT, dataGet.c_str(), dataGet.length());
-
-            if (isFresh_MQTT) free(msgBuf_MQTT);
-            msgBuf_MQTT = (char*)malloc((dataGet.length()+1)*sizeof(char));
-            strcpy(msgBuf_MQTT, dataGet.c_str());
             isFresh_MQTT = true;
 
             this->latestTime = millis();
@@ -605,13 +599,28 @@ char * BlinkerMQTT::lastRead()
     else return "";
 }
 
+JsonObject * BlinkerMQTT::lastObject()
+{
+    if (isFresh_MQTT) return dataObj_MQTT;
+    else return NULL;
+}
+
+void BlinkerMQTT::hold(bool state)
+{
+    isHold_MQTT = state;
+}
+
 void BlinkerMQTT::flush()
 {
     if (isFresh_MQTT)
     {
-        free(msgBuf_MQTT); isFresh_MQTT = false; isAvail_MQTT = false;
+        isFresh_MQTT = false; isAvail_MQTT = false;
         isAliAvail = false; //isBavail = false;
     }
+
+    // a nested run() may flush while the tree is still in dispatch
+    dataObj_MQTT = NULL;
+    if (!isHold_MQTT) jsonBuf_MQTT.clear();
 }
 
 int BlinkerMQTT::print(char * data, bool needCheck)
@@ -676,41 +685,18 @@ int BlinkerMQTT::print(char * data, bool needCheck)
         //     // payload += BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
         // }
 
-        uint16_t num = strlen(data);
-
-        for(uint16_t c_num = num; c_num > 0; c_num--)
-        {
-            data[c_num+7] = data[c_num-1];
-        }
-
-        data[num+8] = '\0';        
-
-        char data_add[20] = "{\"data\":";
-        for(uint8_t c_num = 0; c_num < 8; c_num++)
-        {
-            data[c_num] = data_add[c_num];
-        }
+        // the envelope is sent around data, data itself is not moved
+        const char * toDevice = UUID_MQTT;
 
-        // data_add = BLINKER_F(",\"fromDevice\":\"");
-        // strcat(data, data_add.c_str());
-        strcat(data, ",\"fromDevice\":\"");
-        strcat(data, MQTT_ID_MQTT);
-        // data_add = BLINKER_F("\",\"toDevice\":\"");
-        // strcat(data, data_add.c_str());
-        strcat(data, "\",\"toDevice\":\"");
-        
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
+            toDevice = _sharers.uuid(_sharerFrom);
         }
-        else
-        {
-            strcat(data, UUID_MQTT);
-        }
-        // data_add = BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
-        // strcat(data, data_add.c_str());
 
-        strcat(data, "\",\"deviceType\":\"OwnApp\"}");
+        Adafruit_MQTT_Segment payload[] = {
+            "{\"data\":", data, ",\"fromDevice\":\"", MQTT_ID_MQTT,
+            "\",\"toDevice\":\"", toDevice, "\",\"deviceType\":\"OwnApp\"}"
+        };
 
         _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
 
@@ -754,7 +740,7 @@ int BlinkerMQTT::print(char * data, bool needCheck)
                 BLINKER_LOG_ALL(BLINKER_F("_print_times: "), _print_times);
             }
 
-            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data))
+            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, payload, sizeof(payload)/sizeof(payload[0])))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1044,14 +1030,14 @@ int BlinkerMQTT::duerPrint(const String & data)
 
 void BlinkerMQTT::aliType(const String & type)
 {
-    _aliType = (char*)malloc((type.length()+1)*sizeof(char));
+    _aliType = (char*)BLINKER_MALLOC(HEAP_CRED, (type.length()+1)*sizeof(char));
     strcpy(_aliType, type.c_str());
     BLINKER_LOG_ALL(BLINKER_F("_aliType: "), _aliType);
 }
 
 void BlinkerMQTT::duerType(const String & type)
 {
-    _duerType = (char*)malloc((type.length()+1)*sizeof(char));
+    _duerType = (char*)BLINKER_MALLOC(HEAP_CRED, (type.length()+1)*sizeof(char));
     strcpy(_duerType, type.c_str());
     BLINKER_LOG_ALL(BLINKER_F("_duerType: "), _duerType);
 }
@@ -1059,7 +1045,7 @@ void BlinkerMQTT::duerType(const String & type)
 void BlinkerMQTT::begin(const char* auth) {
     // if (!checkInit()) return;
     // _authKey = auth;
-    _authKey = (char*)malloc((strlen(auth)+1)*sizeof(char));
+    _authKey = (char*)BLINKER_MALLOC(HEAP_CRED, (strlen(auth)+1)*sizeof(char));
     strcpy(_authKey, auth);
 
     BLINKER_LOG_ALL(BLINKER_F("_authKey: "), auth);
@@ -1278,43 +1264,29 @@ void BlinkerMQTT::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (uint8_t num = _sharerCount; num > 0; num--)
-        {
-            delete _sharers[num - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
-int BlinkerMQTT::connectServer() {
+String BlinkerMQTT::registerGet() {
     const int httpsPort = 443;
 #if defined(ESP8266)
     String host = BLINKER_F("iotdev.clz.me");
@@ -1569,6 +1541,27 @@ int BlinkerMQTT::connectServer() {
     http.end();
 #endif
 
+    return payload;
+}
+
+char * BlinkerMQTT::arenaCopy(char * & at, const String & data)
+{
+    char * str = at;
+
+    strcpy(str, data.c_str());
+    at += data.length() + 1;
+
+    return str;
+}
+
+int BlinkerMQTT::connectServer() {
+    String payload;
+
+    // a reregister always asks the server again
+    _isRegCached = !isMQTTinit && _regCache.load(regId().c_str(), payload);
+
+    if (!_isRegCached) payload = registerGet();
+
     // payload = "";
 
     BLINKER_LOG_ALL(BLINKER_F("reply was:"));
@@ -1576,7 +1569,7 @@ int BlinkerMQTT::connectServer() {
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1587,10 +1580,14 @@ int BlinkerMQTT::connectServer() {
             BLINKER_ERR_LOG(BLINKER_F("Or maybe your network is disconnected!"));
             // ::delay(60000);
 
+            if (_isRegCached) _regCache.erase();
+
             return false;
         // }
     }
 
+    if (!_isRegCached) _regCache.save(regId().c_str(), payload);
+
     // String _userID = STRING_find_string(payload, "deviceName", "\"", 4);
     // String _userName = STRING_find_string(payload, "iotId", "\"", 4);
     // String _key = STRING_find_string(payload, "iotToken", "\"", 4);
@@ -1606,74 +1603,85 @@ int BlinkerMQTT::connectServer() {
 
     if (isMQTTinit)
     {
-        free(MQTT_HOST_MQTT);
-        free(MQTT_ID_MQTT);
-        free(MQTT_NAME_MQTT);
-        free(MQTT_KEY_MQTT);
-        free(MQTT_PRODUCTINFO_MQTT);
-        free(UUID_MQTT);
-        free(DEVICE_NAME_MQTT);
-        free(BLINKER_PUB_TOPIC_MQTT);
-        free(BLINKER_SUB_TOPIC_MQTT);
-        free(mqtt_MQTT);
-        free(iotSub_MQTT);
+        BLINKER_FREE(MQTT_ARENA_MQTT);
+        delete mqtt_MQTT;
+        delete iotSub_MQTT;
 
         isMQTTinit = false;
     }
 
+    String _mqttID;
+    String _mqttName;
+    String _mqttHost;
+    String PUB_TOPIC_STR;
+    String SUB_TOPIC_STR;
+
     if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
-        // memcpy(DEVICE_NAME_MQTT, _userID.c_str(), 12);
-        DEVICE_NAME_MQTT = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(DEVICE_NAME_MQTT, _userID.c_str());
-        MQTT_ID_MQTT = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_MQTT, _userID.c_str());
-        MQTT_NAME_MQTT = (char*)malloc((_userName.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_MQTT, _userName.c_str());
-        MQTT_KEY_MQTT = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_MQTT, _key.c_str());
-        MQTT_PRODUCTINFO_MQTT = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_MQTT, _productInfo.c_str());
-        MQTT_HOST_MQTT = (char*)malloc((strlen(BLINKER_MQTT_ALIYUN_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_MQTT, BLINKER_MQTT_ALIYUN_HOST);
+        _mqttID = _userID;
+        _mqttName = _userName;
+        _mqttHost = BLINKER_MQTT_ALIYUN_HOST;
         MQTT_PORT_MQTT = BLINKER_MQTT_ALIYUN_PORT;
+
+        PUB_TOPIC_STR = BLINKER_F("/");
+        PUB_TOPIC_STR += _productInfo;
+        PUB_TOPIC_STR += BLINKER_F("/");
+        PUB_TOPIC_STR += _mqttID;
+        PUB_TOPIC_STR += BLINKER_F("/s");
+
+        SUB_TOPIC_STR = BLINKER_F("/");
+        SUB_TOPIC_STR += _productInfo;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += _mqttID;
+        SUB_TOPIC_STR += BLINKER_F("/r");
     }
     else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
-        // String id2name = _userID.subString(10, _userID.length());
-        // memcpy(DEVICE_NAME_MQTT, _userID.c_str(), 12);
-        DEVICE_NAME_MQTT = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(DEVICE_NAME_MQTT, _userID.c_str());
-        String IDtest = _productInfo + _userID;
-        MQTT_ID_MQTT = (char*)malloc((IDtest.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_MQTT, IDtest.c_str());
-        String NAMEtest = IDtest + ";" + _userName;
-        MQTT_NAME_MQTT = (char*)malloc((NAMEtest.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_MQTT, NAMEtest.c_str());
-        MQTT_KEY_MQTT = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_MQTT, _key.c_str());
-        MQTT_PRODUCTINFO_MQTT = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_MQTT, _productInfo.c_str());
-        MQTT_HOST_MQTT = (char*)malloc((strlen(BLINKER_MQTT_QCLOUD_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_MQTT, BLINKER_MQTT_QCLOUD_HOST);
+        _mqttID = _productInfo + _userID;
+        _mqttName = _mqttID + ";" + _userName;
+        _mqttHost = BLINKER_MQTT_QCLOUD_HOST;
         MQTT_PORT_MQTT = BLINKER_MQTT_QCLOUD_PORT;
+
+        PUB_TOPIC_STR = _productInfo;
+        PUB_TOPIC_STR += BLINKER_F("/");
+        PUB_TOPIC_STR += _userID;
+        PUB_TOPIC_STR += BLINKER_F("/s");
+
+        SUB_TOPIC_STR = _productInfo;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += _userID;
+        SUB_TOPIC_STR += BLINKER_F("/r");
     }
     else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
-        // memcpy(DEVICE_NAME_MQTT, _userID.c_str(), 12);
-        DEVICE_NAME_MQTT = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(DEVICE_NAME_MQTT, _userID.c_str());
-        MQTT_ID_MQTT = (char*)malloc((_userName.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_MQTT, _userName.c_str());
-        MQTT_NAME_MQTT = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_MQTT, _productInfo.c_str());
-        MQTT_KEY_MQTT = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_MQTT, _key.c_str());
-        MQTT_PRODUCTINFO_MQTT = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_MQTT, _productInfo.c_str());
-        MQTT_HOST_MQTT = (char*)malloc((strlen(BLINKER_MQTT_ONENET_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_MQTT, BLINKER_MQTT_ONENET_HOST);
+        _mqttID = _userName;
+        _mqttName = _productInfo;
+        _mqttHost = BLINKER_MQTT_ONENET_HOST;
         MQTT_PORT_MQTT = BLINKER_MQTT_ONENET_PORT;
+
+        PUB_TOPIC_STR = _productInfo;
+        PUB_TOPIC_STR += BLINKER_F("/onenet_rule/r");
+
+        SUB_TOPIC_STR = _productInfo;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += _userID;
+        SUB_TOPIC_STR += BLINKER_F("/r");
     }
-    UUID_MQTT = (char*)malloc((_uuid.length()+1)*sizeof(char));
-    strcpy(UUID_MQTT, _uuid.c_str());
+
+    // all of them share one block, a reregister frees just that
+    MQTT_ARENA_MQTT = (char*)BLINKER_MALLOC(HEAP_CRED, (_userID.length() + _mqttID.length() + \
+                        _mqttName.length() + _key.length() + _productInfo.length() + \
+                        _mqttHost.length() + _uuid.length() + PUB_TOPIC_STR.length() + \
+                        SUB_TOPIC_STR.length() + 9)*sizeof(char));
+
+    char * _arena = MQTT_ARENA_MQTT;
+
+    DEVICE_NAME_MQTT = arenaCopy(_arena, _userID);
+    MQTT_ID_MQTT = arenaCopy(_arena, _mqttID);
+    MQTT_NAME_MQTT = arenaCopy(_arena, _mqttName);
+    MQTT_KEY_MQTT = arenaCopy(_arena, _key);
+    MQTT_PRODUCTINFO_MQTT = arenaCopy(_arena, _productInfo);
+    MQTT_HOST_MQTT = arenaCopy(_arena, _mqttHost);
+    UUID_MQTT = arenaCopy(_arena, _uuid);
+    BLINKER_PUB_TOPIC_MQTT = arenaCopy(_arena, PUB_TOPIC_STR);
+    BLINKER_SUB_TOPIC_MQTT = arenaCopy(_arena, SUB_TOPIC_STR);
 
     // char uuid_eeprom[BLINKER_AUUID_SIZE];
 
@@ -1714,76 +1722,8 @@ int BlinkerMQTT::connectServer() {
     BLINKER_LOG_ALL(BLINKER_F("UUID_MQTT: "), UUID_MQTT);
     BLINKER_LOG_ALL(BLINKER_F("===================="));
 
-    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
-        String PUB_TOPIC_STR = BLINKER_F("/");
-        PUB_TOPIC_STR += MQTT_PRODUCTINFO_MQTT;
-        PUB_TOPIC_STR += BLINKER_F("/");
-        PUB_TOPIC_STR += MQTT_ID_MQTT;
-        PUB_TOPIC_STR += BLINKER_F("/s");
-
-        BLINKER_PUB_TOPIC_MQTT = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_MQTT: "), BLINKER_PUB_TOPIC_MQTT);
-
-        String SUB_TOPIC_STR = BLINKER_F("/");
-        SUB_TOPIC_STR += MQTT_PRODUCTINFO_MQTT;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += MQTT_ID_MQTT;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-
-        BLINKER_SUB_TOPIC_MQTT = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_MQTT: "), BLINKER_SUB_TOPIC_MQTT);
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
-        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_MQTT;
-        PUB_TOPIC_STR += BLINKER_F("/");
-        PUB_TOPIC_STR += _userID;
-        PUB_TOPIC_STR += BLINKER_F("/s");
-
-        BLINKER_PUB_TOPIC_MQTT = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_MQTT: "), BLINKER_PUB_TOPIC_MQTT);
-
-        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_MQTT;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += _userID;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-
-        BLINKER_SUB_TOPIC_MQTT = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_MQTT: "), BLINKER_SUB_TOPIC_MQTT);
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
-        // uint8_t str_len;
-        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_MQTT;
-        PUB_TOPIC_STR += BLINKER_F("/onenet_rule/r");
-        // str_len = PUB_TOPIC_STR.length() + 1;
-        BLINKER_PUB_TOPIC_MQTT = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_MQTT, PUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_MQTT: "), BLINKER_PUB_TOPIC_MQTT);
-
-        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_MQTT;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += _userID;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-
-        BLINKER_SUB_TOPIC_MQTT = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_MQTT, SUB_TOPIC_STR.c_str());
-
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_MQTT: "), BLINKER_SUB_TOPIC_MQTT);
-    }
+    BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_MQTT: "), BLINKER_PUB_TOPIC_MQTT);
+    BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_MQTT: "), BLINKER_SUB_TOPIC_MQTT);
 
     // BLINKER_LOG_FreeHeap();
 
@@ -1827,6 +1767,7 @@ int BlinkerMQTT::connectServer() {
     this->latestTime = millis() - BLINKER_MQTT_CONNECT_TIMESLOT;
     // if (!isMQTTinit)
     mqtt_MQTT->subscribe(iotSub_MQTT);
+    _link.attach(mqtt_MQTT);
 
     #if defined(ESP8266)
         // client_s->stop();
@@ -1993,7 +1934,7 @@ int BlinkerMQTT::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
@@ -2026,11 +1967,14 @@ bool BlinkerMQTT::checkInit()
 
                     // BLINKER_LOG(BLINKER_F("checkInit..."));
 
+                    _wlanCache.poll();
+
                     return false;
                 }
                 BLINKER_LOG(BLINKER_F("WiFi Connected."));
                 BLINKER_LOG(BLINKER_F("IP Address: "));
                 BLINKER_LOG(WiFi.localIP());
+                _wlanCache.save();
                 _isWiFiInit = true;
                 _connectTime = 0;
 
@@ -2071,6 +2015,7 @@ bool BlinkerMQTT::checkInit()
                             BLINKER_LOG(BLINKER_F("WiFi Connected."));
                             BLINKER_LOG(BLINKER_F("IP Address: "));
                             BLINKER_LOG(WiFi.localIP());
+                            _wlanCache.save();
                             _isWiFiInit = true;
                             _connectTime = 0;
 
@@ -2109,6 +2054,7 @@ bool BlinkerMQTT::checkInit()
                             BLINKER_LOG(BLINKER_F("WiFi Connected."));
                             BLINKER_LOG(BLINKER_F("IP Address: "));
                             BLINKER_LOG(WiFi.localIP());
+                            _wlanCache.save();
                             _isWiFiInit = true;
                             _connectTime = 0;
 
@@ -2438,7 +2384,7 @@ void BlinkerMQTT::checkAPCFG()
 bool BlinkerMQTT::parseUrl(String data)
 {
     BLINKER_LOG(BLINKER_F("APCONFIG data: "), data);
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& wifi_data = jsonBuffer.parseObject(data);
 
     if (!wifi_data.success()) {
@@ -2481,12 +2427,7 @@ void BlinkerMQTT::connectWiFi(const char* _ssid, const char* _pswd)
         WiFi.setHostname(_hostname.c_str());
     #endif
 
-    if (_pswd && strlen(_pswd)) {
-        WiFi.begin(_ssid, _pswd);
-    }
-    else {
-        WiFi.begin(_ssid);
-    }
+    _wlanCache.begin(_ssid, _pswd);
 
     // while (WiFi.status() != WL_CONNECTED) {
     //     ::delay(50);
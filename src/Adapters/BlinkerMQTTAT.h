@@ -22,11 +22,13 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerMQTTAT.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
 #include "Blinker/BlinkerUtility.h"
 #include "Blinker/BlinkerMQTTATBase.h"
 
@@ -37,9 +39,8 @@ class BlinkerMQTTAT : public BlinkerStream
 
         int serialAvailable();
         void serialBegin(Stream& s, bool state);
-        int serialTimedRead();
         char * serialLastRead();
-        // void serialFlush();
+        void serialFlush();
         int serialPrint(const String & s1, const String & s2, bool needCheck = true);
         int serialPrint(const String & s, bool needCheck = true);
         int serialConnect();
@@ -117,8 +118,7 @@ class BlinkerMQTTAT : public BlinkerStream
     protected :
         bool        _isBegin = false;
 
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
         int _aliType = ALI_NONE;
         int _duerType = DUER_NONE;
@@ -164,6 +164,12 @@ class BlinkerMQTTAT : public BlinkerStream
         Stream*     stream;
         char*       streamData;//[BLINKER_MAX_READ_SIZE];
         bool        isSeriaFresh;
+        char*       rxBuf;
+        uint16_t    rxHead = 0;
+        uint16_t    rxTail = 0;
+        uint16_t    lineLen = 0;
+        bool        lineDrop = false;
+        String      txBuf;
         bool        isSerialConnect;
         bool        isHWS = false;
 
@@ -275,6 +281,10 @@ void webSocketEvent_MQTT_AT(uint8_t num, WStype_t type, \
             // webSocket_MQTT_AT.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -295,58 +305,53 @@ BlinkerMQTTAT::BlinkerMQTTAT()
 
 int BlinkerMQTTAT::serialAvailable()
 {
-    if (stream->available())
+    // drain uart into the ring first, a long command on our side
+    // must not overrun the hardware fifo while the host pipelines
+    while (stream->available())
     {
-        // strcpy(streamData, (stream->readStringUntil('\n')).c_str());
+        uint16_t _next = (rxHead + 1) % BLINKER_AT_RX_BUFFER_SIZE;
 
-        // BLINKER_LOG_ALL(BLINKER_F("handleSerial: "), streamData);
+        if (_next == rxTail) break;
 
-        // return true;
+        rxBuf[rxHead] = stream->read();
+        rxHead = _next;
+    }
 
-        if (isSeriaFresh) free(streamData);
-        streamData = (char*)malloc(1*sizeof(char));
-        
-        int16_t dNum = 0;
-        int c_d = serialTimedRead();
-        while (dNum < BLINKER_MAX_READ_SIZE && 
-            c_d >=0 && c_d != '\n')
-        {
-            if (c_d != '\r')
-            {
-                streamData[dNum] = (char)c_d;
-                dNum++;
-                streamData = (char*)realloc(streamData, (dNum+1)*sizeof(char));
-            }
+    while (rxTail != rxHead)
+    {
+        char c_d = rxBuf[rxTail];
+        rxTail = (rxTail + 1) % BLINKER_AT_RX_BUFFER_SIZE;
 
-            c_d = serialTimedRead();
-        }
-        dNum++;
-        streamData = (char*)realloc(streamData, dNum*sizeof(char));
+        if (c_d == '\r') continue;
 
-        streamData[dNum-1] = '\0';
-        stream->flush();
-        
-        BLINKER_LOG_ALL(BLINKER_F("handleSerial: "), streamData);
-        BLINKER_LOG_FreeHeap_ALL();
-        
-        if (strlen(streamData) < BLINKER_MAX_READ_SIZE)
+        if (c_d != '\n')
         {
-            if (streamData[strlen(streamData) - 1] == '\r')
-                streamData[strlen(streamData) - 1] = '\0';
+            if (lineLen < BLINKER_MAX_READ_SIZE - 1) streamData[lineLen++] = c_d;
+            else lineDrop = true;
 
-            isSeriaFresh = true;
-            return true;
+            continue;
         }
-        else
+
+        streamData[lineLen] = '\0';
+
+        if (lineDrop || lineLen == 0)
         {
-            free(streamData);
-            return false;
+            if (lineDrop) BLINKER_ERR_LOG(BLINKER_F("serial line too long"));
+
+            lineLen = 0;
+            lineDrop = false;
+            continue;
         }
+
+        lineLen = 0;
+
+        BLINKER_LOG_ALL(BLINKER_F("handleSerial: "), streamData);
+
+        isSeriaFresh = true;
+        return true;
     }
-    else
-    {
-        return false;
-    }
+
+    return false;
 }
 
 void BlinkerMQTTAT::serialBegin(Stream& s, bool state)
@@ -355,21 +360,16 @@ void BlinkerMQTTAT::serialBegin(Stream& s, bool state)
     stream->setTimeout(BLINKER_STREAM_TIMEOUT);
     isHWS = state;
 
+    streamData = (char*)malloc(BLINKER_MAX_READ_SIZE*sizeof(char));
+    streamData[0] = '\0';
+    rxBuf = (char*)malloc(BLINKER_AT_RX_BUFFER_SIZE*sizeof(char));
+    txBuf.reserve(BLINKER_AT_TX_BUFFER_SIZE);
+
     serialConnect();
 
     serialPrint("");
     serialPrint(BLINKER_CMD_BLINKER_MQTT);
-}
-
-int BlinkerMQTTAT::serialTimedRead()
-{
-    int c;
-    uint32_t _startMillis = millis();
-    do {
-        c = stream->read();
-        if (c >= 0) return c;
-    } while(millis() - _startMillis < 1000);
-    return -1; 
+    serialFlush();
 }
 
 char * BlinkerMQTTAT::serialLastRead()
@@ -377,13 +377,14 @@ char * BlinkerMQTTAT::serialLastRead()
     return streamData;
 }
 
-// void BlinkerMQTTAT::serialFlush()
-// {
-//     if (isSeriaFresh)
-//     {
-//         free(streamData); isSeriaFresh = false;
-//     }
-// }
+void BlinkerMQTTAT::serialFlush()
+{
+    if (txBuf.length() == 0) return;
+
+    if (serialConnected()) stream->print(txBuf);
+
+    txBuf = "";
+}
 
 int BlinkerMQTTAT::serialPrint(const String & s1, const String & s2, bool needCheck)
 {
@@ -397,8 +398,12 @@ int BlinkerMQTTAT::serialPrint(const String & s, bool needCheck)
     if(serialConnected())
     {
         BLINKER_LOG_ALL(BLINKER_F("Succese..."));
-        
-        stream->println(s);
+
+        // queued, sent by serialFlush once the command batch is done
+        txBuf += s;
+        txBuf += BLINKER_F("\r\n");
+
+        if (txBuf.length() >= BLINKER_AT_TX_BUFFER_SIZE) serialFlush();
         return true;
     }
     else
@@ -641,13 +646,13 @@ void BlinkerMQTTAT::subscribe()
     if (!isMQTTinit) return;
 
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_MQTT_AT->readSubscription(10)))
+    while ((subscription = mqtt_MQTT_AT->readSubscription(0)))
     {
         if (subscription == iotSub_MQTT_AT)
         {
             BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_MQTT_AT->lastread);
             
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_MQTT_AT->lastread));
 
             String _uuid = root["fromDevice"];
@@ -735,49 +740,46 @@ void BlinkerMQTTAT::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
-                    {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
-
-                            kaTime = millis();
+                    int8_t num = _sharers.find(_uuid.c_str());
 
-                            isAvail_MQTT_AT = true;
-                            isAlive = true;
-
-                            dataGet = dataGet.substring(0, dataGet.length() - 1) + \
-                                        ",\"deviceType\":\"OwnApp\"}";
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
+                    {
+                        _sharerFrom = num;
 
-                            if (!isFresh_MQTT_AT && dataGet.length() < BLINKER_MAX_READ_SIZE)
-                            {
-                                msgBuf_MQTT_AT = (char*)malloc(BLINKER_MAX_READ_SIZE*sizeof(char));
-                                strcpy(msgBuf_MQTT_AT, dataGet.c_str());
-                                isFresh_MQTT_AT = true;
-                            }
-                            else if (dataGet.length() < BLINKER_MAX_READ_SIZE)
-                            {
-                                strcpy(msgBuf_MQTT_AT, dataGet.c_str());
-                                isFresh_MQTT_AT = true;
-                            }
+                        kaTime = millis();
 
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        isAvail_MQTT_AT = true;
+                        isAlive = true;
 
-                            _needCheckShare = false;
+                        dataGet = dataGet.substring(0, dataGet.length() - 1) + \
+                                    ",\"deviceType\":\"OwnApp\"}";
 
-                            break;
+                        if (!isFresh_MQTT_AT && dataGet.length() < BLINKER_MAX_READ_SIZE)
+                        {
+                            msgBuf_MQTT_AT = (char*)malloc(BLINKER_MAX_READ_SIZE*sizeof(char));
+                            strcpy(msgBuf_MQTT_AT, dataGet.c_str());
+                            isFresh_MQTT_AT = true;
                         }
-                        else
+                        else if (dataGet.length() < BLINKER_MAX_READ_SIZE)
                         {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                                        check is from bridge/share device, \
-                                        data: "), dataGet);
+                            strcpy(msgBuf_MQTT_AT, dataGet.c_str());
+                            isFresh_MQTT_AT = true;
+                        }
 
-                            _needCheckShare = true;
-                        } 
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
+                                    check is from bridge/share device, \
+                                    data: "), dataGet);
+
+                        _needCheckShare = true;
                     }
                 }
                 // else
@@ -908,7 +910,7 @@ int BlinkerMQTTAT::print(char * data, bool needCheck)
         strcat(data, data_add.c_str());
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
+            strcat(data, _sharers.uuid(_sharerFrom));
         }
         else
         {
@@ -1001,7 +1003,7 @@ int BlinkerMQTTAT::print(char * data, bool needCheck)
 int BlinkerMQTTAT::mqttPrint(const String & data) {
     BLINKER_LOG_ALL(("mqttPrint data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& print_data = jsonBuffer.parseObject(data);
 
     if (!print_data.success()) {
@@ -1513,40 +1515,26 @@ void BlinkerMQTTAT::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (_sharerCount; _sharerCount > 0; _sharerCount--)
-        {
-            delete _sharers[_sharerCount - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 void BlinkerMQTTAT::softAPinit()
@@ -1630,7 +1618,7 @@ void BlinkerMQTTAT::softAPinit()
 int BlinkerMQTTAT::parseUrl(String data)
 {
     BLINKER_LOG(BLINKER_F("APCONFIG data: "), data);
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& wifi_data = jsonBuffer.parseObject(data);
 
     if (!wifi_data.success()) {
@@ -2083,7 +2071,7 @@ int BlinkerMQTTAT::connectServer() {
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -2122,8 +2110,8 @@ int BlinkerMQTTAT::connectServer() {
         free(DEVICE_NAME_MQTT_AT);
         free(BLINKER_PUB_TOPIC_MQTT_AT);
         free(BLINKER_SUB_TOPIC_MQTT_AT);
-        free(mqtt_MQTT_AT);
-        free(iotSub_MQTT_AT);
+        delete mqtt_MQTT_AT;
+        delete iotSub_MQTT_AT;
 
         isMQTTinit = false;
     }
@@ -2468,7 +2456,7 @@ int BlinkerMQTTAT::checkPrintLimit()
 
 int BlinkerMQTTAT::isJson(const String & data)
 {
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
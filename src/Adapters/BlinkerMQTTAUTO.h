@@ -19,12 +19,16 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerMQTTAUTO.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerRegCache.h"
 
 char*       MQTT_HOST_AUTO;
 char*       MQTT_ID_AUTO;
@@ -75,6 +79,7 @@ class BlinkerMQTTAUTO : public BlinkerStream
         int deviceRegister() { return connectServer(); }
         int authCheck();
         void freshAlive() { kaTime = millis(); isAlive = true; }
+        BlinkerSupervisor * link() { return &_link; }
         void sharers(const String & data);
         int  needFreshShare() {
             if (_needCheckShare)
@@ -94,6 +99,8 @@ class BlinkerMQTTAUTO : public BlinkerStream
         bool isMQTTinit = false;
 
         int connectServer();
+        String authGet(const String & host);
+        String regId() { return STRING_format(_deviceType) + _vipKey; }
         void mDNSInit();
         void checkKA();
         int checkAliKA();
@@ -106,8 +113,8 @@ class BlinkerMQTTAUTO : public BlinkerStream
         int pubHello();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
+        BlinkerSupervisor   _link;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
         char*       _deviceType;
         // const char* _authKey;
@@ -143,11 +150,11 @@ class BlinkerMQTTAUTO : public BlinkerStream
         bool        isNew = false;
         bool        isAuth = false;
         bool        isFirst = false;
+        BlinkerRegCache _regCache;
+        bool        _isRegCached = false;
 
         int isJson(const String & data);
 
-        uint8_t     reconnect_time = 0;
-
         bool        _isAuthKey = false;
 };
 
@@ -234,6 +241,10 @@ void webSocketEvent_AUTO(uint8_t num, WStype_t type, \
             // webSocket_MQTT.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -249,54 +260,30 @@ BlinkerMQTTAUTO::BlinkerMQTTAUTO() { isHandle = &isConnect_AUTO; }
 
 int BlinkerMQTTAUTO::connect()
 {
-    int8_t ret;
-
     webSocket_AUTO.loop();
 
     if (!isMQTTinit) {
         return *isHandle;
     }
 
-    if (mqtt_AUTO->connected())
-    {
-        return true;
-    }
+    if (_link.connected()) return true;
 
-    disconnect();
+    int8_t ret = _link.connect();
 
-    if ((millis() - latestTime) < BLINKER_MQTT_CONNECT_TIMESLOT && latestTime > 0)
+    if (ret == MQTT_CONNECT_WAIT)
     {
         yield();
         return false;
     }
 
-    BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
-
-    #if defined(ESP8266)
-        client_mqtt.setInsecure();
-        ::delay(10);
-    #endif
-
-    if ((ret = mqtt_AUTO->connect()) != 0)
+    if (ret != 0)
     {
         BLINKER_LOG(mqtt_AUTO->connectErrorString(ret));
-        BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
-                    BLINKER_MQTT_CONNECT_TIMESLOT/1000, \
-                    BLINKER_F(" seconds..."));
 
-        if (ret == 4) reRegister();
+        if (ret == 4 || _link.failNum() % 12 == 0) reRegister();
 
-        this->latestTime = millis();
-        reconnect_time += 1;
-        if (reconnect_time >= 12)
-        {
-            reRegister();
-            reconnect_time = 0;
-        }
         return false;
     }
-    
-    reconnect_time = 0;
 
     BLINKER_LOG(BLINKER_F("MQTT Connected!"));
     BLINKER_LOG_FreeHeap();
@@ -320,41 +307,27 @@ int BlinkerMQTTAUTO::connected()
         return *isHandle;
     }
 
-    return mqtt_AUTO->connected() || *isHandle;
+    return _link.connected() || *isHandle;
 }
 
 int BlinkerMQTTAUTO::mConnected()
 {
     if (!isMQTTinit) return false;
-    else return mqtt_AUTO->connected();
+    else return _link.connected();
 }
 
 void BlinkerMQTTAUTO::disconnect()
 {
-    if (isMQTTinit) mqtt_AUTO->disconnect();
+    if (isMQTTinit) _link.disconnect();
 
     if (*isHandle) webSocket_AUTO.disconnect();
 }
 
 void BlinkerMQTTAUTO::ping()
 {
-    BLINKER_LOG_ALL(BLINKER_F("MQTT Ping!"));
-
-    BLINKER_LOG_FreeHeap_ALL();
-
     if (!isMQTTinit) return;
 
-    if (!mqtt_AUTO->ping())
-    {
-        disconnect();
-        // delay(100);
-
-        // connect();
-    }
-    else
-    {
-        this->latestTime = millis();
-    }
+    _link.keepAlive(latestTime);
 }
 
 int BlinkerMQTTAUTO::available()
@@ -362,18 +335,16 @@ int BlinkerMQTTAUTO::available()
     webSocket_AUTO.loop();
 
     if (isMQTTinit) {
-        checkKA();
-
-        // if (!mqtt_PRO->connected() || \
-        //     (millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-        if ((millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
+        if (_isRegCached && _regCache.expired())
         {
-            ping();
-        }
-        else
-        {
-            subscribe();
+            _regCache.erase();
+            reRegister();
         }
+
+        checkKA();
+
+        ping();
+        subscribe();
     }
 
     if (isAvail_AUTO)
@@ -428,13 +399,13 @@ void BlinkerMQTTAUTO::subscribe()
     if (!isMQTTinit) return;
 
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_AUTO->readSubscription(10)))
+    while ((subscription = mqtt_AUTO->readSubscription(0)))
     {
         if (subscription == iotSub_AUTO)
         {
             BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_AUTO->lastread);
 
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_AUTO->lastread));
 
             String _uuid = root["fromDevice"];
@@ -480,31 +451,28 @@ void BlinkerMQTTAUTO::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
+                    int8_t num = _sharers.find(_uuid.c_str());
+
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
                     {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
-
-                            kaTime = millis();
-
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
-                            
-                            _needCheckShare = false;
-
-                            break;
-                        }
-                        else
-                        {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                                        check is from bridge/share device, \
-                                        data: "), dataGet);
-
-                            _needCheckShare = true;
-                        }
+                        _sharerFrom = num;
+
+                        kaTime = millis();
+
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
+                                    check is from bridge/share device, \
+                                    data: "), dataGet);
+
+                        _needCheckShare = true;
                     }
                 }
                 // else
@@ -617,40 +585,18 @@ int BlinkerMQTTAUTO::print(char * data, bool needCheck)
         //     // payload += BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
         // }
 
-        uint16_t num = strlen(data);
-
-        for(uint16_t c_num = num; c_num > 0; c_num--)
-        {
-            data[c_num+7] = data[c_num-1];
-        }
-
-        data[num+8] = '\0';
+        // the envelope is sent around data, data itself is not moved
+        const char * toDevice = UUID_AUTO;
 
-        char data_add[20] = "{\"data\":";
-        for(uint8_t c_num = 0; c_num < 8; c_num++)
-        {
-            data[c_num] = data_add[c_num];
-        }
-
-        // data_add = BLINKER_F(",\"fromDevice\":\"");
-        // strcat(data, data_add.c_str());
-        strcat(data, ",\"fromDevice\":\"");
-        strcat(data, MQTT_ID_AUTO);
-        // data_add = BLINKER_F("\",\"toDevice\":\"");
-        // strcat(data, data_add.c_str());
-        strcat(data, "\",\"toDevice\":\"");
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
+            toDevice = _sharers.uuid(_sharerFrom);
         }
-        else
-        {
-            strcat(data, UUID_AUTO);
-        }
-        // data_add = BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
-        // strcat(data, data_add.c_str());
 
-        strcat(data, "\",\"deviceType\":\"OwnApp\"}");
+        Adafruit_MQTT_Segment payload[] = {
+            "{\"data\":", data, ",\"fromDevice\":\"", MQTT_ID_AUTO,
+            "\",\"toDevice\":\"", toDevice, "\",\"deviceType\":\"OwnApp\"}"
+        };
 
         _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
 
@@ -684,7 +630,7 @@ int BlinkerMQTTAUTO::print(char * data, bool needCheck)
                 }
             }
 
-            if (! mqtt_AUTO->publish(BLINKER_PUB_TOPIC_AUTO, data))
+            if (! mqtt_AUTO->publish(BLINKER_PUB_TOPIC_AUTO, payload, sizeof(payload)/sizeof(payload[0])))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1148,40 +1094,26 @@ void BlinkerMQTTAUTO::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (uint8_t num = _sharerCount; num > 0; num--)
-        {
-            delete _sharers[num - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 int BlinkerMQTTAUTO::authCheck()
@@ -1218,6 +1150,22 @@ int BlinkerMQTTAUTO::connectServer()
     #elif defined(ESP32)
         String host = BLINKER_F("https://iotdev.clz.me");
     #endif
+    String payload;
+
+    // a cached registration is the authKey and the auth reply, one per line
+    _isRegCached = !_isAuthKey && _regCache.load(regId().c_str(), payload);
+
+    if (_isRegCached)
+    {
+        String _getAuthKey = payload.substring(0, payload.indexOf('\n'));
+        payload.remove(0, _getAuthKey.length() + 1);
+
+        AUTHKEY_AUTO = (char*)malloc((_getAuthKey.length()+1)*sizeof(char));
+        strcpy(AUTHKEY_AUTO, _getAuthKey.c_str());
+
+        _isAuthKey = true;
+    }
+
     if (!_isAuthKey)
     {
     #if defined(ESP8266)
@@ -1484,7 +1432,7 @@ int BlinkerMQTTAUTO::connectServer()
         BLINKER_LOG_ALL(payload);
         BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(payload);
 
         if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1512,111 +1460,14 @@ int BlinkerMQTTAUTO::connectServer()
     }
     // TBD
 
-#if defined(ESP8266)
-    // client_mqtt.stop();
-
-    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
-
-    // client_s->setFingerprint(fingerprint);
-    client_s->setInsecure();
-
-    String url_iot = BLINKER_F("/api/v1/user/device/auth?authKey=");
-    url_iot += AUTHKEY_AUTO;
-    // url_iot += _aliType;
-    // url_iot += _duerType;
-
-    url_iot = "https://" + host + url_iot;
-
-    HTTPClient http;
-
-    String payload = "";
-
-    BLINKER_LOG_ALL(BLINKER_F("[HTTP] begin: "), url_iot);
-
-    if (http.begin(*client_s, url_iot)) {  // HTTPS
-
-        // Serial.print("[HTTPS] GET...\n");
-        // start connection and send HTTP header
-        int httpCode = http.GET();
-
-        // httpCode will be negative on error
-        if (httpCode > 0) {
-            // HTTP header has been send and Server response header has been handled
-
-            BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
-
-            // file found at server
-            if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
-                payload = http.getString();
-                // Serial.println(payload);
-            }
-        } else {
-            BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
-            payload = http.getString();
-            BLINKER_LOG(payload);
-        }
-
-        http.end();
-    } else {
-        // Serial.printf("[HTTPS] Unable to connect\n");
-    }
-
-#elif defined(ESP32)
-    HTTPClient http;
-
-    String url_iot = host;
-    url_iot += BLINKER_F("/api/v1/user/device/auth?authKey=");
-    url_iot += AUTHKEY_AUTO;
-    // url_iot += _aliType;
-    // url_iot += _duerType;
-
-// #if defined(BLINKER_ALIGENIE_LIGHT)
-//     url_iot += BLINKER_F("&aliType=light");
-// #elif defined(BLINKER_ALIGENIE_OUTLET)
-//     url_iot += BLINKER_F("&aliType=outlet");
-// #elif defined(BLINKER_ALIGENIE_SWITCH)
-// #elif defined(BLINKER_ALIGENIE_SENSOR)
-//     url_iot += BLINKER_F("&aliType=sensor");
-// #endif
-
-    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
-
-// #if defined(ESP8266)
-//     http.begin(url_iot, fingerprint); //HTTP
-// #elif defined(ESP32)
-    // http.begin(url_iot, ca); TODO
-    http.begin(url_iot);
-// #endif
-    int httpCode = http.GET();
-
-    String payload = "";
-
-    if (httpCode > 0) {
-      // HTTP header has been send and Server response header has been handled
-
-        BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
-
-        // file found at server
-        if (httpCode == HTTP_CODE_OK) {
-            payload = http.getString();
-            // BLINKER_LOG(payload);
-        }
-    }
-    else {
-        BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
-        payload = http.getString();
-        BLINKER_LOG(payload);
-    }
-
-    http.end();
-#endif
+    if (!_isRegCached) payload = authGet(host);
 
     BLINKER_LOG_ALL(BLINKER_F("reply was:"));
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1628,10 +1479,17 @@ int BlinkerMQTTAUTO::connectServer()
             BLINKER_ERR_LOG(BLINKER_F("Or maybe your network is disconnected!"));
             // ::delay(60000);
 
+            if (_isRegCached) _regCache.erase();
+
             return false;
         // }
     }
 
+    if (!_isRegCached)
+    {
+        _regCache.save(regId().c_str(), STRING_format(AUTHKEY_AUTO) + "\n" + payload);
+    }
+
     // String _userID = STRING_find_string(payload, "deviceName", "\"", 4);
     // String _userName = STRING_find_string(payload, "iotId", "\"", 4);
     // String _key = STRING_find_string(payload, "iotToken", "\"", 4);
@@ -1657,8 +1515,8 @@ int BlinkerMQTTAUTO::connectServer()
         free(MQTT_DEVICEID_AUTO);
         free(BLINKER_PUB_TOPIC_AUTO);
         free(BLINKER_SUB_TOPIC_AUTO);
-        free(mqtt_AUTO);
-        free(iotSub_AUTO);
+        delete mqtt_AUTO;
+        delete iotSub_AUTO;
 
         isMQTTinit = false;
     }
@@ -1883,6 +1741,7 @@ int BlinkerMQTTAUTO::connectServer()
     this->latestTime = millis() - BLINKER_MQTT_CONNECT_TIMESLOT;
     // if (!isMQTTinit)
     mqtt_AUTO->subscribe(iotSub_AUTO);
+    _link.attach(mqtt_AUTO);
     isMQTTinit = true;
 
     #if defined(ESP8266)
@@ -1897,6 +1756,110 @@ int BlinkerMQTTAUTO::connectServer()
     return true;
 }
 
+String BlinkerMQTTAUTO::authGet(const String & host)
+{
+#if defined(ESP8266)
+    // client_mqtt.stop();
+
+    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
+
+    // client_s->setFingerprint(fingerprint);
+    client_s->setInsecure();
+
+    String url_iot = BLINKER_F("/api/v1/user/device/auth?authKey=");
+    url_iot += AUTHKEY_AUTO;
+    // url_iot += _aliType;
+    // url_iot += _duerType;
+
+    url_iot = "https://" + host + url_iot;
+
+    HTTPClient http;
+
+    String payload = "";
+
+    BLINKER_LOG_ALL(BLINKER_F("[HTTP] begin: "), url_iot);
+
+    if (http.begin(*client_s, url_iot)) {  // HTTPS
+
+        // Serial.print("[HTTPS] GET...\n");
+        // start connection and send HTTP header
+        int httpCode = http.GET();
+
+        // httpCode will be negative on error
+        if (httpCode > 0) {
+            // HTTP header has been send and Server response header has been handled
+
+            BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
+
+            // file found at server
+            if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
+                payload = http.getString();
+                // Serial.println(payload);
+            }
+        } else {
+            BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
+            payload = http.getString();
+            BLINKER_LOG(payload);
+        }
+
+        http.end();
+    } else {
+        // Serial.printf("[HTTPS] Unable to connect\n");
+    }
+
+#elif defined(ESP32)
+    HTTPClient http;
+
+    String url_iot = host;
+    url_iot += BLINKER_F("/api/v1/user/device/auth?authKey=");
+    url_iot += AUTHKEY_AUTO;
+    // url_iot += _aliType;
+    // url_iot += _duerType;
+
+// #if defined(BLINKER_ALIGENIE_LIGHT)
+//     url_iot += BLINKER_F("&aliType=light");
+// #elif defined(BLINKER_ALIGENIE_OUTLET)
+//     url_iot += BLINKER_F("&aliType=outlet");
+// #elif defined(BLINKER_ALIGENIE_SWITCH)
+// #elif defined(BLINKER_ALIGENIE_SENSOR)
+//     url_iot += BLINKER_F("&aliType=sensor");
+// #endif
+
+    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
+
+// #if defined(ESP8266)
+//     http.begin(url_iot, fingerprint); //HTTP
+// #elif defined(ESP32)
+    // http.begin(url_iot, ca); TODO
+    http.begin(url_iot);
+// #endif
+    int httpCode = http.GET();
+
+    String payload = "";
+
+    if (httpCode > 0) {
+      // HTTP header has been send and Server response header has been handled
+
+        BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
+
+        // file found at server
+        if (httpCode == HTTP_CODE_OK) {
+            payload = http.getString();
+            // BLINKER_LOG(payload);
+        }
+    }
+    else {
+        BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
+        payload = http.getString();
+        BLINKER_LOG(payload);
+    }
+
+    http.end();
+#endif
+
+    return payload;
+}
+
 void BlinkerMQTTAUTO::mDNSInit()
 {
 #if defined(ESP8266)
@@ -2042,7 +2005,7 @@ int BlinkerMQTTAUTO::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
@@ -19,12 +19,16 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerPRO.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerRegCache.h"
 
 char*       MQTT_HOST_PRO;
 char*       MQTT_ID_PRO;
@@ -73,6 +77,7 @@ class BlinkerPRO : public BlinkerStream
         int deviceRegister() { return connectServer(); }
         int authCheck();
         void freshAlive() { kaTime = millis(); isAlive = true; }
+        BlinkerSupervisor * link() { return &_link; }
         void sharers(const String & data);
         int  needFreshShare() {
             if (_needCheckShare)
@@ -92,6 +97,8 @@ class BlinkerPRO : public BlinkerStream
         bool isMQTTinit = false;
 
         int connectServer();
+        String registerGet();
+        String regId() { return STRING_format(_deviceType) + macDeviceName(); }
         void mDNSInit();
         void checkKA();
         int checkAliKA();
@@ -104,8 +111,8 @@ class BlinkerPRO : public BlinkerStream
         int pubHello();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
+        BlinkerSupervisor   _link;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
         const char* _deviceType;
         // char*       _authKey;
@@ -137,10 +144,10 @@ class BlinkerPRO : public BlinkerStream
         bool        isNew = false;
         bool        isAuth = false;
         bool        isFirst = false;
+        BlinkerRegCache _regCache;
+        bool        _isRegCached = false;
 
         int isJson(const String & data);
-
-        uint8_t     reconnect_time = 0;
 };
 
 // #if defined(ESP8266)
@@ -226,6 +233,10 @@ void webSocketEvent_PRO(uint8_t num, WStype_t type, \
             // webSocket_PRO.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -239,57 +250,31 @@ BlinkerPRO::BlinkerPRO() { isHandle = &isConnect_PRO; }
 
 int BlinkerPRO::connect()
 {
-    int8_t ret;
-
     webSocket_PRO.loop();
 
     if (!isMQTTinit) {
         return *isHandle;
     }
 
-    if (mqtt_PRO->connected())
-    {
-        return true;
-    }
+    if (_link.connected()) return true;
 
-    disconnect();
+    int8_t ret = _link.connect();
 
-    if ((millis() - latestTime) < BLINKER_MQTT_CONNECT_TIMESLOT && latestTime > 0)
+    if (ret == MQTT_CONNECT_WAIT)
     {
         yield();
         return false;
     }
 
-    BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
-
-    #if defined(ESP8266)
-        client_mqtt.setInsecure();
-        ::delay(10);
-    #endif
-
-    BLINKER_LOG_FreeHeap_ALL();
-
-    if ((ret = mqtt_PRO->connect()) != 0)
+    if (ret != 0)
     {
         BLINKER_LOG(mqtt_PRO->connectErrorString(ret));
-        BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
-                    BLINKER_MQTT_CONNECT_TIMESLOT/1000, \
-                    BLINKER_F(" seconds..."));
 
-        if (ret == 4) reRegister();
+        if (ret == 4 || _link.failNum() % 12 == 0) reRegister();
 
-        this->latestTime = millis();
-        reconnect_time += 1;
-        if (reconnect_time >= 12)
-        {
-            reRegister();
-            reconnect_time = 0;
-        }
         return false;
     }
-    
-    reconnect_time = 0;
-    
+
     BLINKER_LOG(BLINKER_F("MQTT Connected!"));
     BLINKER_LOG_FreeHeap();
 
@@ -312,41 +297,27 @@ int BlinkerPRO::connected()
         return *isHandle;
     }
 
-    return mqtt_PRO->connected() || *isHandle; 
+    return _link.connected() || *isHandle; 
 }
 
 int BlinkerPRO::mConnected()
 {
     if (!isMQTTinit) return false;
-    else return mqtt_PRO->connected();
+    else return _link.connected();
 }
 
 void BlinkerPRO::disconnect()
 {
-    if (isMQTTinit) mqtt_PRO->disconnect();
+    if (isMQTTinit) _link.disconnect();
 
     if (*isHandle) webSocket_PRO.disconnect();
 }
 
 void BlinkerPRO::ping()
 {
-    BLINKER_LOG_ALL(BLINKER_F("MQTT Ping!"));
-
-    BLINKER_LOG_FreeHeap_ALL();
-
     if (!isMQTTinit) return;
 
-    if (!mqtt_PRO->ping())
-    {
-        disconnect();
-        // delay(100);
-
-        // connect();
-    }
-    else
-    {
-        this->latestTime = millis();
-    }
+    _link.keepAlive(latestTime);
 }
 
 int BlinkerPRO::available()
@@ -354,18 +325,16 @@ int BlinkerPRO::available()
     webSocket_PRO.loop();
 
     if (isMQTTinit) {
-        checkKA();
-
-        // if (!mqtt_PRO->connected() || \
-        //     (millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-        if ((millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-        {
-            ping();
-        }
-        else
+        if (_isRegCached && _regCache.expired())
         {
-            subscribe();
+            _regCache.erase();
+            reRegister();
         }
+
+        checkKA();
+
+        ping();
+        subscribe();
     }
 
     if (isAvail_PRO)
@@ -420,13 +389,13 @@ void BlinkerPRO::subscribe()
     if (!isMQTTinit) return;
 
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_PRO->readSubscription(10)))
+    while ((subscription = mqtt_PRO->readSubscription(0)))
     {
         if (subscription == iotSub_PRO)
         {
             BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_PRO->lastread);
             
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_PRO->lastread));
 
             String _uuid = root["fromDevice"];
@@ -472,31 +441,28 @@ void BlinkerPRO::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
-                    {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
+                    int8_t num = _sharers.find(_uuid.c_str());
 
-                            kaTime = millis();
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
+                    {
+                        _sharerFrom = num;
 
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        kaTime = millis();
 
-                            _needCheckShare = false;
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
 
-                            break;
-                        }
-                        else
-                        {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid,"
-                                        "check is from bridge/share device," 
-                                        "data: "), dataGet);
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid,"
+                                    "check is from bridge/share device,"
+                                    "data: "), dataGet);
 
-                            _needCheckShare = true;
-                        }                        
+                        _needCheckShare = true;
                     }
                 }
                 
@@ -609,37 +575,18 @@ int BlinkerPRO::print(char * data, bool needCheck)
         //     // payload += BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
         // }
 
-        uint16_t num = strlen(data);
-
-        for(uint16_t c_num = num; c_num > 0; c_num--)
-        {
-            data[c_num+7] = data[c_num-1];
-        }
-
-        data[num+8] = '\0';
-
-        String data_add = BLINKER_F("{\"data\":");
-        
-        for(uint16_t c_num = 0; c_num < 8; c_num++)
-        {
-            data[c_num] = data_add[c_num];
-        }
+        // the envelope is sent around data, data itself is not moved
+        const char * toDevice = UUID_PRO;
 
-        data_add = BLINKER_F(",\"fromDevice\":\"");
-        strcat(data, data_add.c_str());
-        strcat(data, MQTT_DEVICEID_PRO);
-        data_add = BLINKER_F("\",\"toDevice\":\"");
-        strcat(data, data_add.c_str());
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
-        }
-        else
-        {
-            strcat(data, UUID_PRO);
+            toDevice = _sharers.uuid(_sharerFrom);
         }
-        data_add = BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
-        strcat(data, data_add.c_str());
+
+        Adafruit_MQTT_Segment payload[] = {
+            "{\"data\":", data, ",\"fromDevice\":\"", MQTT_DEVICEID_PRO,
+            "\",\"toDevice\":\"", toDevice, "\",\"deviceType\":\"OwnApp\"}"
+        };
 
         _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
 
@@ -673,7 +620,7 @@ int BlinkerPRO::print(char * data, bool needCheck)
                 }
             }
 
-            if (! mqtt_PRO->publish(BLINKER_PUB_TOPIC_PRO, data))
+            if (! mqtt_PRO->publish(BLINKER_PUB_TOPIC_PRO, payload, sizeof(payload)/sizeof(payload[0])))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1155,40 +1102,26 @@ void BlinkerPRO::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (_sharerCount; _sharerCount > 0; _sharerCount--)
-        {
-            delete _sharers[_sharerCount - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 int BlinkerPRO::authCheck()
@@ -1218,196 +1151,493 @@ int BlinkerPRO::authCheck()
 }
 
 int BlinkerPRO::connectServer() {
-    const int httpsPort = 443;
-#if defined(ESP8266)
-    String host = BLINKER_F("iotdev.clz.me");
-    String fingerprint = BLINKER_F("84 5f a4 8a 70 5e 79 7e f5 b3 b4 20 45 c8 35 55 72 f6 85 5a");
-
-    // WiFiClientSecure client_s;
+    String payload;
 
-//     BearSSL::WiFiClientSecure *client_s;
+    // a reregister always asks the server again
+    _isRegCached = !isMQTTinit && _regCache.load(regId().c_str(), payload);
 
-//     client_s = new BearSSL::WiFiClientSecure();
+    if (!_isRegCached) payload = registerGet();
 
-//     client_mqtt.stop();
-    
-//     BLINKER_LOG_ALL(BLINKER_F("connecting to "), host);
+    BLINKER_LOG_ALL(BLINKER_F("reply was:"));
+    BLINKER_LOG_ALL(BLINKER_F("=============================="));
+    BLINKER_LOG_ALL(payload);
+    BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-//     // BLINKER_LOG_FreeHeap();
-    
-//     uint8_t connet_times = 0;
-//     // client_s.stop();
-//     ::delay(100);
+    BlinkerJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(payload);
 
-//     bool mfln = client_s->probeMaxFragmentLength(host, httpsPort, 1024);
-//     if (mfln) {
-//         client_s->setBufferSizes(1024, 1024);
-//     }
-//     // client_s.setFingerprint(fingerprint.c_str());
-    
-//     client_s->setInsecure();
+    if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
+        !STRING_contains_string(payload, BLINKER_CMD_IOTID)) {
+        // while(1) {
+            BLINKER_ERR_LOG(("Please make sure you have register this device!"));
+            // ::delay(60000);
 
-//     // while (1) {
-//         bool cl_connected = false;
-//         if (!client_s->connect(host, httpsPort)) {
-//             BLINKER_ERR_LOG(BLINKER_F("server connection failed"));
-//             // connet_times++;
+            if (_isRegCached) _regCache.erase();
 
-//             ::delay(1000);
-//         }
-//         else {
-//             BLINKER_LOG_ALL(BLINKER_F("connection succeed"));
-//             cl_connected = true;
+            return false;
+        // }
+    }
 
-//             // break;
-//         }
+    if (!_isRegCached) _regCache.save(regId().c_str(), payload);
 
-//         // if (connet_times >= 4 && !cl_connected)  return BLINKER_CMD_FALSE;
-//     // }
+    // String _userID = STRING_find_string(payload, "deviceName", "\"", 4);
+    // String _userName = STRING_find_string(payload, "iotId", "\"", 4);
+    // String _key = STRING_find_string(payload, "iotToken", "\"", 4);
+    // String _productInfo = STRING_find_string(payload, "productKey", "\"", 4);
+    // String _broker = STRING_find_string(payload, "broker", "\"", 4);
+    // String _uuid = STRING_find_string(payload, "uuid", "\"", 4);
+    String _userID = root[BLINKER_CMD_DETAIL][BLINKER_CMD_DEVICENAME];
+    String _userName = root[BLINKER_CMD_DETAIL][BLINKER_CMD_IOTID];
+    String _key = root[BLINKER_CMD_DETAIL][BLINKER_CMD_IOTTOKEN];
+    String _productInfo = root[BLINKER_CMD_DETAIL][BLINKER_CMD_PRODUCTKEY];
+    String _broker = root[BLINKER_CMD_DETAIL][BLINKER_CMD_BROKER];
+    String _uuid = root[BLINKER_CMD_DETAIL][BLINKER_CMD_UUID];
+    String _authKey = root[BLINKER_CMD_DETAIL][BLINKER_CMD_KEY];
 
-//     String client_msg;
+    if (isMQTTinit)
+    {
+        free(MQTT_HOST_PRO);
+        free(MQTT_ID_PRO);
+        free(MQTT_NAME_PRO);
+        free(MQTT_KEY_PRO);
+        free(MQTT_PRODUCTINFO_PRO);
+        free(UUID_PRO);
+        free(AUTHKEY_PRO);
+        free(MQTT_DEVICEID_PRO);
+        free(BLINKER_PUB_TOPIC_PRO);
+        free(BLINKER_SUB_TOPIC_PRO);
+        delete mqtt_PRO;
+        delete iotSub_PRO;
 
-//     String url_iot = BLINKER_F("/api/v1/user/device/register?deviceType=");
-//     url_iot += _deviceType;
-//     url_iot += BLINKER_F("&deviceName=");
-//     url_iot += macDeviceName();
+        isMQTTinit = false;
+    }
 
-//     if (_deviceType == BLINKER_SMART_LAMP) {
-//         url_iot += BLINKER_F("&aliType=light");
-//         url_iot += BLINKER_F("&duerType=LIGHT");
-//     }
-//     else if (_deviceType == BLINKER_SMART_PLUGIN) {
-//         url_iot += BLINKER_F("&aliType=outlet");
-//         url_iot += BLINKER_F("&duerType=SOCKET");
-//     }
-//     else if (_deviceType == BLINKER_AIR_DETECTOR) {
-//         url_iot += BLINKER_F("&aliType=sensor");
-//         url_iot += BLINKER_F("&duerType=AIR_MONITOR");
-//     }
+    BLINKER_LOG_ALL(("===================="));
 
-// // #if defined(BLINKER_ALIGENIE_LIGHT)
-// //     url_iot += BLINKER_F("&aliType=light");
-// // #elif defined(BLINKER_ALIGENIE_OUTLET)
-// //     url_iot += BLINKER_F("&aliType=outlet");
-// // #elif defined(BLINKER_ALIGENIE_SWITCH)
-// // #elif defined(BLINKER_ALIGENIE_SENSOR)
-// //     url_iot += BLINKER_F("&aliType=sensor");
-// // #endif
+    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
+        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
+        // String _deviceName = _userID.substring(12, 36);
+        // MQTT_DEVICEID_PRO = (char*)malloc((_deviceName.length()+1)*sizeof(char));
+        // String _deviceName = _userID.substring(12, 36);
+        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
+        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
+        MQTT_ID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
+        strcpy(MQTT_ID_PRO, _userID.c_str());
+        MQTT_NAME_PRO = (char*)malloc((_userName.length()+1)*sizeof(char));
+        strcpy(MQTT_NAME_PRO, _userName.c_str());
+        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
+        strcpy(MQTT_KEY_PRO, _key.c_str());
+        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
+        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
+        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_ALIYUN_HOST)+1)*sizeof(char));
+        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_ALIYUN_HOST);
+        AUTHKEY_PRO = (char*)malloc((_authKey.length()+1)*sizeof(char));
+        strcpy(AUTHKEY_PRO, _authKey.c_str());
+        MQTT_PORT_PRO = BLINKER_MQTT_ALIYUN_PORT;
 
-//     BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), host, url_iot);
-    
-//     client_msg = BLINKER_F("GET ");
-//     client_msg += url_iot;
-//     client_msg += BLINKER_F(" HTTP/1.1\r\nHost: ");
-//     client_msg += host;
-//     client_msg += BLINKER_F(":");
-//     client_msg += STRING_format(httpsPort);
-//     client_msg += BLINKER_F("\r\nConnection: close\r\n\r\n");
+        BLINKER_LOG_ALL(("===================="));
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
+        // String id2name = _userID.subString(10, _userID.length());
+        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
+        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
+        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
+        String IDtest = _productInfo + _userID;
+        MQTT_ID_PRO = (char*)malloc((IDtest.length()+1)*sizeof(char));
+        strcpy(MQTT_ID_PRO, IDtest.c_str());
+        String NAMEtest = IDtest + ";" + _userName;
+        MQTT_NAME_PRO = (char*)malloc((NAMEtest.length()+1)*sizeof(char));
+        strcpy(MQTT_NAME_PRO, NAMEtest.c_str());
+        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
+        strcpy(MQTT_KEY_PRO, _key.c_str());
+        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
+        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
+        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_QCLOUD_HOST)+1)*sizeof(char));
+        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_QCLOUD_HOST);
+        MQTT_PORT_PRO = BLINKER_MQTT_QCLOUD_PORT;
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
+        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
+        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
+        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
+        MQTT_ID_PRO = (char*)malloc((_userName.length()+1)*sizeof(char));
+        strcpy(MQTT_ID_PRO, _userName.c_str());
+        MQTT_NAME_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
+        strcpy(MQTT_NAME_PRO, _productInfo.c_str());
+        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
+        strcpy(MQTT_KEY_PRO, _key.c_str());
+        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
+        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
+        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_ONENET_HOST)+1)*sizeof(char));
+        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_ONENET_HOST);
+        MQTT_PORT_PRO = BLINKER_MQTT_ONENET_PORT;
+    }
+    UUID_PRO = (char*)malloc((_uuid.length()+1)*sizeof(char));
+    strcpy(UUID_PRO, _uuid.c_str());
 
-//     client_s->print(client_msg);
-    
-//     BLINKER_LOG_ALL(BLINKER_F("client_msg: "), client_msg);
+    char uuid_eeprom[BLINKER_AUUID_SIZE];
 
-//     unsigned long timeout = millis();
-//     while (client_s->available() == 0) {
-//         if (millis() - timeout > 5000) {
-//             BLINKER_LOG_ALL(BLINKER_F(">>> Client Timeout !"));
-//             client_s->stop();
-//             return false;
-//         }
-//     }
+    BLINKER_LOG_ALL(("==========AUTH CHECK=========="));
 
-//     String _dataGet;
-//     String lastGet;
-//     String lengthOfJson;
-//     while (client_s->available()) {
-//         // String line = client_s.readStringUntil('\r');
-//         _dataGet = client_s->readStringUntil('\n');
+    if (!isFirst)
+    {
+        char _authCheck;
+        EEPROM.begin(BLINKER_EEP_SIZE);
+        EEPROM.get(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
+        if (strcmp(uuid_eeprom, _uuid.c_str()) != 0) {
+            // strcpy(UUID_PRO, _uuid.c_str());
 
-//         if (_dataGet.startsWith("Content-Length: ")){
-//             int addr_start = _dataGet.indexOf(' ');
-//             int addr_end = _dataGet.indexOf('\0', addr_start + 1);
-//             lengthOfJson = _dataGet.substring(addr_start + 1, addr_end);
-//         }
+            strcpy(uuid_eeprom, _uuid.c_str());
+            EEPROM.put(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
+            EEPROM.get(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
 
-//         if (_dataGet == "\r") {
-//             BLINKER_LOG_ALL(BLINKER_F("headers received"));
-            
-//             break;
-//         }
-//     }
+            BLINKER_LOG_ALL(BLINKER_F("===================="));
+            BLINKER_LOG_ALL(BLINKER_F("uuid_eeprom: "), uuid_eeprom);
+            BLINKER_LOG_ALL(BLINKER_F("_uuid: "), _uuid);
+            isNew = true;
+        }
+        EEPROM.get(BLINKER_EEP_ADDR_AUTH_CHECK, _authCheck);
+        if (_authCheck != BLINKER_AUTH_CHECK_DATA) {
+            EEPROM.put(BLINKER_EEP_ADDR_AUTH_CHECK, BLINKER_AUTH_CHECK_DATA);
+            isAuth = true;
+        }
+        EEPROM.commit();
+        EEPROM.end();
 
-//     for(int i=0;i<lengthOfJson.toInt();i++){
-//         lastGet += (char)client_s->read();
-//     }
+        isFirst = true;
+    }
+    
+    BLINKER_LOG_ALL(BLINKER_F("===================="));
+    BLINKER_LOG_ALL(BLINKER_F("DEVICE_NAME: "), macDeviceName());
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_PRODUCTINFO_PRO: "), MQTT_PRODUCTINFO_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_DEVICEID_PRO: "), MQTT_DEVICEID_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_ID_PRO: "), MQTT_ID_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_NAME_PRO: "), MQTT_NAME_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_KEY_PRO: "), MQTT_KEY_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("MQTT_BROKER: "), _broker);
+    BLINKER_LOG_ALL(BLINKER_F("HOST: "), MQTT_HOST_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("PORT: "), MQTT_PORT_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("UUID_PRO: "), UUID_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("AUTHKEY_PRO: "), AUTHKEY_PRO);
+    BLINKER_LOG_ALL(BLINKER_F("===================="));
 
-//     // BLINKER_LOG_FreeHeap();
+    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
+        String PUB_TOPIC_STR = BLINKER_F("/");
+        PUB_TOPIC_STR += MQTT_PRODUCTINFO_PRO;
+        PUB_TOPIC_STR += BLINKER_F("/");
+        PUB_TOPIC_STR += MQTT_DEVICEID_PRO;
+        PUB_TOPIC_STR += BLINKER_F("/s");
 
-//     client_s->stop();
-//     client_s->flush();
+        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
+        
+        String SUB_TOPIC_STR = BLINKER_F("/");
+        SUB_TOPIC_STR += MQTT_PRODUCTINFO_PRO;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += MQTT_DEVICEID_PRO;
+        SUB_TOPIC_STR += BLINKER_F("/r");
+        
+        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
+        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
+        PUB_TOPIC_STR += BLINKER_F("/");
+        PUB_TOPIC_STR += _userID;
+        PUB_TOPIC_STR += BLINKER_F("/s");
 
-//     free(client_s);
+        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
+        
+        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += _userID;
+        SUB_TOPIC_STR += BLINKER_F("/r");
+        
+        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
+        uint8_t str_len;
+        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
+        PUB_TOPIC_STR += BLINKER_F("/onenet_rule/r");
+        // str_len = PUB_TOPIC_STR.length() + 1;
+        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
+        
+        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
+        SUB_TOPIC_STR += BLINKER_F("/");
+        SUB_TOPIC_STR += _userID;
+        SUB_TOPIC_STR += BLINKER_F("/r");
+        
+        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
+        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
+        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
+        
+        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
+    }
 
-//     // BLINKER_LOG_FreeHeap();
+    // BLINKER_LOG_FreeHeap();
 
-//     _dataGet = lastGet;
-    
-//     BLINKER_LOG_ALL(BLINKER_F("_dataGet: "), _dataGet);
+    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
+        #if defined(ESP8266)
+            // bool mfln = client_mqtt.probeMaxFragmentLength(MQTT_HOST_PRO, MQTT_PORT_PRO, 4096);
+            // if (mfln) {
+            //     client_mqtt.setBufferSizes(1024, 1024);
+            // }
+            // client_mqtt.setInsecure();
+            mqtt_PRO = new Adafruit_MQTT_Client(&client_mqtt, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
+        #elif defined(ESP32)
+            mqtt_PRO = new Adafruit_MQTT_Client(&client_s, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
+        #endif
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
+        #if defined(ESP8266)
+            // bool mfln = client_mqtt.probeMaxFragmentLength(MQTT_HOST_PRO, MQTT_PORT_PRO, 4096);
+            // if (mfln) {
+            //     client_mqtt.setBufferSizes(1024, 1024);
+            // }
+            // client_mqtt.setInsecure();
+            mqtt_PRO = new Adafruit_MQTT_Client(&client_mqtt, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
+        #elif defined(ESP32)
+            mqtt_PRO = new Adafruit_MQTT_Client(&client_s, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
+        #endif
+    }
+    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
+        mqtt_PRO = new Adafruit_MQTT_Client(&client, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
+    }
 
-//     String payload = _dataGet;
+    // iotPub = new Adafruit_MQTT_Publish(mqtt_PRO, BLINKER_PUB_TOPIC_PRO);
+    // if (!isMQTTinit) 
+    iotSub_PRO = new Adafruit_MQTT_Subscribe(mqtt_PRO, BLINKER_SUB_TOPIC_PRO);
 
+    // mqtt_broker = (char*)malloc((_broker.length()+1)*sizeof(char));
+    // strcpy(mqtt_broker, _broker.c_str());
+    // mqtt_broker = _broker;
 
+    // mDNSInit(MQTT_ID_PRO);
+    this->latestTime = millis();
+    // if (!isMQTTinit) 
+    mqtt_PRO->subscribe(iotSub_PRO);
+    _link.attach(mqtt_PRO);
+    isMQTTinit = true;
+    
+    #if defined(ESP8266)
+        // client_s->stop();
+        client_mqtt.setInsecure();
+    #endif
+    // connect();
 
-    client_mqtt.stop();
+    return true;
+}
 
-    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
+String BlinkerPRO::registerGet()
+{
+    const int httpsPort = 443;
+#if defined(ESP8266)
+    String host = BLINKER_F("iotdev.clz.me");
+    String fingerprint = BLINKER_F("84 5f a4 8a 70 5e 79 7e f5 b3 b4 20 45 c8 35 55 72 f6 85 5a");
 
-    // client_s->setFingerprint(fingerprint);
-    client_s->setInsecure();
+    // WiFiClientSecure client_s;
 
-    String url_iot = BLINKER_F("/api/v1/user/device/register?deviceType=");
-    url_iot += _deviceType;
-    url_iot += BLINKER_F("&deviceName=");
-    if (_deviceType != BLINKER_AIR_STATION)
-    {
-        url_iot += macDeviceName();
-    }
-    else
-    {
-        // url_iot += "TESTA69BA016"; // 1
-        // url_iot += "TEST656A2782"; // 2
-        // url_iot += "TESTD1C4B294"; // 3
-        url_iot += "TEST687991DC"; // 4
-        // url_iot += "TEST872B3982"; // 5
-    }
+//     BearSSL::WiFiClientSecure *client_s;
+
+//     client_s = new BearSSL::WiFiClientSecure();
+
+//     client_mqtt.stop();
     
+//     BLINKER_LOG_ALL(BLINKER_F("connecting to "), host);
 
-    if (_deviceType == BLINKER_SMART_LAMP) {
-        url_iot += BLINKER_F("&aliType=light");
-        url_iot += BLINKER_F("&duerType=LIGHT");
-    }
-    else if (_deviceType == BLINKER_SMART_PLUGIN) {
-        url_iot += BLINKER_F("&aliType=outlet");
-        url_iot += BLINKER_F("&duerType=SOCKET");
-    }
-    else if (_deviceType == BLINKER_AIR_DETECTOR) {
-        url_iot += BLINKER_F("&aliType=sensor");
-        url_iot += BLINKER_F("&duerType=AIR_MONITOR");
-    }
+//     // BLINKER_LOG_FreeHeap();
+    
+//     uint8_t connet_times = 0;
+//     // client_s.stop();
+//     ::delay(100);
 
-    url_iot = "https://" + host + url_iot;
+//     bool mfln = client_s->probeMaxFragmentLength(host, httpsPort, 1024);
+//     if (mfln) {
+//         client_s->setBufferSizes(1024, 1024);
+//     }
+//     // client_s.setFingerprint(fingerprint.c_str());
+    
+//     client_s->setInsecure();
 
-    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
+//     // while (1) {
+//         bool cl_connected = false;
+//         if (!client_s->connect(host, httpsPort)) {
+//             BLINKER_ERR_LOG(BLINKER_F("server connection failed"));
+//             // connet_times++;
 
-    HTTPClient http;
+//             ::delay(1000);
+//         }
+//         else {
+//             BLINKER_LOG_ALL(BLINKER_F("connection succeed"));
+//             cl_connected = true;
 
-    String payload;
+//             // break;
+//         }
 
-    if (http.begin(*client_s, url_iot)) {  // HTTPS
+//         // if (connet_times >= 4 && !cl_connected)  return BLINKER_CMD_FALSE;
+//     // }
 
-        // Serial.print("[HTTPS] GET...\n");
-        // start connection and send HTTP header
-        int httpCode = http.GET();
+//     String client_msg;
+
+//     String url_iot = BLINKER_F("/api/v1/user/device/register?deviceType=");
+//     url_iot += _deviceType;
+//     url_iot += BLINKER_F("&deviceName=");
+//     url_iot += macDeviceName();
+
+//     if (_deviceType == BLINKER_SMART_LAMP) {
+//         url_iot += BLINKER_F("&aliType=light");
+//         url_iot += BLINKER_F("&duerType=LIGHT");
+//     }
+//     else if (_deviceType == BLINKER_SMART_PLUGIN) {
+//         url_iot += BLINKER_F("&aliType=outlet");
+//         url_iot += BLINKER_F("&duerType=SOCKET");
+//     }
+//     else if (_deviceType == BLINKER_AIR_DETECTOR) {
+//         url_iot += BLINKER_F("&aliType=sensor");
+//         url_iot += BLINKER_F("&duerType=AIR_MONITOR");
+//     }
+
+// // #if defined(BLINKER_ALIGENIE_LIGHT)
+// //     url_iot += BLINKER_F("&aliType=light");
+// // #elif defined(BLINKER_ALIGENIE_OUTLET)
+// //     url_iot += BLINKER_F("&aliType=outlet");
+// // #elif defined(BLINKER_ALIGENIE_SWITCH)
+// // #elif defined(BLINKER_ALIGENIE_SENSOR)
+// //     url_iot += BLINKER_F("&aliType=sensor");
+// // #endif
+
+//     BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), host, url_iot);
+    
+//     client_msg = BLINKER_F("GET ");
+//     client_msg += url_iot;
+//     client_msg += BLINKER_F(" HTTP/1.1\r\nHost: ");
+//     client_msg += host;
+//     client_msg += BLINKER_F(":");
+//     client_msg += STRING_format(httpsPort);
+//     client_msg += BLINKER_F("\r\nConnection: close\r\n\r\n");
+
+//     client_s->print(client_msg);
+    
+//     BLINKER_LOG_ALL(BLINKER_F("client_msg: "), client_msg);
+
+//     unsigned long timeout = millis();
+//     while (client_s->available() == 0) {
+//         if (millis() - timeout > 5000) {
+//             BLINKER_LOG_ALL(BLINKER_F(">>> Client Timeout !"));
+//             client_s->stop();
+//             return false;
+//         }
+//     }
+
+//     String _dataGet;
+//     String lastGet;
+//     String lengthOfJson;
+//     while (client_s->available()) {
+//         // String line = client_s.readStringUntil('\r');
+//         _dataGet = client_s->readStringUntil('\n');
+
+//         if (_dataGet.startsWith("Content-Length: ")){
+//             int addr_start = _dataGet.indexOf(' ');
+//             int addr_end = _dataGet.indexOf('\0', addr_start + 1);
+//             lengthOfJson = _dataGet.substring(addr_start + 1, addr_end);
+//         }
+
+//         if (_dataGet == "\r") {
+//             BLINKER_LOG_ALL(BLINKER_F("headers received"));
+            
+//             break;
+//         }
+//     }
+
+//     for(int i=0;i<lengthOfJson.toInt();i++){
+//         lastGet += (char)client_s->read();
+//     }
+
+//     // BLINKER_LOG_FreeHeap();
+
+//     client_s->stop();
+//     client_s->flush();
+
+//     free(client_s);
+
+//     // BLINKER_LOG_FreeHeap();
+
+//     _dataGet = lastGet;
+    
+//     BLINKER_LOG_ALL(BLINKER_F("_dataGet: "), _dataGet);
+
+//     String payload = _dataGet;
+
+
+
+    client_mqtt.stop();
+
+    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
+
+    // client_s->setFingerprint(fingerprint);
+    client_s->setInsecure();
+
+    String url_iot = BLINKER_F("/api/v1/user/device/register?deviceType=");
+    url_iot += _deviceType;
+    url_iot += BLINKER_F("&deviceName=");
+    if (_deviceType != BLINKER_AIR_STATION)
+    {
+        url_iot += macDeviceName();
+    }
+    else
+    {
+        // url_iot += "TESTA69BA016"; // 1
+        // url_iot += "TEST656A2782"; // 2
+        // url_iot += "TESTD1C4B294"; // 3
+        url_iot += "TEST687991DC"; // 4
+        // url_iot += "TEST872B3982"; // 5
+    }
+    
+
+    if (_deviceType == BLINKER_SMART_LAMP) {
+        url_iot += BLINKER_F("&aliType=light");
+        url_iot += BLINKER_F("&duerType=LIGHT");
+    }
+    else if (_deviceType == BLINKER_SMART_PLUGIN) {
+        url_iot += BLINKER_F("&aliType=outlet");
+        url_iot += BLINKER_F("&duerType=SOCKET");
+    }
+    else if (_deviceType == BLINKER_AIR_DETECTOR) {
+        url_iot += BLINKER_F("&aliType=sensor");
+        url_iot += BLINKER_F("&duerType=AIR_MONITOR");
+    }
+
+    url_iot = "https://" + host + url_iot;
+
+    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
+
+    HTTPClient http;
+
+    String payload;
+
+    if (http.begin(*client_s, url_iot)) {  // HTTPS
+
+        // Serial.print("[HTTPS] GET...\n");
+        // start connection and send HTTP header
+        int httpCode = http.GET();
 
         // httpCode will be negative on error
         if (httpCode > 0) {
@@ -1536,287 +1766,7 @@ int BlinkerPRO::connectServer() {
     http.end();
 #endif
 
-    BLINKER_LOG_ALL(BLINKER_F("reply was:"));
-    BLINKER_LOG_ALL(BLINKER_F("=============================="));
-    BLINKER_LOG_ALL(payload);
-    BLINKER_LOG_ALL(BLINKER_F("=============================="));
-
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject& root = jsonBuffer.parseObject(payload);
-
-    if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
-        !STRING_contains_string(payload, BLINKER_CMD_IOTID)) {
-        // while(1) {
-            BLINKER_ERR_LOG(("Please make sure you have register this device!"));
-            // ::delay(60000);
-
-            return false;
-        // }
-    }
-
-    // String _userID = STRING_find_string(payload, "deviceName", "\"", 4);
-    // String _userName = STRING_find_string(payload, "iotId", "\"", 4);
-    // String _key = STRING_find_string(payload, "iotToken", "\"", 4);
-    // String _productInfo = STRING_find_string(payload, "productKey", "\"", 4);
-    // String _broker = STRING_find_string(payload, "broker", "\"", 4);
-    // String _uuid = STRING_find_string(payload, "uuid", "\"", 4);
-    String _userID = root[BLINKER_CMD_DETAIL][BLINKER_CMD_DEVICENAME];
-    String _userName = root[BLINKER_CMD_DETAIL][BLINKER_CMD_IOTID];
-    String _key = root[BLINKER_CMD_DETAIL][BLINKER_CMD_IOTTOKEN];
-    String _productInfo = root[BLINKER_CMD_DETAIL][BLINKER_CMD_PRODUCTKEY];
-    String _broker = root[BLINKER_CMD_DETAIL][BLINKER_CMD_BROKER];
-    String _uuid = root[BLINKER_CMD_DETAIL][BLINKER_CMD_UUID];
-    String _authKey = root[BLINKER_CMD_DETAIL][BLINKER_CMD_KEY];
-
-    if (isMQTTinit)
-    {
-        free(MQTT_HOST_PRO);
-        free(MQTT_ID_PRO);
-        free(MQTT_NAME_PRO);
-        free(MQTT_KEY_PRO);
-        free(MQTT_PRODUCTINFO_PRO);
-        free(UUID_PRO);
-        free(AUTHKEY_PRO);
-        free(MQTT_DEVICEID_PRO);
-        free(BLINKER_PUB_TOPIC_PRO);
-        free(BLINKER_SUB_TOPIC_PRO);
-        free(mqtt_PRO);
-        free(iotSub_PRO);
-
-        isMQTTinit = false;
-    }
-
-    BLINKER_LOG_ALL(("===================="));
-
-    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
-        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
-        // String _deviceName = _userID.substring(12, 36);
-        // MQTT_DEVICEID_PRO = (char*)malloc((_deviceName.length()+1)*sizeof(char));
-        // String _deviceName = _userID.substring(12, 36);
-        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
-        MQTT_ID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_PRO, _userID.c_str());
-        MQTT_NAME_PRO = (char*)malloc((_userName.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_PRO, _userName.c_str());
-        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_PRO, _key.c_str());
-        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
-        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_ALIYUN_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_ALIYUN_HOST);
-        AUTHKEY_PRO = (char*)malloc((_authKey.length()+1)*sizeof(char));
-        strcpy(AUTHKEY_PRO, _authKey.c_str());
-        MQTT_PORT_PRO = BLINKER_MQTT_ALIYUN_PORT;
-
-        BLINKER_LOG_ALL(("===================="));
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
-        // String id2name = _userID.subString(10, _userID.length());
-        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
-        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
-        String IDtest = _productInfo + _userID;
-        MQTT_ID_PRO = (char*)malloc((IDtest.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_PRO, IDtest.c_str());
-        String NAMEtest = IDtest + ";" + _userName;
-        MQTT_NAME_PRO = (char*)malloc((NAMEtest.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_PRO, NAMEtest.c_str());
-        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_PRO, _key.c_str());
-        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
-        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_QCLOUD_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_QCLOUD_HOST);
-        MQTT_PORT_PRO = BLINKER_MQTT_QCLOUD_PORT;
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
-        // memcpy(DEVICE_NAME, _userID.c_str(), 12);
-        MQTT_DEVICEID_PRO = (char*)malloc((_userID.length()+1)*sizeof(char));
-        strcpy(MQTT_DEVICEID_PRO, _userID.c_str());
-        MQTT_ID_PRO = (char*)malloc((_userName.length()+1)*sizeof(char));
-        strcpy(MQTT_ID_PRO, _userName.c_str());
-        MQTT_NAME_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_NAME_PRO, _productInfo.c_str());
-        MQTT_KEY_PRO = (char*)malloc((_key.length()+1)*sizeof(char));
-        strcpy(MQTT_KEY_PRO, _key.c_str());
-        MQTT_PRODUCTINFO_PRO = (char*)malloc((_productInfo.length()+1)*sizeof(char));
-        strcpy(MQTT_PRODUCTINFO_PRO, _productInfo.c_str());
-        MQTT_HOST_PRO = (char*)malloc((strlen(BLINKER_MQTT_ONENET_HOST)+1)*sizeof(char));
-        strcpy(MQTT_HOST_PRO, BLINKER_MQTT_ONENET_HOST);
-        MQTT_PORT_PRO = BLINKER_MQTT_ONENET_PORT;
-    }
-    UUID_PRO = (char*)malloc((_uuid.length()+1)*sizeof(char));
-    strcpy(UUID_PRO, _uuid.c_str());
-
-    char uuid_eeprom[BLINKER_AUUID_SIZE];
-
-    BLINKER_LOG_ALL(("==========AUTH CHECK=========="));
-
-    if (!isFirst)
-    {
-        char _authCheck;
-        EEPROM.begin(BLINKER_EEP_SIZE);
-        EEPROM.get(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
-        if (strcmp(uuid_eeprom, _uuid.c_str()) != 0) {
-            // strcpy(UUID_PRO, _uuid.c_str());
-
-            strcpy(uuid_eeprom, _uuid.c_str());
-            EEPROM.put(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
-            EEPROM.get(BLINKER_EEP_ADDR_AUUID, uuid_eeprom);
-
-            BLINKER_LOG_ALL(BLINKER_F("===================="));
-            BLINKER_LOG_ALL(BLINKER_F("uuid_eeprom: "), uuid_eeprom);
-            BLINKER_LOG_ALL(BLINKER_F("_uuid: "), _uuid);
-            isNew = true;
-        }
-        EEPROM.get(BLINKER_EEP_ADDR_AUTH_CHECK, _authCheck);
-        if (_authCheck != BLINKER_AUTH_CHECK_DATA) {
-            EEPROM.put(BLINKER_EEP_ADDR_AUTH_CHECK, BLINKER_AUTH_CHECK_DATA);
-            isAuth = true;
-        }
-        EEPROM.commit();
-        EEPROM.end();
-
-        isFirst = true;
-    }
-    
-    BLINKER_LOG_ALL(BLINKER_F("===================="));
-    BLINKER_LOG_ALL(BLINKER_F("DEVICE_NAME: "), macDeviceName());
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_PRODUCTINFO_PRO: "), MQTT_PRODUCTINFO_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_DEVICEID_PRO: "), MQTT_DEVICEID_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_ID_PRO: "), MQTT_ID_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_NAME_PRO: "), MQTT_NAME_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_KEY_PRO: "), MQTT_KEY_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("MQTT_BROKER: "), _broker);
-    BLINKER_LOG_ALL(BLINKER_F("HOST: "), MQTT_HOST_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("PORT: "), MQTT_PORT_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("UUID_PRO: "), UUID_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("AUTHKEY_PRO: "), AUTHKEY_PRO);
-    BLINKER_LOG_ALL(BLINKER_F("===================="));
-
-    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
-        String PUB_TOPIC_STR = BLINKER_F("/");
-        PUB_TOPIC_STR += MQTT_PRODUCTINFO_PRO;
-        PUB_TOPIC_STR += BLINKER_F("/");
-        PUB_TOPIC_STR += MQTT_DEVICEID_PRO;
-        PUB_TOPIC_STR += BLINKER_F("/s");
-
-        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
-        
-        String SUB_TOPIC_STR = BLINKER_F("/");
-        SUB_TOPIC_STR += MQTT_PRODUCTINFO_PRO;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += MQTT_DEVICEID_PRO;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-        
-        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
-        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
-        PUB_TOPIC_STR += BLINKER_F("/");
-        PUB_TOPIC_STR += _userID;
-        PUB_TOPIC_STR += BLINKER_F("/s");
-
-        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
-        
-        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += _userID;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-        
-        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
-        uint8_t str_len;
-        String PUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
-        PUB_TOPIC_STR += BLINKER_F("/onenet_rule/r");
-        // str_len = PUB_TOPIC_STR.length() + 1;
-        BLINKER_PUB_TOPIC_PRO = (char*)malloc((PUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_PUB_TOPIC_PRO, PUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_PUB_TOPIC_PRO: "), BLINKER_PUB_TOPIC_PRO);
-        
-        String SUB_TOPIC_STR = MQTT_PRODUCTINFO_PRO;
-        SUB_TOPIC_STR += BLINKER_F("/");
-        SUB_TOPIC_STR += _userID;
-        SUB_TOPIC_STR += BLINKER_F("/r");
-        
-        BLINKER_SUB_TOPIC_PRO = (char*)malloc((SUB_TOPIC_STR.length() + 1)*sizeof(char));
-        // memcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str(), str_len);
-        strcpy(BLINKER_SUB_TOPIC_PRO, SUB_TOPIC_STR.c_str());
-        
-        BLINKER_LOG_ALL(BLINKER_F("BLINKER_SUB_TOPIC_PRO: "), BLINKER_SUB_TOPIC_PRO);
-    }
-
-    // BLINKER_LOG_FreeHeap();
-
-    if (_broker == BLINKER_MQTT_BORKER_ALIYUN) {
-        #if defined(ESP8266)
-            // bool mfln = client_mqtt.probeMaxFragmentLength(MQTT_HOST_PRO, MQTT_PORT_PRO, 4096);
-            // if (mfln) {
-            //     client_mqtt.setBufferSizes(1024, 1024);
-            // }
-            // client_mqtt.setInsecure();
-            mqtt_PRO = new Adafruit_MQTT_Client(&client_mqtt, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
-        #elif defined(ESP32)
-            mqtt_PRO = new Adafruit_MQTT_Client(&client_s, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
-        #endif
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_QCLOUD) {
-        #if defined(ESP8266)
-            // bool mfln = client_mqtt.probeMaxFragmentLength(MQTT_HOST_PRO, MQTT_PORT_PRO, 4096);
-            // if (mfln) {
-            //     client_mqtt.setBufferSizes(1024, 1024);
-            // }
-            // client_mqtt.setInsecure();
-            mqtt_PRO = new Adafruit_MQTT_Client(&client_mqtt, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
-        #elif defined(ESP32)
-            mqtt_PRO = new Adafruit_MQTT_Client(&client_s, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
-        #endif
-    }
-    else if (_broker == BLINKER_MQTT_BORKER_ONENET) {
-        mqtt_PRO = new Adafruit_MQTT_Client(&client, MQTT_HOST_PRO, MQTT_PORT_PRO, MQTT_ID_PRO, MQTT_NAME_PRO, MQTT_KEY_PRO);
-    }
-
-    // iotPub = new Adafruit_MQTT_Publish(mqtt_PRO, BLINKER_PUB_TOPIC_PRO);
-    // if (!isMQTTinit) 
-    iotSub_PRO = new Adafruit_MQTT_Subscribe(mqtt_PRO, BLINKER_SUB_TOPIC_PRO);
-
-    // mqtt_broker = (char*)malloc((_broker.length()+1)*sizeof(char));
-    // strcpy(mqtt_broker, _broker.c_str());
-    // mqtt_broker = _broker;
-
-    // mDNSInit(MQTT_ID_PRO);
-    this->latestTime = millis();
-    // if (!isMQTTinit) 
-    mqtt_PRO->subscribe(iotSub_PRO);
-    isMQTTinit = true;
-    
-    #if defined(ESP8266)
-        // client_s->stop();
-        client_mqtt.setInsecure();
-    #endif
-    // connect();
-
-    return true;
+    return payload;
 }
 
 void BlinkerPRO::mDNSInit()
@@ -1964,7 +1914,7 @@ int BlinkerPRO::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
@@ -14,6 +14,8 @@
 #include "Functions/BlinkerHTTPAIR202.h"
 
 #include "modules/ArduinoJson/ArduinoJson.h"
+
+#include "Blinker/BlinkerJson.h"
 #include "Functions/BlinkerMQTTAIR202.h"
 
 #include <EEPROM.h>
@@ -97,8 +99,7 @@ class BlinkerProAIR202 : public BlinkerStream
         int checkDuerPrintSpan();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
         Stream*     stream;
         // char*       streamData;
@@ -296,7 +297,7 @@ void BlinkerProAIR202::subscribe()
     {
         BLINKER_LOG_ALL(BLINKER_F("Got: "), mqtt_GPRS->lastRead);
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(String(mqtt_GPRS->lastRead));
 
         String _uuid = root["fromDevice"];
@@ -342,31 +343,28 @@ void BlinkerProAIR202::subscribe()
         }
         else
         {
-            if (_sharerCount)
+            if (_sharers.count())
             {
-                for (uint8_t num = 0; num < _sharerCount; num++)
+                int8_t num = _sharers.find(_uuid.c_str());
+
+                if (num != BLINKER_OBJECT_NOT_AVAIL)
+                {
+                    _sharerFrom = num;
+
+                    kaTime = millis();
+
+                    BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                    BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+
+                    _needCheckShare = false;
+                }
+                else
                 {
-                    if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                    {
-                        _sharerFrom = num;
-
-                        kaTime = millis();
-
-                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
-                        
-                        _needCheckShare = false;
-
-                        break;
-                    }
-                    else
-                    {
-                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
-                                    check is from bridge/share device, \
-                                    data: "), dataGet);
-
-                        _needCheckShare = true;
-                    }
+                    BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid, \
+                                check is from bridge/share device, \
+                                data: "), dataGet);
+
+                    _needCheckShare = true;
                 }
             }
             root.printTo(dataGet);
@@ -427,7 +425,7 @@ int BlinkerProAIR202::print(char * data, bool needCheck)
     strcat(data, "\",\"toDevice\":\"");
     if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
     {
-        strcat(data, _sharers[_sharerFrom]->uuid());
+        strcat(data, _sharers.uuid(_sharerFrom));
     }
     else
     {
@@ -892,40 +890,26 @@ void BlinkerProAIR202::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (uint8_t num = _sharerCount; num > 0; num--)
-        {
-            delete _sharers[num - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 int BlinkerProAIR202::authCheck()
@@ -1012,7 +996,7 @@ int BlinkerProAIR202::connectServer()
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1369,7 +1353,7 @@ int BlinkerProAIR202::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success())
@@ -19,12 +19,16 @@
 #include "modules/mqtt/Adafruit_MQTT.h"
 #include "modules/mqtt/Adafruit_MQTT_Client.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 // #include "Adapters/BlinkerPROESP.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerRegCache.h"
 
 char*       MQTT_HOST_PRO;
 char*       MQTT_ID_PRO;
@@ -73,6 +77,7 @@ class BlinkerPROESP : public BlinkerStream
         int deviceRegister() { return connectServer(); }
         int authCheck();
         void freshAlive() { kaTime = millis(); isAlive = true; }
+        BlinkerSupervisor * link() { return &_link; }
         void sharers(const String & data);
         int  needFreshShare() {
             if (_needCheckShare)
@@ -92,6 +97,8 @@ class BlinkerPROESP : public BlinkerStream
         bool isMQTTinit = false;
 
         int connectServer();
+        String authGet(const String & host);
+        String regId() { return STRING_format(_deviceType) + _vipKey; }
         void mDNSInit();
         void checkKA();
         int checkAliKA();
@@ -104,8 +111,8 @@ class BlinkerPROESP : public BlinkerStream
         int pubHello();
 
     protected :
-        BlinkerSharer * _sharers[BLINKER_MQTT_MAX_SHARERS_NUM];
-        uint8_t     _sharerCount = 0;
+        BlinkerSharers  _sharers;
+        BlinkerSupervisor   _link;
         uint8_t     _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
         const char* _vipKey;
         const char* _deviceType;
@@ -138,11 +145,11 @@ class BlinkerPROESP : public BlinkerStream
         bool        isNew = false;
         bool        isAuth = false;
         bool        isFirst = false;
+        BlinkerRegCache _regCache;
+        bool        _isRegCached = false;
 
         int isJson(const String & data);
 
-        uint8_t     reconnect_time = 0;
-
         bool        _isAuthKey = false;
 };
 
@@ -229,6 +236,10 @@ void webSocketEvent_PRO(uint8_t num, WStype_t type, \
             // webSocket_PRO.broadcastTXT("message here");
             break;
         case WStype_BIN:
+            #if defined(BLINKER_SENSOR_STREAM)
+                BLINKER_SENSOR.push(payload, length);
+            #endif
+
             // BLINKER_LOG("num: ", num, " get binary length: ", length);
             // hexdump(payload, length);
 
@@ -242,57 +253,31 @@ BlinkerPROESP::BlinkerPROESP() { isHandle = &isConnect_PRO; }
 
 int BlinkerPROESP::connect()
 {
-    int8_t ret;
-
     webSocket_PRO.loop();
 
     if (!isMQTTinit) {
         return *isHandle;
     }
 
-    if (mqtt_PRO->connected())
-    {
-        return true;
-    }
+    if (_link.connected()) return true;
 
-    disconnect();
+    int8_t ret = _link.connect();
 
-    if ((millis() - latestTime) < BLINKER_MQTT_CONNECT_TIMESLOT && latestTime > 0)
+    if (ret == MQTT_CONNECT_WAIT)
     {
         yield();
         return false;
     }
 
-    BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
-
-    #if defined(ESP8266)
-        client_mqtt.setInsecure();
-        ::delay(10);
-    #endif
-
-    BLINKER_LOG_FreeHeap_ALL();
-
-    if ((ret = mqtt_PRO->connect()) != 0)
+    if (ret != 0)
     {
         BLINKER_LOG(mqtt_PRO->connectErrorString(ret));
-        BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
-                    BLINKER_MQTT_CONNECT_TIMESLOT/1000, \
-                    BLINKER_F(" seconds..."));
 
-        if (ret == 4) reRegister();
+        if (ret == 4 || _link.failNum() % 12 == 0) reRegister();
 
-        this->latestTime = millis();
-        reconnect_time += 1;
-        if (reconnect_time >= 12)
-        {
-            reRegister();
-            reconnect_time = 0;
-        }
         return false;
     }
-    
-    reconnect_time = 0;
-    
+
     BLINKER_LOG(BLINKER_F("MQTT Connected!"));
     BLINKER_LOG_FreeHeap();
 
@@ -315,41 +300,27 @@ int BlinkerPROESP::connected()
         return *isHandle;
     }
 
-    return mqtt_PRO->connected() || *isHandle; 
+    return _link.connected() || *isHandle; 
 }
 
 int BlinkerPROESP::mConnected()
 {
     if (!isMQTTinit) return false;
-    else return mqtt_PRO->connected();
+    else return _link.connected();
 }
 
 void BlinkerPROESP::disconnect()
 {
-    if (isMQTTinit) mqtt_PRO->disconnect();
+    if (isMQTTinit) _link.disconnect();
 
     if (*isHandle) webSocket_PRO.disconnect();
 }
 
 void BlinkerPROESP::ping()
 {
-    BLINKER_LOG_ALL(BLINKER_F("MQTT Ping!"));
-
-    BLINKER_LOG_FreeHeap_ALL();
-
     if (!isMQTTinit) return;
 
-    if (!mqtt_PRO->ping())
-    {
-        disconnect();
-        // delay(100);
-
-        // connect();
-    }
-    else
-    {
-        this->latestTime = millis();
-    }
+    _link.keepAlive(latestTime);
 }
 
 int BlinkerPROESP::available()
@@ -357,18 +328,16 @@ int BlinkerPROESP::available()
     webSocket_PRO.loop();
 
     if (isMQTTinit) {
-        checkKA();
-
-        // if (!mqtt_PRO->connected() || \
-        //     (millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
-        if ((millis() - this->latestTime) > BLINKER_MQTT_PING_TIMEOUT)
+        if (_isRegCached && _regCache.expired())
         {
-            ping();
-        }
-        else
-        {
-            subscribe();
+            _regCache.erase();
+            reRegister();
         }
+
+        checkKA();
+
+        ping();
+        subscribe();
     }
 
     if (isAvail_PRO)
@@ -423,13 +392,13 @@ void BlinkerPROESP::subscribe()
     if (!isMQTTinit) return;
 
     Adafruit_MQTT_Subscribe *subscription;
-    while ((subscription = mqtt_PRO->readSubscription(10)))
+    while ((subscription = mqtt_PRO->readSubscription(0)))
     {
         if (subscription == iotSub_PRO)
         {
             BLINKER_LOG_ALL(BLINKER_F("Got: "), (char *)iotSub_PRO->lastread);
             
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(String((char *)iotSub_PRO->lastread));
 
             String _uuid = root["fromDevice"];
@@ -475,31 +444,28 @@ void BlinkerPROESP::subscribe()
             }
             else
             {
-                if (_sharerCount)
+                if (_sharers.count())
                 {
-                    for (uint8_t num = 0; num < _sharerCount; num++)
-                    {
-                        if (strcmp(_uuid.c_str(), _sharers[num]->uuid()) == 0)
-                        {
-                            _sharerFrom = num;
+                    int8_t num = _sharers.find(_uuid.c_str());
 
-                            kaTime = millis();
+                    if (num != BLINKER_OBJECT_NOT_AVAIL)
+                    {
+                        _sharerFrom = num;
 
-                            BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
-                            BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
+                        kaTime = millis();
 
-                            _needCheckShare = false;
+                        BLINKER_LOG_ALL(BLINKER_F("From sharer: "), _uuid);
+                        BLINKER_LOG_ALL(BLINKER_F("sharer num: "), num);
 
-                            break;
-                        }
-                        else
-                        {
-                            BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid,"
-                                        "check is from bridge/share device," 
-                                        "data: "), dataGet);
+                        _needCheckShare = false;
+                    }
+                    else
+                    {
+                        BLINKER_ERR_LOG_ALL(BLINKER_F("No authority uuid,"
+                                    "check is from bridge/share device,"
+                                    "data: "), dataGet);
 
-                            _needCheckShare = true;
-                        }                        
+                        _needCheckShare = true;
                     }
                 }
                 
@@ -612,37 +578,18 @@ int BlinkerPROESP::print(char * data, bool needCheck)
         //     // payload += BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
         // }
 
-        uint16_t num = strlen(data);
+        // the envelope is sent around data, data itself is not moved
+        const char * toDevice = UUID_PRO;
 
-        for(uint16_t c_num = num; c_num > 0; c_num--)
-        {
-            data[c_num+7] = data[c_num-1];
-        }
-
-        data[num+8] = '\0';
-
-        String data_add = BLINKER_F("{\"data\":");
-        
-        for(uint16_t c_num = 0; c_num < 8; c_num++)
-        {
-            data[c_num] = data_add[c_num];
-        }
-
-        data_add = BLINKER_F(",\"fromDevice\":\"");
-        strcat(data, data_add.c_str());
-        strcat(data, MQTT_DEVICEID_PRO);
-        data_add = BLINKER_F("\",\"toDevice\":\"");
-        strcat(data, data_add.c_str());
         if (_sharerFrom < BLINKER_MQTT_MAX_SHARERS_NUM)
         {
-            strcat(data, _sharers[_sharerFrom]->uuid());
-        }
-        else
-        {
-            strcat(data, UUID_PRO);
+            toDevice = _sharers.uuid(_sharerFrom);
         }
-        data_add = BLINKER_F("\",\"deviceType\":\"OwnApp\"}");
-        strcat(data, data_add.c_str());
+
+        Adafruit_MQTT_Segment payload[] = {
+            "{\"data\":", data, ",\"fromDevice\":\"", MQTT_DEVICEID_PRO,
+            "\",\"toDevice\":\"", toDevice, "\",\"deviceType\":\"OwnApp\"}"
+        };
 
         _sharerFrom = BLINKER_MQTT_FROM_AUTHER;
 
@@ -676,7 +623,7 @@ int BlinkerPROESP::print(char * data, bool needCheck)
                 }
             }
 
-            if (! mqtt_PRO->publish(BLINKER_PUB_TOPIC_PRO, data))
+            if (! mqtt_PRO->publish(BLINKER_PUB_TOPIC_PRO, payload, sizeof(payload)/sizeof(payload[0])))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1159,40 +1106,26 @@ void BlinkerPROESP::sharers(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("sharers data: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success()) return;
 
-    String user_name = "";
-
-    if (_sharerCount)
-    {
-        for (_sharerCount; _sharerCount > 0; _sharerCount--)
-        {
-            delete _sharers[_sharerCount - 1];
-        }
-    }
-
-    _sharerCount = 0;
+    // slots of sharers still listed are kept, only changes touch the table
+    _sharers.mark();
 
     for (uint8_t num = 0; num < BLINKER_MQTT_MAX_SHARERS_NUM; num++)
     {
-        user_name = root["users"][num].as<String>();
+        const char * user_name = root["users"][num];
 
-        if (user_name.length() == BLINKER_MQTT_USER_UUID_SIZE)
-        {
-            BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name, BLINKER_F(", length: "), user_name.length());
+        if (!user_name) break;
 
-            _sharerCount++;
+        BLINKER_LOG_ALL(BLINKER_F("sharer uuid: "), user_name);
 
-            _sharers[num] = new BlinkerSharer(user_name);
-        }
-        else
-        {
-            break;
-        }
+        if (_sharers.add(user_name) == BLINKER_OBJECT_NOT_AVAIL) break;
     }
+
+    _sharers.sweep();
 }
 
 int BlinkerPROESP::authCheck()
@@ -1228,6 +1161,22 @@ int BlinkerPROESP::connectServer() {
     #elif defined(ESP32)
         String host = BLINKER_F("https://iotdev.clz.me");
     #endif
+    String payload;
+
+    // a cached registration is the authKey and the auth reply, one per line
+    _isRegCached = !_isAuthKey && _regCache.load(regId().c_str(), payload);
+
+    if (_isRegCached)
+    {
+        String _getAuthKey = payload.substring(0, payload.indexOf('\n'));
+        payload.remove(0, _getAuthKey.length() + 1);
+
+        AUTHKEY_PRO = (char*)malloc((_getAuthKey.length()+1)*sizeof(char));
+        strcpy(AUTHKEY_PRO, _getAuthKey.c_str());
+
+        _isAuthKey = true;
+    }
+
     if (!_isAuthKey)
     {
     #if defined(ESP8266)
@@ -1507,7 +1456,7 @@ int BlinkerPROESP::connectServer() {
         BLINKER_LOG_ALL(payload);
         BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(payload);
 
         if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1534,135 +1483,14 @@ int BlinkerPROESP::connectServer() {
         _isAuthKey = true;
     }
 
-#if defined(ESP8266)
-    // client_mqtt.stop();
-
-    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
-
-    // client_s->setFingerprint(fingerprint);
-    client_s->setInsecure();
-
-    String url_iot = BLINKER_F("/api/v1/user/device/auth?authKey=");
-    url_iot += AUTHKEY_PRO;
-    // url_iot += _aliType;
-    // url_iot += _duerType;
-
-    #if defined(BLINKER_ALIGENIE_LIGHT)
-        url_iot += BLINKER_F("&aliType=light");
-    #elif defined(BLINKER_ALIGENIE_OUTLET)
-        url_iot += BLINKER_F("&aliType=outlet");
-    #elif defined(BLINKER_ALIGENIE_SWITCH)
-        url_iot += BLINKER_F("&aliType=multi_outlet");
-    #elif defined(BLINKER_ALIGENIE_SENSOR)
-        url_iot += BLINKER_F("&aliType=sensor");
-    #elif defined(BLINKER_ALIGENIE_TYPE)
-        url_iot += BLINKER_ALIGENIE_TYPE;
-    #endif
-
-    #if defined(BLINKER_DUEROS_LIGHT)
-        url_iot += BLINKER_F("&duerType=LIGHT");
-    #elif defined(BLINKER_DUEROS_OUTLET)
-        url_iot += BLINKER_F("&duerType=SOCKET");
-    #elif defined(BLINKER_DUEROS_MULTI_OUTLET)
-        url_iot += BLINKER_F("&duerType=MULTI_SOCKET");
-    #elif defined(BLINKER_DUEROS_SENSOR)
-        url_iot += BLINKER_F("&duerType=AIR_MONITOR");
-    #elif defined(BLINKER_DUEROS_TYPE)
-        url_iot += BLINKER_DUEROS_TYPE;
-    #endif
-
-    url_iot = "https://" + host + url_iot;
-
-    HTTPClient http;
-
-    String payload = "";
-
-    BLINKER_LOG_ALL(BLINKER_F("[HTTP] begin: "), url_iot);
-
-    if (http.begin(*client_s, url_iot)) {  // HTTPS
-
-        // Serial.print("[HTTPS] GET...\n");
-        // start connection and send HTTP header
-        int httpCode = http.GET();
-
-        // httpCode will be negative on error
-        if (httpCode > 0) {
-            // HTTP header has been send and Server response header has been handled
-
-            BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
-
-            // file found at server
-            if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
-                payload = http.getString();
-                // Serial.println(payload);
-            }
-        } else {
-            BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
-            payload = http.getString();
-            BLINKER_LOG(payload);
-        }
-
-        http.end();
-    } else {
-        // Serial.printf("[HTTPS] Unable to connect\n");
-    }
-
-#elif defined(ESP32)
-    HTTPClient http;
-
-    String url_iot = host;
-    url_iot += BLINKER_F("/api/v1/user/device/auth?authKey=");
-    url_iot += AUTHKEY_AUTO;
-    // url_iot += _aliType;
-    // url_iot += _duerType;
-
-    #if defined(BLINKER_ALIGENIE_LIGHT)
-        url_iot += BLINKER_F("&aliType=light");
-    #elif defined(BLINKER_ALIGENIE_OUTLET)
-        url_iot += BLINKER_F("&aliType=outlet");
-    #elif defined(BLINKER_ALIGENIE_SWITCH)
-    #elif defined(BLINKER_ALIGENIE_SENSOR)
-        url_iot += BLINKER_F("&aliType=sensor");
-    #endif
-
-    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
-
-// #if defined(ESP8266)
-//     http.begin(url_iot, fingerprint); //HTTP
-// #elif defined(ESP32)
-    // http.begin(url_iot, ca); TODO
-    http.begin(url_iot);
-// #endif
-    int httpCode = http.GET();
-
-    String payload = "";
-
-    if (httpCode > 0) {
-      // HTTP header has been send and Server response header has been handled
-
-        BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
-
-        // file found at server
-        if (httpCode == HTTP_CODE_OK) {
-            payload = http.getString();
-            // BLINKER_LOG(payload);
-        }
-    }
-    else {
-        BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
-        payload = http.getString();
-        BLINKER_LOG(payload);
-    }
-
-    http.end();
-#endif
+    if (!_isRegCached) payload = authGet(host);
 
     BLINKER_LOG_ALL(BLINKER_F("reply was:"));
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -1671,10 +1499,17 @@ int BlinkerPROESP::connectServer() {
             BLINKER_ERR_LOG(("Please make sure you have register this device!"));
             // ::delay(60000);
 
+            if (_isRegCached) _regCache.erase();
+
             return false;
         // }
     }
 
+    if (!_isRegCached)
+    {
+        _regCache.save(regId().c_str(), STRING_format(AUTHKEY_PRO) + "\n" + payload);
+    }
+
     // String _userID = STRING_find_string(payload, "deviceName", "\"", 4);
     // String _userName = STRING_find_string(payload, "iotId", "\"", 4);
     // String _key = STRING_find_string(payload, "iotToken", "\"", 4);
@@ -1701,8 +1536,8 @@ int BlinkerPROESP::connectServer() {
         free(MQTT_DEVICEID_PRO);
         free(BLINKER_PUB_TOPIC_PRO);
         free(BLINKER_SUB_TOPIC_PRO);
-        free(mqtt_PRO);
-        free(iotSub_PRO);
+        delete mqtt_PRO;
+        delete iotSub_PRO;
 
         isMQTTinit = false;
     }
@@ -1929,6 +1764,7 @@ int BlinkerPROESP::connectServer() {
     this->latestTime = millis();
     // if (!isMQTTinit) 
     mqtt_PRO->subscribe(iotSub_PRO);
+    _link.attach(mqtt_PRO);
     isMQTTinit = true;
     
     #if defined(ESP8266)
@@ -1940,6 +1776,134 @@ int BlinkerPROESP::connectServer() {
     return true;
 }
 
+String BlinkerPROESP::authGet(const String & host)
+{
+#if defined(ESP8266)
+    // client_mqtt.stop();
+
+    std::unique_ptr<BearSSL::WiFiClientSecure>client_s(new BearSSL::WiFiClientSecure);
+
+    // client_s->setFingerprint(fingerprint);
+    client_s->setInsecure();
+
+    String url_iot = BLINKER_F("/api/v1/user/device/auth?authKey=");
+    url_iot += AUTHKEY_PRO;
+    // url_iot += _aliType;
+    // url_iot += _duerType;
+
+    #if defined(BLINKER_ALIGENIE_LIGHT)
+        url_iot += BLINKER_F("&aliType=light");
+    #elif defined(BLINKER_ALIGENIE_OUTLET)
+        url_iot += BLINKER_F("&aliType=outlet");
+    #elif defined(BLINKER_ALIGENIE_SWITCH)
+        url_iot += BLINKER_F("&aliType=multi_outlet");
+    #elif defined(BLINKER_ALIGENIE_SENSOR)
+        url_iot += BLINKER_F("&aliType=sensor");
+    #elif defined(BLINKER_ALIGENIE_TYPE)
+        url_iot += BLINKER_ALIGENIE_TYPE;
+    #endif
+
+    #if defined(BLINKER_DUEROS_LIGHT)
+        url_iot += BLINKER_F("&duerType=LIGHT");
+    #elif defined(BLINKER_DUEROS_OUTLET)
+        url_iot += BLINKER_F("&duerType=SOCKET");
+    #elif defined(BLINKER_DUEROS_MULTI_OUTLET)
+        url_iot += BLINKER_F("&duerType=MULTI_SOCKET");
+    #elif defined(BLINKER_DUEROS_SENSOR)
+        url_iot += BLINKER_F("&duerType=AIR_MONITOR");
+    #elif defined(BLINKER_DUEROS_TYPE)
+        url_iot += BLINKER_DUEROS_TYPE;
+    #endif
+
+    url_iot = "https://" + host + url_iot;
+
+    HTTPClient http;
+
+    String payload = "";
+
+    BLINKER_LOG_ALL(BLINKER_F("[HTTP] begin: "), url_iot);
+
+    if (http.begin(*client_s, url_iot)) {  // HTTPS
+
+        // Serial.print("[HTTPS] GET...\n");
+        // start connection and send HTTP header
+        int httpCode = http.GET();
+
+        // httpCode will be negative on error
+        if (httpCode > 0) {
+            // HTTP header has been send and Server response header has been handled
+
+            BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
+
+            // file found at server
+            if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
+                payload = http.getString();
+                // Serial.println(payload);
+            }
+        } else {
+            BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
+            payload = http.getString();
+            BLINKER_LOG(payload);
+        }
+
+        http.end();
+    } else {
+        // Serial.printf("[HTTPS] Unable to connect\n");
+    }
+
+#elif defined(ESP32)
+    HTTPClient http;
+
+    String url_iot = host;
+    url_iot += BLINKER_F("/api/v1/user/device/auth?authKey=");
+    url_iot += AUTHKEY_AUTO;
+    // url_iot += _aliType;
+    // url_iot += _duerType;
+
+    #if defined(BLINKER_ALIGENIE_LIGHT)
+        url_iot += BLINKER_F("&aliType=light");
+    #elif defined(BLINKER_ALIGENIE_OUTLET)
+        url_iot += BLINKER_F("&aliType=outlet");
+    #elif defined(BLINKER_ALIGENIE_SWITCH)
+    #elif defined(BLINKER_ALIGENIE_SENSOR)
+        url_iot += BLINKER_F("&aliType=sensor");
+    #endif
+
+    BLINKER_LOG_ALL(BLINKER_F("HTTPS begin: "), url_iot);
+
+// #if defined(ESP8266)
+//     http.begin(url_iot, fingerprint); //HTTP
+// #elif defined(ESP32)
+    // http.begin(url_iot, ca); TODO
+    http.begin(url_iot);
+// #endif
+    int httpCode = http.GET();
+
+    String payload = "";
+
+    if (httpCode > 0) {
+      // HTTP header has been send and Server response header has been handled
+
+        BLINKER_LOG_ALL(BLINKER_F("[HTTP] GET... code: "), httpCode);
+
+        // file found at server
+        if (httpCode == HTTP_CODE_OK) {
+            payload = http.getString();
+            // BLINKER_LOG(payload);
+        }
+    }
+    else {
+        BLINKER_LOG(BLINKER_F("[HTTP] GET... failed, error: "), http.errorToString(httpCode).c_str());
+        payload = http.getString();
+        BLINKER_LOG(payload);
+    }
+
+    http.end();
+#endif
+
+    return payload;
+}
+
 void BlinkerPROESP::mDNSInit()
 {
 #if defined(ESP8266)
@@ -2085,7 +2049,7 @@ int BlinkerPROESP::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(STRING_format(data));
 
     if (!root.success())
@@ -14,6 +14,8 @@
 #include "Functions/BlinkerHTTPAIR202.h"
 
 #include "modules/ArduinoJson/ArduinoJson.h"
+
+#include "Blinker/BlinkerJson.h"
 #include "Functions/BlinkerMQTTAIR202.h"
 
 // #if defined(ESP32)
@@ -228,7 +230,7 @@ void BlinkerSerialGPRS::subscribe()
     {
         BLINKER_LOG_ALL(BLINKER_F("Got: "), mqtt_GPRS->lastRead);
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(String(mqtt_GPRS->lastRead));
 
         String _uuid = root["fromDevice"];
@@ -606,7 +608,7 @@ int BlinkerSerialGPRS::connectServer()
     BLINKER_LOG_ALL(payload);
     BLINKER_LOG_ALL(BLINKER_F("=============================="));
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(payload);
 
     if (STRING_contains_string(payload, BLINKER_CMD_NOTFOUND) || !root.success() ||
@@ -847,7 +849,7 @@ int BlinkerSerialGPRS::isJson(const String & data)
 {
     BLINKER_LOG_ALL(BLINKER_F("isJson: "), data);
 
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
 
     if (!root.success())
@@ -11,6 +11,7 @@
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerTLV.h"
 
 class BlinkerSubStream : public BlinkerStream
 {
@@ -25,7 +26,38 @@ class BlinkerSubStream : public BlinkerStream
             {
                 if (_subAvail())
                 {
-                    String data = _subRead();
+                    uint8_t _addr;
+                    String data;
+
+                    int8_t type = STRING_frame_decode(_subRead(), _addr, data);
+
+                    if (type == BLINKER_FRAME_ERROR) return false;
+
+                    if (subAddr && _addr && _addr != subAddr && \
+                        _addr != BLINKER_FRAME_BROADCAST) return false;
+
+                    if (type == BLINKER_FRAME_TLV)
+                    {
+                    #if defined(BLINKER_SUB_TLV)
+                        String json;
+
+                        if (!subTLV.decode(data, json))
+                        {
+                            String sync = subTLV.encode(BLINKER_F("{}"));
+
+                            if (_subPrint && sync.length())
+                            {
+                                _subPrint(STRING_frame_encode(subAddr, sync, BLINKER_FRAME_MAGIC_TLV));
+                                subTLV.commit();
+                            }
+                            return false;
+                        }
+
+                        data = json;
+                    #else
+                        return false;
+                    #endif
+                    }
 
                     if (isFresh) free(streamData);
                     streamData = (char*)malloc((data.length()+1)*sizeof(char));
@@ -80,7 +112,37 @@ class BlinkerSubStream : public BlinkerStream
             {
                 BLINKER_LOG_ALL(BLINKER_F("Succese..."));
                 
-                _subPrint(data);
+                if (!subAddr)
+                {
+                    _subPrint(data);
+                    return true;
+                }
+
+                String frame;
+
+            #if defined(BLINKER_SUB_TLV)
+                String tlv = subTLV.encode(STRING_format(data));
+
+                if (tlv.length()) frame = STRING_frame_encode(subAddr, tlv, BLINKER_FRAME_MAGIC_TLV);
+
+                bool isTLV = frame.length() > 0;
+            #endif
+
+                if (!frame.length()) frame = STRING_frame_encode(subAddr, STRING_format(data));
+
+                // over the 14 bit length of the frame header
+                if (!frame.length())
+                {
+                    BLINKER_ERR_LOG(BLINKER_F("frame too long, drop: "), strlen(data));
+                    return false;
+                }
+
+                _subPrint(frame);
+
+            #if defined(BLINKER_SUB_TLV)
+                if (isTLV) subTLV.commit();
+            #endif
+
                 return true;
             }
             else
@@ -156,6 +218,7 @@ class BlinkerSubStream : public BlinkerStream
         void attachConnect(blinker_callback_return_int_t func) { _subConnect = func; }
         void attachConnected(blinker_callback_return_int_t func) { _subConnected = func; }
         void attachDisconnect(blinker_callback_t func) { _subDisconnect = func; }
+        void subAddress(uint8_t id) { subAddr = id; }
 
     protected :
         char*   _authKey;
@@ -166,6 +229,10 @@ class BlinkerSubStream : public BlinkerStream
         bool    isConnect;
         uint8_t respTimes = 0;
         uint32_t    respTime = 0;
+        uint8_t     subAddr = 0;
+    #if defined(BLINKER_SUB_TLV)
+        BlinkerTLV  subTLV;
+    #endif
         blinker_callback_return_int_t       _subAvail = NULL;
         blinker_callback_return_string_t    _subRead = NULL;
         blinker_callback_with_string_arg_t  _subPrint = NULL;
@@ -17,6 +17,7 @@
     #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
         defined(BLINKER_PRO_ESP)
         #include "Functions/BlinkerWlan.h"
+        #include "Blinker/BlinkerBoot.h"
     #endif
 #else
     #include "Functions/BlinkerTicker.h"
@@ -72,6 +73,15 @@
 #endif
 
 #include "Blinker/BlinkerApiBase.h"
+#include "Blinker/BlinkerClock.h"
+#include "Blinker/BlinkerRetain.h"
+#include "Blinker/BlinkerScheduler.h"
+#include "Blinker/BlinkerProfiler.h"
+#include "Blinker/BlinkerHeap.h"
+#include "Blinker/BlinkerSnapshot.h"
+#include "Blinker/BlinkerSensor.h"
+#include "Blinker/BlinkerSupervisor.h"
+#include "Blinker/BlinkerToken.h"
 #include "Blinker/BlinkerProtocol.h"
 
 typedef BlinkerProtocol BProto;
@@ -217,6 +227,8 @@ class BlinkerApi : public BlinkerProtocol
         // template <typename T1>
         void printNumArray(char * _name, const String & data);
 
+        uint16_t shadowEpoch() { return _shadowEpoch; }
+
         template <typename T1>
         void printObject(T1 n1, const String &s2);
 
@@ -262,9 +274,42 @@ class BlinkerApi : public BlinkerProtocol
         void notify(T n);
         void vibrate(uint16_t ms = 200);
         void delay(unsigned long ms);
-        void attachAhrs();
+        int8_t attachTask(blinker_callback_t newFunction, uint32_t _interval, uint32_t _delay = 0)
+        { return _scheduler.attach(newFunction, _interval, _delay); }
+        void detachTask(int8_t num) { _scheduler.detach(num); }
+        void wakeTask(int8_t num)   { _scheduler.wake(num); }
+        // ms until the next task is due, low power sketches may sleep this long
+        uint32_t nextWakeup()       { return _scheduler.nextWakeup(); }
+        // worst time between two run() calls / in one task, us
+        uint32_t loopLatency()      { return _loopMax; }
+        uint32_t taskLatency()      { return _scheduler.maxLatency(); }
+        #if defined(BLINKER_PROFILE)
+            // time of each run() phase and the slowest pass, json
+            String profile()            { return _profiler.dump(); }
+            void profileReset()         { _profiler.reset(); }
+        #endif
+        #if defined(BLINKER_HEAP_TRACK)
+            // live bytes per tag and heap fragmentation, json or log
+            String heap()               { return BLINKER_HEAP.snapshot(); }
+            void heapReport()           { BLINKER_HEAP.report(); }
+        #endif
+        #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+            defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+            defined(BLINKER_PRO_ESP)
+            // broker link quality, round trip and time offline in ms
+            uint16_t linkRtt()          { return BProto::link() ? BProto::link()->rtt() : 0; }
+            uint32_t linkReconnects()   { return BProto::link() ? BProto::link()->reconnectNum() : 0; }
+            uint32_t linkOffline()      { return BProto::link() ? BProto::link()->offlineTime() : 0; }
+        #endif
+        #if defined(BLINKER_SENSOR_STREAM)
+            void attachAhrs(uint8_t freq = BLINKER_SENSOR_FREQ);
+            int16_t ahrs(b_ahrsattitude_t attitude) { return BLINKER_SENSOR.ahrs(attitude); }
+            bool sensorRead(b_sensor_t & sample) { return BLINKER_SENSOR.read(sample); }
+        #else
+            void attachAhrs();
+            int16_t ahrs(b_ahrsattitude_t attitude) { return ahrsValue[attitude]; }
+        #endif
         void detachAhrs();
-        int16_t ahrs(b_ahrsattitude_t attitude) { return ahrsValue[attitude]; }
         float gps(b_gps_t axis);
 
         #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
@@ -344,6 +389,14 @@ class BlinkerApi : public BlinkerProtocol
                 char * bridgeKey(uint8_t num);
                 char * bridgeName(uint8_t num);
                 void bridgeInit();
+                void bridgeIndex();
+                void bridgeRename(uint8_t num, const String & name);
+                int8_t bridgeFind(const char * name);
+                void bridgeFlush();
+                #if defined(ESP8266) || defined(ESP32)
+                    bool bridgeLoad(uint8_t num);
+                    void bridgeSave(uint8_t num);
+                #endif
 
                 void bridgePrint(char * bName, const String & data);
             #endif
@@ -436,6 +489,10 @@ class BlinkerApi : public BlinkerProtocol
             { _gatewayRead = newFunction; }
             void attachGatewayPrint(blinker_callback_with_string_arg_t newFunction)
             { _gatewayPrint = newFunction; }
+            uint8_t attachSubDevice(char * _ns);
+            // one connected pass of run() over the app link and the sub
+            // device links, lets a gateway run on links of its own
+            void gatewayPoll();
         #endif
 
         // #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || defined(BLINKER_MQTT_AT)
@@ -499,7 +556,8 @@ class BlinkerApi : public BlinkerProtocol
                 _dataStorageFunc = newFunction;
                 if (_time < 60) _time = 60;
                 _autoStorageTime = _time;
-                _autoDataTime = millis();
+                _scheduler.detach(_dataStorageTask);
+                _dataStorageTask = _scheduler.attach(newFunction, _time * 1000, _time * 1000);
                 if (d_times > BLINKER_MAX_DATA_COUNT || d_times == 0) d_times = BLINKER_DATA_UPDATE_COUNT;
                 _dataTimes = d_times;
             }
@@ -612,6 +670,23 @@ class BlinkerApi : public BlinkerProtocol
         int16_t     ahrsValue[3];
         float       gpsValue[2];
         uint32_t    gps_get_time;
+        bool        _ahrsWait = false;
+        int8_t      _ahrsTask = BLINKER_OBJECT_NOT_AVAIL;
+
+        #if defined(BLINKER_SENSOR_STREAM)
+            uint8_t     _ahrsFreq = BLINKER_SENSOR_FREQ;
+            uint32_t    _ahrsNum = 0;
+        #endif
+
+        void ahrsRequest();
+        static void ahrsTask(void * arg);
+
+        BlinkerScheduler    _scheduler;
+        uint32_t            _loopTime = 0;
+        uint32_t            _loopMax = 0;
+        #if defined(BLINKER_PROFILE)
+            BlinkerProfiler     _profiler;
+        #endif
 
         uint8_t     _wCount_num = 0;
         uint8_t     _wCount_str = 0;
@@ -680,6 +755,8 @@ class BlinkerApi : public BlinkerProtocol
                 char                            _lpAction2[BLINKER_TIMER_LOOP_ACTION2_SIZE];
                 class BlinkerTimingTimer *      timingTask[BLINKER_TIMING_TIMER_SIZE];
                 class BlinkerBridge_key *       _Bridge[BLINKER_MAX_BRIDGE_SIZE];
+                uint8_t                         _bridgeTable[BLINKER_BRIDGE_HASH_SIZE];
+                uint32_t                        _bridgeRetry = 0;
             #endif
 
             class BlinkerData *             _Data[BLINKER_MAX_BLINKER_DATA_SIZE];
@@ -701,6 +778,7 @@ class BlinkerApi : public BlinkerProtocol
             bool            _isRegistered = false;
             uint32_t        _register_fresh = 0;
             uint32_t        _initTime;
+            BlinkerBoot     _boot;
             #if defined(BLINKER_PRO) || defined(BLINKER_PRO_ESP)
                 BlinkerStatus_t _proStatus = PRO_WLAN_CONNECTING;
             #elif defined(BLINKER_MQTT_AUTO)
@@ -793,8 +871,8 @@ class BlinkerApi : public BlinkerProtocol
 
             // #if !defined(BLINKER_AT_MQTT)
             blinker_callback_t                  _dataStorageFunc = NULL;
+            int8_t                              _dataStorageTask = BLINKER_OBJECT_NOT_AVAIL;
             uint32_t                            _autoStorageTime = 60;
-            uint32_t                            _autoDataTime = 0;
             uint8_t                             _dataTimes = BLINKER_MAX_DATA_COUNT;
             // #endif
 
@@ -804,26 +882,46 @@ class BlinkerApi : public BlinkerProtocol
             // char*                               _LowPowerData;
             blinker_callback_t                  _sleepFunc = NULL;
             #endif
+
+            #if defined(BLINKER_LOWPOWER_AIR202)
+            BlinkerRetain                       _retain;
+            #endif
         #endif
 
         #if defined(BLINKER_GATEWAY)
             blinker_callback_return_int_t       _gatewayAvail = NULL;
             blinker_callback_return_string_t    _gatewayRead = NULL;
             blinker_callback_with_string_arg_t  _gatewayPrint = NULL;
+            uint8_t                             _subCount = 0;
+            uint8_t                             _subTable[BLINKER_SUB_DEVICE_HASH_SIZE];
+            class BlinkerSubNode *              _SubNode[BLINKER_MAX_SUB_DEVICE_SIZE];
+
+            int8_t subDeviceFind(const char * _ns);
+            void gatewayRun();
+            void gatewayRead(const String & data);
+            void gatewayParse(const JsonObject& data);
+            bool gatewaySend(uint8_t id, const String & data, uint8_t magic = BLINKER_FRAME_MAGIC);
         #endif
 
         #if defined(BLINKER_MQTT_AT) || defined(BLINKER_NB73_NBIOT)
-            class BlinkerMasterAT *         _masterAT;
+            class BlinkerMasterAT *         _masterAT = NULL;
             void atRespOK(const String & _data, uint32_t timeout = BLINKER_STREAM_TIMEOUT*10);
             // void initCheck(const String & _data, uint32_t timeout = BLINKER_STREAM_TIMEOUT*10);
         #endif
 
+        uint16_t                            _shadowEpoch = 0;
+        #if defined(BLINKER_SNAPSHOT)
+            BlinkerSnapshot                 _snapshot;
+            bool                            _snapHold = false;
+            void snapMerge();
+        #endif
         blinker_callback_t                  _heartbeatFunc = NULL;
         blinker_callback_return_string_t    _summaryFunc = NULL;
 
         void parse(char _data[], bool ex_data = false);
 
         #if defined(BLINKER_ARDUINOJSON)
+            void objectParse(JsonObject& root);
             int16_t ahrs(b_ahrsattitude_t attitude, const JsonObject& data);
             float gps(b_gps_t axis, const JsonObject& data);
 
@@ -838,7 +936,7 @@ class BlinkerApi : public BlinkerProtocol
             #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
                 defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
                 defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
-                void bridgeParse(char _bName[], const JsonObject& data);
+                void bridgeParse(const JsonObject& data);
             #endif
             void strWidgetsParse(char _wName[], const JsonObject& data);
             #if defined(BLINKER_BLE)
@@ -850,22 +948,22 @@ class BlinkerApi : public BlinkerProtocol
 
             void json_parse(const JsonObject& data);
         #else
-            int16_t ahrs(b_ahrsattitude_t attitude, char data[]);
-            float gps(b_gps_t axis, char data[]);
+            int16_t ahrs(b_ahrsattitude_t attitude, const BlinkerToken& data);
+            float gps(b_gps_t axis, const BlinkerToken& data);
 
-            void heartBeat(char data[]);
-            void getVersion(char data[]);
-            void setSwitch(char data[]);
+            void heartBeat(const BlinkerToken& data);
+            void getVersion(const BlinkerToken& data);
+            void setSwitch(const BlinkerToken& data);
 
-            void strWidgetsParse(char _wName[], char _data[]);
+            void strWidgetsParse(char _wName[], const BlinkerToken& data);
             #if defined(BLINKER_BLE)
-                void joyWidgetsParse(char _wName[], char _data[]);
+                void joyWidgetsParse(char _wName[], const BlinkerToken& data);
             #endif
-            void rgbWidgetsParse(char _wName[], char _data[]);
-            void intWidgetsParse(char _wName[], char _data[]);
-            void tabWidgetsParse(char _wName[], char _data[]);
+            void rgbWidgetsParse(char _wName[], const BlinkerToken& data);
+            void intWidgetsParse(char _wName[], const BlinkerToken& data);
+            void tabWidgetsParse(char _wName[], const BlinkerToken& data);
 
-            void json_parse(char _data[]);
+            void json_parse(const BlinkerToken& data);
         #endif
 
         #if defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
@@ -890,6 +988,9 @@ class BlinkerApi : public BlinkerProtocol
                     BLINKER_LOG_ALL(BLINKER_F("Current time: "), asctime(&timeinfo));
                     BLINKER_LOG_ALL(BLINKER_F("NTP time: "), BLINKER_AIR202._ntpTime - (int)(_timezone*3600));
 
+                    // no second query on the first time lookup
+                    _clock.sync(BLINKER_AIR202._ntpTime);
+
                     _isNTPInit = true;
 
                     return true;
@@ -1216,7 +1317,7 @@ class BlinkerApi : public BlinkerProtocol
 
                     BLINKER_LOG_ALL(payload);
 
-                    DynamicJsonBuffer jsonBuffer;
+                    BlinkerJsonBuffer jsonBuffer;
                     JsonObject& data_rp = jsonBuffer.parseObject(payload);
 
                     if (data_rp.success())
@@ -1659,7 +1760,7 @@ class BlinkerApi : public BlinkerProtocol
 
                     BLINKER_LOG_ALL(payload);
 
-                    DynamicJsonBuffer jsonBuffer;
+                    BlinkerJsonBuffer jsonBuffer;
                     JsonObject& data_rp = jsonBuffer.parseObject(payload);
 
                     if (data_rp.success())
@@ -1851,8 +1952,9 @@ class BlinkerApi : public BlinkerProtocol
 
             #endif
 
-            uint32_t ntpFreshTime = 0;
-            time_t ntpGetTime = 0;
+            BlinkerClock _clock;
+
+            bool freshTime();
         #endif
 
         #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
@@ -1870,7 +1972,7 @@ class BlinkerApi : public BlinkerProtocol
             blinker_at_dueros_t     _duerType = DUER_NONE;
             uint8_t                 _wlanMode = BLINKER_CMD_COMCONFIG_NUM;
             uint8_t                 pinDataNum = 0;
-            class BlinkerSlaverAT * _slaverAT;
+            class BlinkerSlaverAT * _slaverAT = NULL;
             class PinData *         _pinData[BLINKER_MAX_PIN_NUM];
 
             void parseATdata();
@@ -2213,6 +2315,7 @@ void BlinkerApi::needInit()
         reqData += BProto::uuid();
         BProto::serialPrint(reqData);
         BProto::serialPrint(BLINKER_CMD_OK);
+        BProto::serialFlush();
     #endif
 }
 
@@ -2297,6 +2400,20 @@ void BlinkerApi::needInit()
 
 void BlinkerApi::run()
 {
+    #if defined(BLINKER_LOG_DEFERRED)
+        BLINKER_DEBUG.logFlush();
+    #endif
+
+    uint32_t _loopNow = micros();
+    if (_loopTime && (_loopNow - _loopTime) > _loopMax) _loopMax = _loopNow - _loopTime;
+    _loopTime = _loopNow;
+
+    BLINKER_PROFILE_BEGIN();
+
+    _scheduler.run(BLINKER_TASK_BUDGET);
+
+    BLINKER_PROFILE_MARK(PROF_TASK);
+
     // #if defined(BLINKER_LOWPOWER_AIR202)
     //     ::delay(10);
     // #else
@@ -2347,6 +2464,7 @@ void BlinkerApi::run()
                 if (!_isConnBegin)
                 {
                     _proStatus = PRO_WLAN_CONNECTED;
+                    _boot.done(BOOT_WLAN);
 
                     // if (checkCanOTA()) loadOTA();
 
@@ -2360,6 +2478,13 @@ void BlinkerApi::run()
 
                     BLINKER_LOG_ALL(BLINKER_F("conn begin, fresh _initTime: "), _initTime);
 
+                    // sntp answers in the background while the registration blocks
+                    _boot.start(BOOT_NTP);
+                    _ntpStart = millis();
+                    ntpConfig();
+
+                    _boot.start(BOOT_REGISTER);
+
                     // loadOTA();
 
                     if (BProto::authCheck())
@@ -2427,6 +2552,12 @@ void BlinkerApi::run()
             }
             else
             {
+                if (!_boot.isDone(BOOT_REGISTER))
+                {
+                    _boot.done(BOOT_REGISTER);
+                    _boot.start(BOOT_MQTT);
+                }
+
                 if (!_isInit)
                 {
                     if (ntpInit())
@@ -2436,11 +2567,6 @@ void BlinkerApi::run()
                         // strcpy(_deviceName, conn.deviceName());
                         _proStatus = PRO_DEV_INIT_SUCCESS;
 
-                        uint32_t connect_time = millis();
-                        uint32_t time_slot = 0;
-
-                        if (checkCanOTA()) loadOTA();
-
                         if (_needInit == false)
                         {
                             _needInit = true;
@@ -2450,19 +2576,6 @@ void BlinkerApi::run()
                                 break;
                             #endif
                         }
-
-                        while (time_slot < 30000)
-                        {
-                            time_slot = millis() - connect_time;
-                            BProto::connect();
-                            yield();
-
-                            if (BProto::mConnected())
-                            {
-                                state = CONNECTED;
-                                break;
-                            }
-                        }
                         // BProto::sharers(freshSharers());
                     }
                 }
@@ -2477,6 +2590,22 @@ void BlinkerApi::run()
                     else if (state == DISCONNECTED && _proStatus != PRO_DEV_DISCONNECTED) {
                         _proStatus = PRO_DEV_DISCONNECTED;
                     }
+
+                    // ota check only once mqtt is up, it used to hold it back
+                    if (!_boot.isDone(BOOT_MQTT) && BProto::mConnected())
+                    {
+                        _boot.done(BOOT_MQTT);
+                    }
+
+                    if (_boot.ready(BOOT_OTA))
+                    {
+                        _boot.start(BOOT_OTA);
+
+                        if (checkCanOTA()) loadOTA();
+
+                        _boot.done(BOOT_OTA);
+                        _boot.report();
+                    }
                 }
             }
 
@@ -2504,6 +2633,7 @@ void BlinkerApi::run()
                 if (!_isConnBegin)
                 {
                     _mqttAutoStatue = AUTO_WLAN_CONNECTED;
+                    _boot.done(BOOT_WLAN);
 
                     // if (checkCanOTA()) loadOTA();
 
@@ -2514,6 +2644,13 @@ void BlinkerApi::run()
 
                     BLINKER_LOG_ALL(BLINKER_F("conn begin, fresh _initTime: "), _initTime);
 
+                    // sntp answers in the background while the registration blocks
+                    _boot.start(BOOT_NTP);
+                    _ntpStart = millis();
+                    ntpConfig();
+
+                    _boot.start(BOOT_REGISTER);
+
                     // if (_getRegister) _isConnBegin = true;
                     // loadOTA();
 
@@ -2587,6 +2724,12 @@ void BlinkerApi::run()
             }
             else// (BProto::init())
             {
+                if (!_boot.isDone(BOOT_REGISTER))
+                {
+                    _boot.done(BOOT_REGISTER);
+                    _boot.start(BOOT_MQTT);
+                }
+
                 if (!_isInit)
                 {
                     BLINKER_LOG_ALL(BLINKER_F("ntpInit"));
@@ -2597,13 +2740,6 @@ void BlinkerApi::run()
                         // strcpy(_deviceName, conn.deviceName());
                         _mqttAutoStatue = AUTO_DEV_INIT_SUCCESS;
 
-                        uint32_t connect_time = millis();
-                        uint32_t time_slot = 0;
-
-                        BLINKER_LOG_ALL(BLINKER_F("checkCanOTA"));
-
-                        if (checkCanOTA()) loadOTA();
-
                         if (_needInit == false)
                         {
                             _needInit = true;
@@ -2613,19 +2749,6 @@ void BlinkerApi::run()
                                 break;
                             #endif
                         }
-
-                        while (time_slot < 30000)
-                        {
-                            time_slot = millis() - connect_time;
-                            BProto::connect();
-                            yield();
-
-                            if (BProto::mConnected())
-                            {
-                                state = CONNECTED;
-                                break;
-                            }
-                        }
                         // BProto::sharers(freshSharers());
                     }
                 }
@@ -2640,14 +2763,32 @@ void BlinkerApi::run()
                     else if (state == DISCONNECTED && _mqttAutoStatue != AUTO_DEV_DISCONNECTED) {
                         _mqttAutoStatue = AUTO_DEV_DISCONNECTED;
                     }
+
+                    // ota check only once mqtt is up, it used to hold it back
+                    if (!_boot.isDone(BOOT_MQTT) && BProto::mConnected())
+                    {
+                        _boot.done(BOOT_MQTT);
+                    }
+
+                    if (_boot.ready(BOOT_OTA))
+                    {
+                        _boot.start(BOOT_OTA);
+
+                        if (checkCanOTA()) loadOTA();
+
+                        _boot.done(BOOT_OTA);
+                        _boot.report();
+                    }
                 }
             }
         #endif
 
         #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
             defined(BLINKER_PRO_ESP)
-            ntpInit();
+            if (ntpInit()) _boot.done(BOOT_NTP);
+            BLINKER_PROFILE_MARK(PROF_LINK);
             checkTimer();
+            BLINKER_PROFILE_MARK(PROF_TIMER);
 
             if (WiFi.status() != WL_CONNECTED)
             {
@@ -2658,6 +2799,11 @@ void BlinkerApi::run()
         #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
             defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY)
             checkTimer();
+            #if defined(BLINKER_AT_MQTT)
+                // timer actions reach the host now, not with the next reply
+                BProto::serialFlush();
+            #endif
+            BLINKER_PROFILE_MARK(PROF_TIMER);
 
             if (!BProto::init()) {
                 ::delay(2000);
@@ -2676,9 +2822,6 @@ void BlinkerApi::run()
                     _isInit =true;
                     _disconnectTime = millis();
 
-                    uint32_t connect_time = millis();
-                    uint32_t time_slot = 0;
-
                     bridgeInit();
 
                     if (checkCanOTA()) loadOTA();
@@ -2693,21 +2836,6 @@ void BlinkerApi::run()
                         #endif
                     }
 
-                    while (time_slot < 30000)
-                    {
-                        time_slot = millis() - connect_time;
-                        BProto::connect();
-                        yield();
-
-                        if (BProto::mConnected())
-                        {
-                            state = CONNECTED;
-                            break;
-                        }
-                    }
-
-                    BLINKER_LOG_ALL(BLINKER_F("millis: "), millis(),
-                                    BLINKER_F(", connect_time: "), connect_time);
                     // BProto::sharers(freshSharers());
 
                     BLINKER_LOG_ALL(BLINKER_F("MQTT conn init success"));
@@ -2828,9 +2956,6 @@ void BlinkerApi::run()
                         _isInit = true;
                         _gprsStatus = GPRS_DEV_INIT_SUCCESS;
 
-                        uint32_t connect_time = millis();
-                        uint32_t time_slot = 0;
-
                         if (_needInit == false)
                         {
                             _needInit = true;
@@ -2840,19 +2965,6 @@ void BlinkerApi::run()
                                 return;
                             #endif
                         }
-
-                        while (time_slot < 30000)
-                        {
-                            time_slot = millis() - connect_time;
-                            BProto::connect();
-                            yield();
-
-                            if (BProto::mConnected())
-                            {
-                                state = CONNECTED;
-                                break;
-                            }
-                        }
                     }
                 }
                 else
@@ -2898,9 +3010,20 @@ void BlinkerApi::run()
 
                     //     BLINKER_LOG_ALL(BLINKER_F("is auth, conn deviceRegister"));
 
-                        _isRegistered = BProto::deviceRegister();
+                        if (_retain.load() && _retain.hasAuth())
+                        {
+                            _isRegistered = BProto::restore(_retain.authKey(), _retain.deviceName());
+                        }
+                        else
+                        {
+                            _isRegistered = BProto::deviceRegister();
+
+                            if (_isRegistered) _retain.keepAuth(BProto::authKey(), BProto::deviceName());
+                        }
                         _getRegister = true;
 
+                        _retain.mark(LP_PHASE_CONNECT);
+
                         if (!_isRegistered)
                         {
                             _register_fresh = millis();
@@ -2945,6 +3068,8 @@ void BlinkerApi::run()
                     else
                     {
                         _gprsStatus = GPRS_DEV_REGISTER_SUCCESS;
+
+                        _retain.keepAuth(BProto::authKey(), BProto::deviceName());
                     }
 
                     _registerTimes++;
@@ -2956,12 +3081,11 @@ void BlinkerApi::run()
                 {
                     if (ntpInit()) //TBD
                     {
+                        _retain.mark(LP_PHASE_NTP);
+
                         _isInit = true;
                         _gprsStatus = GPRS_DEV_INIT_SUCCESS;
 
-                        uint32_t connect_time = millis();
-                        uint32_t time_slot = 0;
-
                         if (_needInit == false)
                         {
                             _needInit = true;
@@ -2971,19 +3095,6 @@ void BlinkerApi::run()
                                 return;
                             #endif
                         }
-
-                        while (time_slot < 30000)
-                        {
-                            time_slot = millis() - connect_time;
-                            BProto::connect();
-                            yield();
-
-                            if (BProto::connected())
-                            {
-                                state = CONNECTED;
-                                break;
-                            }
-                        }
                     }
                 }
                 else
@@ -3153,9 +3264,6 @@ void BlinkerApi::run()
                         _isInit = true;
                         _nbiotStatus = NBIOT_DEV_INIT_SUCCESS;
 
-                        uint32_t connect_time = millis();
-                        uint32_t time_slot = 0;
-
                         if (_needInit == false)
                         {
                             _needInit = true;
@@ -3165,19 +3273,6 @@ void BlinkerApi::run()
                                 return;
                             #endif
                         }
-
-                        while (time_slot < 30000)
-                        {
-                            time_slot = millis() - connect_time;
-                            BProto::connect();
-                            yield();
-
-                            if (BProto::mConnected())
-                            {
-                                state = CONNECTED;
-                                break;
-                            }
-                        }
                     }
                 }
                 else
@@ -3201,7 +3296,7 @@ void BlinkerApi::run()
 
             char _lp_data_get[1024];
             strcpy(_lp_data_get, comDataGet().c_str());
-            if (_lp_data_get == BLINKER_CMD_FALSE) strcpy(_lp_data_get, "");
+            if (strcmp(_lp_data_get, BLINKER_CMD_FALSE) == 0) strcpy(_lp_data_get, "");
             else if (strcmp(_lp_data_get, "{}") == 0) strcpy(_lp_data_get, "");
             else
             {
@@ -3218,12 +3313,39 @@ void BlinkerApi::run()
                 }
             }
 
+            #if defined(BLINKER_LOWPOWER_AIR202)
+                _retain.mark(LP_PHASE_GET);
+
+                // what the last wake failed to upload goes out with this one,
+                // newer values of the same keys replace it
+                if (strlen(_retain.pending()))
+                {
+                    BProto::checkFormat();
+                    if (!strlen(BProto::_sendBuf)) strcpy(BProto::_sendBuf, _retain.pending());
+                }
+            #endif
+
             if (_LowPowerFunc) _LowPowerFunc();
 
-            if (strlen(BProto::_sendBuf))
+            #if defined(BLINKER_LOWPOWER_AIR202)
+                _retain.mark(LP_PHASE_USER);
+            #endif
+
+            if (BProto::autoFormat && strlen(BProto::_sendBuf))
             {
-                if (!comDateUpdate()) comDateUpdate();
+                bool _upload = comDateUpdate() || comDateUpdate();
+
+                #if defined(BLINKER_LOWPOWER_AIR202)
+                    _retain.uploaded(_upload, BProto::_sendBuf);
+                #endif
             }
+
+            #if defined(BLINKER_LOWPOWER_AIR202)
+                _retain.mark(LP_PHASE_UPLOAD);
+                _retain.save();
+                _retain.report();
+            #endif
+
             // ::delay(60000); // sleep func TBD
             if (_sleepFunc) _sleepFunc();
             return;
@@ -3291,12 +3413,19 @@ void BlinkerApi::run()
             case CONNECTED :
                 if (conState)
                 {
+                    BLINKER_PROFILE_MARK(PROF_LINK);
+
                     BProto::checkAvail();
                     if (BProto::isAvail)
                     {
+                        BLINKER_PROFILE_MSG(BProto::lastRead());
                         parse(BProto::dataParse());
                     }
 
+                    #if defined(BLINKER_GATEWAY)
+                        gatewayRun();
+                    #endif
+
                     #if (defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
                         defined(BLINKER_GATEWAY)) || defined(BLINKER_MQTT_AUTO) || \
                         defined(BLINKER_PRO_ESP)
@@ -3363,8 +3492,12 @@ void BlinkerApi::run()
                         {
                             BProto::serialPrint(BProto::lastRead());
                         }
+
+                        BProto::serialFlush();
                     #endif
 
+                    BLINKER_PROFILE_MARK(PROF_PARSE);
+
                     if (BProto::availState)
                     {
                         BProto::availState = false;
@@ -3376,6 +3509,8 @@ void BlinkerApi::run()
                         }
                     }
 
+                    BLINKER_PROFILE_MARK(PROF_USER);
+
                     #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
                         defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
                         defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
@@ -3431,6 +3566,8 @@ void BlinkerApi::run()
                 break;
         }
 
+        BLINKER_PROFILE_MARK(PROF_LINK);
+
         #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
             defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
             defined(BLINKER_GPRS_AIR202) || defined(BLINKER_NBIOT_SIM7020) || \
@@ -3450,15 +3587,6 @@ void BlinkerApi::run()
             #endif
 
             // #if !defined(BLINKER_AT_MQTT)
-            if (_dataStorageFunc)
-            {
-                if (millis() - _autoDataTime >= _autoStorageTime * 1000)
-                {
-                    _dataStorageFunc();
-                    _autoDataTime += _autoStorageTime * 1000;
-                }
-            }
-
             if (millis() - _autoUpdateTime >= _autoStorageTime * _dataTimes * 1000)
             {
                 if (data_dataCount && _isInit)// && ESP.getFreeHeap() > 4000)
@@ -3511,10 +3639,85 @@ void BlinkerApi::run()
             // #endif
         #endif
 
+        BLINKER_PROFILE_MARK(PROF_AUTO);
+
+        #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+            defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
+            defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
+            if (state == CONNECTED) bridgeFlush();
+        #endif
+
         BProto::checkAutoFormat();
+
+        BLINKER_PROFILE_MARK(PROF_FLUSH);
     // #endif
 }
 
+#if defined(BLINKER_ARDUINOJSON)
+void BlinkerApi::objectParse(JsonObject& root)
+{
+    #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
+        defined(BLINKER_PRO_ESP)
+        checkRegister(root);
+    #endif
+
+    // #if defined(BLINKER_MQTT) || defined(BLINKER_PRO)
+
+    #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
+        defined(BLINKER_PRO) || defined(BLINKER_AT_MQTT) || \
+        defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+        defined(BLINKER_PRO_ESP)
+        timerManager(root);
+        // BLINKER_LOG_ALL(BLINKER_F("timerManager"));
+    #endif
+
+    #if defined(BLINKER_GPRS_AIR202)
+        shareParse(root);
+    #endif
+
+    #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+        defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
+        defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
+        autoManager(root);
+        otaParse(root);
+        shareParse(root);
+        numParse(root);
+
+        bridgeParse(root);
+    #endif
+
+    #if defined(BLINKER_GATEWAY)
+        gatewayParse(root);
+    #endif
+
+    heartBeat(root);
+    getVersion(root);
+
+    json_parse(root);
+
+    ahrs(Yaw, root);
+    gps(LONG, root);
+
+    #if defined(BLINKER_SUBDEVICE)
+        broadCast(root);
+    #endif
+
+    if (!_fresh)
+    {
+        #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
+            defined(BLINKER_PRO_ESP)
+            if (_parseFunc) {
+                if(_parseFunc(root)) {
+                    _fresh = true;
+                }
+
+                BLINKER_LOG_ALL(BLINKER_F("run parse callback function"));
+            }
+        #endif
+    }
+}
+#endif
+
 void BlinkerApi::parse(char _data[], bool ex_data)
 {
     BLINKER_LOG_ALL(BLINKER_F("parse data: "), _data);
@@ -3528,8 +3731,24 @@ void BlinkerApi::parse(char _data[], bool ex_data)
             #if defined(BLINKER_ARDUINOJSON)
                 BLINKER_LOG_ALL(BLINKER_F("defined BLINKER_ARDUINOJSON"));
 
-                DynamicJsonBuffer jsonBuffer;
-                JsonObject& root = jsonBuffer.parseObject(STRING_format(_data));
+                #if defined(BLINKER_MQTT)
+                    // already parsed in place by the adapter, no second parse
+                    JsonObject * _object = BProto::dataObject();
+
+                    if (_object)
+                    {
+                        BProto::dataHold(true);
+                        objectParse(*_object);
+                        BProto::dataHold(false);
+
+                        if (_fresh) BProto::isParsed();
+
+                        return;
+                    }
+                #endif
+
+                BlinkerJsonBuffer jsonBuffer;
+                JsonObject& root = jsonBuffer.parseObject((const char *)_data);
 
                 if (!root.success())
                 {
@@ -3539,50 +3758,7 @@ void BlinkerApi::parse(char _data[], bool ex_data)
                     return;
                 }
 
-                #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
-                    defined(BLINKER_PRO_ESP)
-                    checkRegister(root);
-                #endif
-
-                // #if defined(BLINKER_MQTT) || defined(BLINKER_PRO)
-
-                #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
-                    defined(BLINKER_PRO) || defined(BLINKER_AT_MQTT) || \
-                    defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
-                    defined(BLINKER_PRO_ESP)
-                    timerManager(root);
-                    // BLINKER_LOG_ALL(BLINKER_F("timerManager"));
-                #endif
-
-                #if defined(BLINKER_GPRS_AIR202)
-                    shareParse(root);
-                #endif
-
-                #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
-                    defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
-                    defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
-                    autoManager(root);
-                    otaParse(root);
-                    shareParse(root);
-                    numParse(root);
-
-                    for (uint8_t bNum = 0; bNum < _bridgeCount; bNum++)
-                    {
-                        bridgeParse(_Bridge[bNum]->getName(), root);
-                    }
-                #endif
-
-                heartBeat(root);
-                getVersion(root);
-
-                json_parse(root);
-
-                ahrs(Yaw, root);
-                gps(LONG, root);
-
-                #if defined(BLINKER_SUBDEVICE)
-                    broadCast(root);
-                #endif
+                objectParse(root);
             #else
                 BLINKER_LOG_ALL(BLINKER_F("ndef BLINKER_ARDUINOJSON"));
 
@@ -3594,33 +3770,21 @@ void BlinkerApi::parse(char _data[], bool ex_data)
                         return;
                 #endif
 
-                heartBeat(_data);
-                getVersion(_data);
+                BlinkerToken root(_data);
+
+                heartBeat(root);
+                getVersion(root);
 
-                json_parse(_data);
+                json_parse(root);
 
-                ahrs(Yaw, _data);
-                gps(LONG, _data);
+                ahrs(Yaw, root);
+                gps(LONG, root);
             #endif
 
             if (_fresh)
             {
                 BProto::isParsed();
             }
-            else
-            {
-                #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
-                    defined(BLINKER_PRO_ESP)
-                    if (_parseFunc) {
-                        if(_parseFunc(root)) {
-                            _fresh = true;
-                            BProto::isParsed();
-                        }
-
-                        BLINKER_LOG_ALL(BLINKER_F("run parse callback function"));
-                    }
-                #endif
-            }
         }
     }
     else
@@ -3629,59 +3793,54 @@ void BlinkerApi::parse(char _data[], bool ex_data)
             String arrayData = BLINKER_F("{\"data\":");
             arrayData += _data;
             arrayData += BLINKER_F("}");
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& root = jsonBuffer.parseObject(arrayData);
 
             if (!root.success()) return;
 
-            arrayData = root["data"][0].as<String>();
-
-            if (arrayData.length())
+            // walk the parsed elements, no need to print and parse each again
+            if (root["data"].is<JsonArray>())
             {
-                for (uint8_t a_num = 0; a_num < BLINKER_MAX_WIDGET_SIZE; a_num++)
+                JsonArray& dataArray = root["data"];
+                uint8_t a_num = 0;
+
+                for (JsonArray::iterator it = dataArray.begin(); \
+                    it != dataArray.end() && a_num < BLINKER_MAX_WIDGET_SIZE; ++it, a_num++)
                 {
-                    arrayData = root["data"][a_num].as<String>();
+                    if (!it->is<JsonObject>()) return;
 
-                    if(arrayData.length()) {
-                        DynamicJsonBuffer _jsonBuffer;
-                        JsonObject& _array = _jsonBuffer.parseObject(arrayData);
+                    JsonObject& _array = it->as<JsonObject>();
 
-                        json_parse(_array);
-                        #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
-                            defined(BLINKER_PRO) || defined(BLINKER_AT_MQTT) || \
-                            defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
-                            defined(BLINKER_PRO_ESP)
-                            timerManager(_array, true);
-                        #endif
-
-                        #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
-                            defined(BLINKER_PRO_ESP)
-                            if (_parseFunc) {
-                                if(_parseFunc(_array)) {
-                                    // _fresh = true;
-                                    // BProto::isParsed();
-                                }
+                    json_parse(_array);
+                    #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
+                        defined(BLINKER_PRO) || defined(BLINKER_AT_MQTT) || \
+                        defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+                        defined(BLINKER_PRO_ESP)
+                        timerManager(_array, true);
+                    #endif
 
-                                BLINKER_LOG_ALL(BLINKER_F("run parse callback function"));
+                    #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
+                        defined(BLINKER_PRO_ESP)
+                        if (_parseFunc) {
+                            if(_parseFunc(_array)) {
+                                // _fresh = true;
+                                // BProto::isParsed();
                             }
-                        #endif
-                    }
-                    else {
-                        return;
-                    }
+
+                            BLINKER_LOG_ALL(BLINKER_F("run parse callback function"));
+                        }
+                    #endif
                 }
             }
-            else {
-                JsonObject& root = jsonBuffer.parseObject(_data);
-
-                if (!root.success()) return;
+            else if (root["data"].is<JsonObject>()) {
+                JsonObject& dataObject = root["data"];
 
-                json_parse(root);
+                json_parse(dataObject);
 
                 #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
                     defined(BLINKER_PRO_ESP)
                     if (_parseFunc) {
-                        if(_parseFunc(root)) {
+                        if(_parseFunc(dataObject)) {
                             // _fresh = true;
                             // BProto::isParsed();
                         }
@@ -3691,7 +3850,9 @@ void BlinkerApi::parse(char _data[], bool ex_data)
                 #endif
             }
         #else
-            json_parse(_data);
+            BlinkerToken root(_data);
+
+            json_parse(root);
         #endif
     }
 }
@@ -3748,6 +3909,12 @@ void BlinkerApi::printArray(T1 n1, const String &s2)
     _msg += BLINKER_F("\":");
     _msg += s2;
 
+    #if defined(BLINKER_SNAPSHOT)
+        _snapshot.update(STRING_format(n1), s2);
+
+        if (_snapHold) return;
+    #endif
+
     // checkFormat();
     // autoFormatData(STRING_format(n1), _msg);
     // autoFormatFreshTime = millis();
@@ -3940,81 +4107,74 @@ void BlinkerApi::vibrate(uint16_t ms)
 
 void BlinkerApi::delay(unsigned long ms)
 {
-    uint32_t start = micros();
-    uint32_t __start = millis();
-    unsigned long _ms = ms;
-    while (ms > 0)
+    uint32_t start = millis();
+
+    while ((millis() - start) < ms)
     {
         run();
-
-        if ((micros() - start) >= 1000)
-        {
-            ms -= 1;
-            start += 1000;
-        }
-
-        if ((millis() - __start) >= _ms)
-        {
-            ms = 0;
-        }
-
         yield();
     }
 }
 
+#if defined(BLINKER_SENSOR_STREAM)
+void BlinkerApi::attachAhrs(uint8_t freq)
+{
+    _ahrsFreq = freq > BLINKER_SENSOR_FREQ_MAX ? BLINKER_SENSOR_FREQ_MAX : freq;
+    _ahrsNum = BLINKER_SENSOR.ahrsNum();
+
+    ahrsRequest();
+}
+#else
 void BlinkerApi::attachAhrs()
 {
-    bool state = false;
-    uint32_t startTime = millis();
+    ahrsRequest();
+}
+#endif
+
+// no blocking here, ahrsTask asks again until the app answers
+void BlinkerApi::ahrsRequest()
+{
     print(BLINKER_CMD_AHRS, BLINKER_CMD_ON);
-    while (!state)
+
+    #if defined(BLINKER_SENSOR_STREAM)
+        print(BLINKER_CMD_FREQ, _ahrsFreq);
+    #endif
+
+    _ahrsWait = true;
+
+    if (_ahrsTask == BLINKER_OBJECT_NOT_AVAIL)
     {
-        while (!BProto::connected())
-        {
-            run();
-            if (BProto::connect())
-            {
-                print(BLINKER_CMD_AHRS, BLINKER_CMD_ON);
-                BProto::printNow();
-                break;
-            }
-        }
+        _ahrsTask = _scheduler.attach(ahrsTask, this, BLINKER_CONNECT_TIMEOUT_MS, BLINKER_CONNECT_TIMEOUT_MS);
+    }
+}
 
-        ::delay(100);
+void BlinkerApi::ahrsTask(void * arg)
+{
+    BlinkerApi * api = (BlinkerApi *)arg;
 
-        if (BProto::checkAvail())
-        {
-            if (STRING_contains_string(BProto::dataParse(), BLINKER_CMD_AHRS))
-            {
-                BLINKER_LOG(BLINKER_F("AHRS attach sucessed..."));
-                // parse(BProto::dataParse());
-                state = true;
-                break;
-            }
-            else
-            {
-                BLINKER_LOG(BLINKER_F("AHRS attach failed...Try again"));
-                startTime = millis();
-                // parse(BProto::dataParse());
-                print(BLINKER_CMD_AHRS, BLINKER_CMD_ON);
-                BProto::printNow();
-            }
-        }
-        else
+    #if defined(BLINKER_SENSOR_STREAM)
+        if (api->_ahrsWait && BLINKER_SENSOR.ahrsNum() != api->_ahrsNum)
         {
-            if (millis() - startTime > BLINKER_CONNECT_TIMEOUT_MS)
-            {
-                BLINKER_LOG(BLINKER_F("AHRS attach failed...Try again"));
-                startTime = millis();
-                print(BLINKER_CMD_AHRS, BLINKER_CMD_ON);
-                BProto::printNow();
-            }
+            BLINKER_LOG(BLINKER_F("AHRS attach sucessed..."));
+            api->_ahrsWait = false;
         }
+    #endif
+
+    if (!api->_ahrsWait)
+    {
+        api->_scheduler.detach(api->_ahrsTask);
+        api->_ahrsTask = BLINKER_OBJECT_NOT_AVAIL;
+    }
+    else if (api->state == CONNECTED)
+    {
+        BLINKER_LOG(BLINKER_F("AHRS attach failed...Try again"));
+        api->ahrsRequest();
     }
 }
 
 void BlinkerApi::detachAhrs()
 {
+    _ahrsWait = false;
     print(BLINKER_CMD_AHRS, BLINKER_CMD_OFF);
     ahrsValue[Yaw] = 0;
     ahrsValue[Roll] = 0;
@@ -4023,6 +4183,14 @@ void BlinkerApi::detachAhrs()
 
 float BlinkerApi::gps(b_gps_t axis)
 {
+    #if defined(BLINKER_SENSOR_STREAM)
+        if (BLINKER_SENSOR.gpsFresh() && \
+            (millis() - BLINKER_SENSOR.gpsFresh()) < BLINKER_GPS_MSG_LIMIT)
+        {
+            return BLINKER_SENSOR.gps(axis);
+        }
+    #endif
+
     if ((millis() - gps_get_time) >= BLINKER_GPS_MSG_LIMIT || \
         gps_get_time == 0)
     {
@@ -4044,657 +4212,135 @@ float BlinkerApi::gps(b_gps_t axis)
     {
         _timezone = tz;
         _isNTPInit = false;
+        _clock.reset();
     }
 
-    int8_t BlinkerApi::second()
+    // read the time source only when the local clock is due for a sync
+    bool BlinkerApi::freshTime()
     {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                BLINKER_LOG_ALL("(millis() - ntpFreshTime): ", (millis() - ntpFreshTime));
-                BLINKER_LOG_ALL("ntpGetTime: ", ntpGetTime);
-                BLINKER_LOG_ALL((ntpGetTime == 0 || (millis() - ntpFreshTime) >= 600000));
+        if (!_isNTPInit) return false;
 
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
+        if (!_clock.needSync()) return _clock.synced();
 
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
+        #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
+            !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
+            !defined(BLINKER_LOWPOWER_AIR202))
+            time_t now_ntp = ::time(nullptr);
+        #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
+            BlinkerSIM7020 BLINKER_SIM7020;
+            BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
+            if (!BLINKER_SIM7020.getSNTP(_timezone))
+            {
+                _clock.miss();
+                return _clock.synced();
             }
-            else
+            time_t now_ntp = BLINKER_SIM7020._ntpTime;
+        #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
+            defined(BLINKER_LOWPOWER_AIR202)
+            BlinkerAIR202 BLINKER_AIR202;
+            BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
+            // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
+            if (!BLINKER_AIR202.getNTP())
             {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
+                _clock.miss();
+                return _clock.synced();
             }
+            time_t now_ntp = BLINKER_AIR202._ntpTime;
+        #endif
 
-            struct tm timeinfo;
+        BLINKER_LOG_ALL(BLINKER_F("time sync: "), now_ntp);
 
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
+        _clock.sync(now_ntp);
 
-            return timeinfo.tm_sec;
-        }
-        return -1;
+        return true;
     }
-    /**< seconds after the minute - [ 0 to 59 ] */
 
-    int8_t BlinkerApi::minute()
+    int8_t BlinkerApi::second()
     {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
+        if (!freshTime()) return -1;
 
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
+        return _clock.civil().tm_sec;
+    }
+    /**< seconds after the minute - [ 0 to 59 ] */
 
-            struct tm timeinfo;
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
+    int8_t BlinkerApi::minute()
+    {
+        if (!freshTime()) return -1;
 
-            return timeinfo.tm_min;
-        }
-        return -1;
+        return _clock.civil().tm_min;
     }
     /**< minutes after the hour - [ 0 to 59 ] */
 
     int8_t BlinkerApi::hour()
     {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
+        if (!freshTime()) return -1;
 
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
+        return _clock.civil().tm_hour;
+    }
+    /**< hours since midnight - [ 0 to 23 ] */
 
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
+    int8_t BlinkerApi::mday()
+    {
+        if (!freshTime()) return -1;
 
-            struct tm timeinfo;
+        return _clock.civil().tm_mday;
+    }
+    /**< day of the month - [ 1 to 31 ] */
 
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
+    int8_t BlinkerApi::wday()
+    {
+        if (!freshTime()) return -1;
 
-            return timeinfo.tm_hour;
-        }
-        return -1;
+        return _clock.civil().tm_wday;
     }
-    /**< hours since midnight - [ 0 to 23 ] */
+    /**< days since Sunday - [ 0 to 6 ] */
 
-    int8_t BlinkerApi::mday()
+    int8_t BlinkerApi::month()
     {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
+        if (!freshTime()) return -1;
 
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
+        return _clock.civil().tm_mon + 1;
+    }
+    /**< months since January - [ 1 to 12 ] */
 
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
+    int16_t BlinkerApi::year()
+    {
+        if (!freshTime()) return -1;
 
-            struct tm timeinfo;
+        return _clock.civil().tm_year + 1900;
+    }
+    /**< years since 1900 */
 
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
+    int16_t BlinkerApi::yday()
+    {
+        if (!freshTime()) return -1;
 
-            return timeinfo.tm_mday;
-        }
-        return -1;
+        return _clock.civil().tm_yday + 1;
     }
-    /**< day of the month - [ 1 to 31 ] */
+    /**< days since January 1 - [ 1 to 366 ] */
 
-    int8_t BlinkerApi::wday()
+    time_t  BlinkerApi::time()
     {
         if (_isNTPInit)
         {
-            time_t _ntpGetTime;
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
-
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
-
-            struct tm timeinfo;
+            if (!freshTime()) return -1;
 
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
+            #if defined(ESP32)
+                return _clock.now();
+            #else
+                return _clock.now() - (int)_timezone*3600;
             #endif
-
-            return timeinfo.tm_wday;
         }
-        return -1;
+        return millis();
     }
-    /**< days since Sunday - [ 0 to 6 ] */
 
-    int8_t BlinkerApi::month()
-    {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
 
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
+    int32_t BlinkerApi::dtime()
+    {
+        if (!freshTime()) return -1;
 
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
-
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
-
-            struct tm timeinfo;
-
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
-
-            return timeinfo.tm_mon + 1;
-        }
-        return -1;
-    }
-    /**< months since January - [ 1 to 12 ] */
-
-    int16_t BlinkerApi::year()
-    {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
-
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
-
-            struct tm timeinfo;
-
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
-
-            return timeinfo.tm_year + 1900;
-        }
-        return -1;
-    }
-    /**< years since 1900 */
-
-    int16_t BlinkerApi::yday()
-    {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
-
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
-
-            struct tm timeinfo;
-
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
-
-            return timeinfo.tm_yday + 1;
-        }
-        return -1;
-    }
-    /**< days since January 1 - [ 1 to 366 ] */
-
-    time_t  BlinkerApi::time()
-    {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                BLINKER_LOG_ALL("(millis() - ntpFreshTime): ", (millis() - ntpFreshTime));
-                BLINKER_LOG_ALL("ntpGetTime: ", ntpGetTime);
-                BLINKER_LOG_ALL((ntpGetTime == 0 || (millis() - ntpFreshTime) >= 600000));
-
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                struct tm timeinfo;
-
-                #if defined(ESP8266) || defined(__AVR__)
-                    gmtime_r(&now_ntp, &timeinfo);
-                #elif defined(ESP32)
-                    localtime_r(&now_ntp, &timeinfo);
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-
-                    BLINKER_LOG_ALL("millis() - ntpFreshTime1:", (millis() - ntpFreshTime) / 1000);
-                }
-                
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-
-                #if defined(ESP32)
-                    return _ntpGetTime;
-                #else
-                    return _ntpGetTime - (int)_timezone*3600;
-                #endif
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    BLINKER_LOG_ALL("ntpGetTime: ", ntpGetTime);
-                    BLINKER_LOG_ALL("millis() - ntpFreshTime2:", (millis() - ntpFreshTime) / 1000);
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-
-                #if defined(ESP32)
-                    return _ntpGetTime;
-                #else
-                    return _ntpGetTime - (int)_timezone*3600;
-                #endif
-            }
-
-        }
-        return millis();
-    }
-
-
-    int32_t BlinkerApi::dtime()
-    {
-        if (_isNTPInit)
-        {
-            time_t _ntpGetTime;
-
-            if (ntpGetTime == 0 || (millis() - ntpFreshTime) >= 120000)
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    time_t now_ntp = ::time(nullptr);
-                #elif defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_PRO_SIM7020)
-                    BlinkerSIM7020 BLINKER_SIM7020;
-                    BLINKER_SIM7020.setStream(*stream, isHWS, listenFunc);
-                    if (!BLINKER_SIM7020.getSNTP(_timezone)) return -1;
-                    time_t now_ntp = BLINKER_SIM7020._ntpTime;
-                #elif defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
-                    defined(BLINKER_LOWPOWER_AIR202)
-                    BlinkerAIR202 BLINKER_AIR202;
-                    BLINKER_AIR202.setStream(*stream, isHWS, listenFunc);
-                    // if (!BLINKER_AIR202.getAMGSMLOC(_timezone)) return -1;
-                    if (!BLINKER_AIR202.getNTP()) return -1;
-                    time_t now_ntp = BLINKER_AIR202._ntpTime;
-                #endif
-
-                if (now_ntp > ntpGetTime)
-                {
-                    _ntpGetTime = now_ntp;// - (int)_timezone*3600;
-                }
-                else
-                {
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                }
-
-                ntpGetTime = _ntpGetTime;
-                ntpFreshTime = millis();
-            }
-            else
-            {
-                #if (!defined(BLINKER_NBIOT_SIM7020) && !defined(BLINKER_GPRS_AIR202) && \
-                    !defined(BLINKER_PRO_SIM7020) && !defined(BLINKER_PRO_AIR202) && \
-                    !defined(BLINKER_LOWPOWER_AIR202))
-                    _ntpGetTime = ::time(nullptr);
-                #else
-                    _ntpGetTime = ntpGetTime + ((millis() - ntpFreshTime) / 1000);
-                #endif
-            }
-
-            struct tm timeinfo;
-
-            #if defined(ESP8266) || defined(__AVR__)
-                gmtime_r(&_ntpGetTime, &timeinfo);
-            #elif defined(ESP32)
-                localtime_r(&_ntpGetTime, &timeinfo);
-            #endif
-
-            return timeinfo.tm_hour * 60 * 60 + timeinfo.tm_min * 60 + timeinfo.tm_sec;
-        }
-        return -1;
-    }
+        return _clock.daySecond();
+    }
 
     template<typename T>
     bool BlinkerApi::sms(const T& msg)
@@ -5297,7 +4943,7 @@ float BlinkerApi::gps(b_gps_t axis)
         }
         else
         {
-            DynamicJsonBuffer jsonBuffer;
+            BlinkerJsonBuffer jsonBuffer;
             JsonObject& autoJson = jsonBuffer.parseObject(payload);
 
             return autoManager(autoJson);
@@ -5370,6 +5016,8 @@ float BlinkerApi::gps(b_gps_t axis)
                 _Bridge[_bridgeCount] = new BlinkerBridge_key(_key, _func);
                 _bridgeCount++;
 
+                bridgeIndex();
+
                 BLINKER_LOG_ALL(BLINKER_F("new bridgeKey: "), _key, \
                             BLINKER_F(" _bridgeCount: "), _bridgeCount);
                 return _bridgeCount;
@@ -5411,17 +5059,192 @@ float BlinkerApi::gps(b_gps_t axis)
         String register_r;
         for (uint8_t num = 0; num < _bridgeCount; num++)
         {
+            #if defined(ESP8266) || defined(ESP32)
+                if (bridgeLoad(num)) continue;
+            #endif
+
             register_r = bridgeQuery(_Bridge[num]->getKey());
             BLINKER_LOG_ALL(BLINKER_F("bridgeQuery name: "), register_r);
             if (strcmp(register_r.c_str(), BLINKER_CMD_FALSE) != 0)
             {
-                _Bridge[num]->name(register_r);
+                bridgeRename(num, register_r);
+
+                #if defined(ESP8266) || defined(ESP32)
+                    bridgeSave(num);
+                #endif
+            }
+        }
+    }
+
+
+    void BlinkerApi::bridgeIndex()
+    {
+        memset(_bridgeTable, 0, BLINKER_BRIDGE_HASH_SIZE);
+
+        for (uint8_t num = 0; num < _bridgeCount; num++)
+        {
+            if (!_Bridge[num]->isRegister()) continue;
+
+            uint8_t slot = _Bridge[num]->getHash() % BLINKER_BRIDGE_HASH_SIZE;
+
+            while (_bridgeTable[slot]) slot = (slot + 1) % BLINKER_BRIDGE_HASH_SIZE;
+
+            _bridgeTable[slot] = num + 1;
+        }
+    }
+
+
+    void BlinkerApi::bridgeRename(uint8_t num, const String & name)
+    {
+        _Bridge[num]->name(name);
+
+        // the slot follows the name hash
+        bridgeIndex();
+    }
+
+
+    int8_t BlinkerApi::bridgeFind(const char * name)
+    {
+        uint32_t _hash = STRING_hash(name);
+        uint8_t slot = _hash % BLINKER_BRIDGE_HASH_SIZE;
+
+        for (uint8_t probe = 0; probe < BLINKER_BRIDGE_HASH_SIZE; probe++)
+        {
+            if (_bridgeTable[slot] == 0) break;
+
+            uint8_t num = _bridgeTable[slot] - 1;
+
+            if (_Bridge[num]->getHash() == _hash && \
+                strcmp(_Bridge[num]->getName(), name) == 0)
+            {
+                return num;
+            }
+
+            slot = (slot + 1) % BLINKER_BRIDGE_HASH_SIZE;
+        }
+
+        return BLINKER_OBJECT_NOT_AVAIL;
+    }
+
+
+    #if defined(ESP8266) || defined(ESP32)
+    bool BlinkerApi::bridgeLoad(uint8_t num)
+    {
+        uint32_t _keyHash = STRING_hash(_Bridge[num]->getKey(), STRING_hash(BProto::deviceName()));
+        uint32_t _eepHash;
+        uint16_t _eepDay;
+        char _name[BLINKER_BRIDGE_NAME_SIZE];
+        uint16_t _addr = BLINKER_EEP_ADDR_BRIDGE + num * BLINKER_ONE_BRIDGE_SIZE;
+
+        EEPROM.begin(BLINKER_EEP_SIZE);
+        EEPROM.get(_addr, _eepHash);
+        EEPROM.get(_addr + BLINKER_BRIDGE_KEY_HASH_SIZE, _eepDay);
+        EEPROM.get(_addr + BLINKER_BRIDGE_KEY_HASH_SIZE + BLINKER_BRIDGE_DAY_SIZE, _name);
+        EEPROM.end();
+
+        _name[BLINKER_BRIDGE_NAME_SIZE - 1] = '\0';
+
+        if (_eepHash != _keyHash || strlen(_name) == 0) return false;
+
+        // the name can change on the server, ask again once it is old
+        uint16_t _age = (uint16_t)(_clock.now() / 86400UL) - _eepDay;
+
+        if (!_clock.synced() || _age >= BLINKER_BRIDGE_CACHE_DAYS)
+        {
+            BLINKER_LOG_ALL(BLINKER_F("bridge name expired: "), _name);
+            return false;
+        }
+
+        BLINKER_LOG_ALL(BLINKER_F("bridge name cached: "), _name);
+
+        bridgeRename(num, STRING_format(_name));
+
+        return true;
+    }
+
+
+    void BlinkerApi::bridgeSave(uint8_t num)
+    {
+        if (strlen(_Bridge[num]->getName()) >= BLINKER_BRIDGE_NAME_SIZE || \
+            !_clock.synced()) return;
+
+        uint32_t _keyHash = STRING_hash(_Bridge[num]->getKey(), STRING_hash(BProto::deviceName()));
+        uint16_t _day = _clock.now() / 86400UL;
+        char _name[BLINKER_BRIDGE_NAME_SIZE] = { 0 };
+        uint16_t _addr = BLINKER_EEP_ADDR_BRIDGE + num * BLINKER_ONE_BRIDGE_SIZE;
+
+        strcpy(_name, _Bridge[num]->getName());
+
+        EEPROM.begin(BLINKER_EEP_SIZE);
+        EEPROM.put(_addr, _keyHash);
+        EEPROM.put(_addr + BLINKER_BRIDGE_KEY_HASH_SIZE, _day);
+        EEPROM.put(_addr + BLINKER_BRIDGE_KEY_HASH_SIZE + BLINKER_BRIDGE_DAY_SIZE, _name);
+        EEPROM.commit();
+        EEPROM.end();
+    }
+    #endif
+
+
+    void BlinkerApi::bridgeFlush()
+    {
+        if ((millis() - _bridgeRetry) < BLINKER_BRIDGE_RETRY_TIME && \
+            _bridgeRetry != 0) return;
+
+        for (uint8_t num = 0; num < _bridgeCount; num++)
+        {
+            if (!_Bridge[num]->isPending()) continue;
+
+            if ((millis() - _Bridge[num]->pendingTime()) < BLINKER_BRIDGE_BATCH_TIMEOUT)
+            {
+                continue;
+            }
+
+            if (BProto::bPrint(_Bridge[num]->getName(), _Bridge[num]->pendingMsg()))
+            {
+                _Bridge[num]->flush();
+                _bridgeRetry = 0;
+            }
+            else
+            {
+                _bridgeRetry = millis();
+                return;
             }
         }
     }
 
+
     void BlinkerApi::bridgePrint(char * bName, const String & data)
     {
+        #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+            defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
+            defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
+            int8_t num = bridgeFind(bName);
+
+            if (num != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                if (_Bridge[num]->batch(data)) return;
+
+                // the queued message goes out first, the new one
+                // waits in the queue so the order is kept
+                BLINKER_LOG_ALL(BLINKER_F("bridge batch full, flush: "), bName);
+
+                if (BProto::bPrint(bName, _Bridge[num]->pendingMsg()))
+                {
+                    _Bridge[num]->flush();
+                    _Bridge[num]->batch(data);
+                    _bridgeRetry = 0;
+                }
+                else
+                {
+                    _bridgeRetry = millis();
+
+                    BLINKER_ERR_LOG(BLINKER_F("bridge busy, drop: "), data);
+                }
+
+                return;
+            }
+        #endif
+
         BProto::bPrint(bName, data);
     }
     #endif
@@ -5497,7 +5320,7 @@ float BlinkerApi::gps(b_gps_t axis)
 
             if (otaData != BLINKER_CMD_FALSE)
             {
-                DynamicJsonBuffer jsonBuffer;
+                BlinkerJsonBuffer jsonBuffer;
                 JsonObject& otaJson = jsonBuffer.parseObject(otaData);
 
                 if (!otaJson.success())
@@ -5723,7 +5546,7 @@ float BlinkerApi::gps(b_gps_t axis)
             data += BProto::_sendBuf;
             data += BLINKER_F("}");
 
-            return blinkerServer(BLINKER_CMD_LOWPOWER_DATA_UP_NUMBER, data) == BLINKER_CMD_FALSE;
+            return blinkerServer(BLINKER_CMD_LOWPOWER_DATA_UP_NUMBER, data) != BLINKER_CMD_FALSE;
         }
     #endif
 
@@ -5979,6 +5802,33 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             ahrsValue[Roll] = data[BLINKER_CMD_AHRS][Roll];
             ahrsValue[Pitch] = data[BLINKER_CMD_AHRS][Pitch];
 
+            if (_ahrsWait)
+            {
+                BLINKER_LOG(BLINKER_F("AHRS attach sucessed..."));
+                _ahrsWait = false;
+            }
+
+            #if defined(BLINKER_SENSOR_STREAM)
+                // app answers with the rate it will actually send
+                if (data.containsKey(BLINKER_CMD_FREQ))
+                {
+                    BLINKER_SENSOR.freq(data[BLINKER_CMD_FREQ]);
+                }
+
+                if (data[BLINKER_CMD_AHRS].is<JsonArray>())
+                {
+                    b_sensor_t sample;
+                    sample.type = BLINKER_SENSOR_AHRS;
+                    sample.seq = 0;
+                    sample.time = millis();
+                    sample.value[Yaw] = ahrsValue[Yaw] * 10;
+                    sample.value[Pitch] = ahrsValue[Pitch] * 10;
+                    sample.value[Roll] = ahrsValue[Roll] * 10;
+
+                    BLINKER_SENSOR.put(sample);
+                }
+            #endif
+
             _fresh = true;
 
             return aAttiValue;
@@ -6004,6 +5854,18 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             gpsValue[LONG] = gpsValue_LONG.toFloat();
             gpsValue[LAT] = gpsValue_LAT.toFloat();
 
+            #if defined(BLINKER_SENSOR_STREAM)
+                b_sensor_t sample;
+                sample.type = BLINKER_SENSOR_GPS;
+                sample.seq = 0;
+                sample.time = millis();
+                sample.value[LONG] = gpsValue[LONG] * 1000000;
+                sample.value[LAT] = gpsValue[LAT] * 1000000;
+                sample.value[2] = 0;
+
+                BLINKER_SENSOR.put(sample);
+            #endif
+
             _fresh = true;
 
             if (_fresh) {
@@ -6018,6 +5880,43 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
+    #if defined(BLINKER_SNAPSHOT)
+        // the snapshot has the newest value of every widget it holds, drop
+        // those keys from the send buffer so no key goes out twice
+        void BlinkerApi::snapMerge()
+        {
+            if (!BProto::autoFormat || !strlen(BProto::_sendBuf)) return;
+
+            BlinkerJsonBuffer jsonBuffer;
+            JsonObject& root = jsonBuffer.parseObject(STRING_format(BProto::_sendBuf));
+
+            if (!root.success()) return;
+
+            String _kept = BLINKER_F("{");
+
+            for (JsonObject::iterator it = root.begin(); it != root.end(); ++it)
+            {
+                if (_snapshot.contains(it->key)) continue;
+
+                if (_kept.length() > 1) _kept += BLINKER_F(",");
+                _kept += BLINKER_F("\"");
+                _kept += it->key;
+                _kept += BLINKER_F("\":");
+                it->value.printTo(_kept);
+            }
+
+            if (_kept.length() > 1)
+            {
+                _kept += BLINKER_F("}");
+                strcpy(BProto::_sendBuf, _kept.c_str());
+            }
+            else
+            {
+                BProto::_sendBuf[0] = '\0';
+            }
+        }
+    #endif
+
     void BlinkerApi::heartBeat(const JsonObject& data)
     {
         String state = data[BLINKER_CMD_GET];
@@ -6026,6 +5925,21 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         {
             if (state == BLINKER_CMD_STATE)
             {
+                #if defined(BLINKER_SNAPSHOT)
+                    // widgets printed by the heartbeat callback only go
+                    // to the snapshot, which is sent once at the end
+                    // a widget did not fit, start the snapshot over from
+                    // the full resend so it can recover
+                    if (_snapshot.overflow())
+                    {
+                        _snapshot.clear();
+                        _shadowEpoch++;
+                    }
+                    else _snapHold = true;
+                #else
+                    _shadowEpoch++;
+                #endif
+
                 #if defined(BLINKER_BLE) || defined(BLINKER_WIFI)
                     print(BLINKER_CMD_STATE, BLINKER_CMD_CONNECTED);
                 #else
@@ -6050,6 +5964,22 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                         defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
                         print(BLINKER_CMD_VERSION, BLINKER_OTA_VERSION_CODE);
                     #endif
+
+                    #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+                        defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+                        defined(BLINKER_PRO_ESP)
+                        String _net = BLINKER_F("\"");
+                        _net += BLINKER_CMD_NET;
+                        _net += BLINKER_F("\":{\"rtt\":");
+                        _net += STRING_format(linkRtt());
+                        _net += BLINKER_F(",\"rc\":");
+                        _net += STRING_format(linkReconnects());
+                        _net += BLINKER_F(",\"off\":");
+                        _net += STRING_format(linkOffline() / 1000);
+                        _net += BLINKER_F("}");
+
+                        BProto::print(BLINKER_CMD_NET, _net);
+                    #endif
                 #endif
 
                 if (_heartbeatFunc) {
@@ -6067,6 +5997,43 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     }
                 }
 
+                #if defined(BLINKER_SNAPSHOT)
+                    String _snap;
+
+                    if (_snapHold)
+                    {
+                        _snapHold = false;
+
+                        // app already holds this version, only confirm it
+                        bool _same = data.containsKey(BLINKER_CMD_SNAPSHOT) && \
+                                    data[BLINKER_CMD_SNAPSHOT].as<unsigned long>() == _snapshot.version();
+
+                        if (!_same && _snapshot.length())
+                        {
+                            _snap.reserve(_snapshot.length() + 24);
+                            _snap = _snapshot.data();
+                            _snap += BLINKER_F(",");
+
+                            snapMerge();
+                        }
+
+                        _snap += BLINKER_F("\"");
+                        _snap += BLINKER_F(BLINKER_CMD_SNAPSHOT);
+                        _snap += BLINKER_F("\":");
+                        _snap += STRING_format(_snapshot.version());
+
+                        BLINKER_LOG_ALL(BLINKER_F("snapshot same: "), _same);
+
+                        // no room left next to the header fields, the
+                        // next state request resends every widget
+                        if (!BProto::print(BLINKER_CMD_SNAPSHOT, _snap))
+                        {
+                            _snapshot.reject();
+                            _snap = BLINKER_F("");
+                        }
+                    }
+                #endif
+
                 BProto::checkState(false);
                 if (!BProto::printNow())
                 {
@@ -6089,6 +6056,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                         }
                     }
 
+                    #if defined(BLINKER_SNAPSHOT)
+                        if (_snap.length()) BProto::print(BLINKER_CMD_SNAPSHOT, _snap);
+                    #endif
+
                     BProto::checkState(false);
                     BProto::printNow();
                 }
@@ -6135,6 +6106,242 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
+    #if defined(BLINKER_GATEWAY)
+        uint8_t BlinkerApi::attachSubDevice(char * _ns)
+        {
+            int8_t num = checkNum(_ns, _SubNode, _subCount);
+
+            if (num != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                BLINKER_ERR_LOG(BLINKER_F("subDevice > "), _ns, \
+                        BLINKER_F(" < has been registered, please register another name!"));
+                return 0;
+            }
+
+            if (_subCount >= BLINKER_MAX_SUB_DEVICE_SIZE || \
+                strlen(_ns) >= BLINKER_SUB_DEVICE_NS_SIZE)
+            {
+                return 0;
+            }
+
+            _SubNode[_subCount] = new BlinkerSubNode(_ns, _subCount + 1);
+
+            uint8_t slot = _SubNode[_subCount]->getHash() % BLINKER_SUB_DEVICE_HASH_SIZE;
+
+            while (_subTable[slot]) slot = (slot + 1) % BLINKER_SUB_DEVICE_HASH_SIZE;
+
+            _subTable[slot] = _subCount + 1;
+            _subCount++;
+
+            BLINKER_LOG_ALL(BLINKER_F("new subDevice: "), _ns, \
+                        BLINKER_F(" id: "), _subCount);
+
+            return _subCount;
+        }
+
+        int8_t BlinkerApi::subDeviceFind(const char * _ns)
+        {
+            uint32_t _hash = STRING_hash(_ns);
+            uint8_t slot = _hash % BLINKER_SUB_DEVICE_HASH_SIZE;
+
+            for (uint8_t probe = 0; probe < BLINKER_SUB_DEVICE_HASH_SIZE; probe++)
+            {
+                if (_subTable[slot] == 0) break;
+
+                uint8_t num = _subTable[slot] - 1;
+
+                if (_SubNode[num]->getHash() == _hash && \
+                    strcmp(_SubNode[num]->getName(), _ns) == 0)
+                {
+                    return num;
+                }
+
+                slot = (slot + 1) % BLINKER_SUB_DEVICE_HASH_SIZE;
+            }
+
+            return BLINKER_OBJECT_NOT_AVAIL;
+        }
+
+        void BlinkerApi::gatewayPoll()
+        {
+            BProto::checkAvail();
+            if (BProto::isAvail) parse(BProto::dataParse());
+
+            gatewayRun();
+
+            BProto::checkAutoFormat();
+        }
+
+        void BlinkerApi::gatewayRun()
+        {
+            if (!_gatewayAvail || !_gatewayRead) return;
+
+            for (uint8_t num = 0; num < BLINKER_GATEWAY_READ_LIMIT; num++)
+            {
+                if (!_gatewayAvail()) return;
+
+                String data = _gatewayRead();
+
+                if (data.length() == 0) return;
+
+                gatewayRead(data);
+            }
+        }
+
+        bool BlinkerApi::gatewaySend(uint8_t id, const String & data, uint8_t magic)
+        {
+            String frame = STRING_frame_encode(id, data, magic);
+
+            if (!frame.length())
+            {
+                BLINKER_ERR_LOG(BLINKER_F("subDevice frame too long, drop: "), data.length());
+                return false;
+            }
+
+            _gatewayPrint(frame);
+            return true;
+        }
+
+        void BlinkerApi::gatewayRead(const String & data)
+        {
+            uint8_t _id;
+            String _data;
+
+            int8_t type = STRING_frame_decode(data, _id, _data);
+
+            if (type == BLINKER_FRAME_ERROR)
+            {
+                BLINKER_ERR_LOG_ALL(BLINKER_F("subDevice frame error"));
+                return;
+            }
+
+            if (_id > _subCount) return;
+
+            if (type == BLINKER_FRAME_TLV)
+            {
+                if (_id == 0) return;
+
+                BlinkerTLV * _tlv = _SubNode[_id - 1]->tlv();
+                String _json;
+
+                bool _state = _tlv->decode(_data, _json);
+
+                if (!_state || _tlv->needSync())
+                {
+                    String _sync = _tlv->encode(BLINKER_F("{}"));
+
+                    if (_sync.length() && gatewaySend(_id, _sync, BLINKER_FRAME_MAGIC_TLV))
+                    {
+                        _tlv->commit();
+                    }
+                }
+
+                if (!_state) return;
+
+                _data = _json;
+            }
+
+            BlinkerJsonBuffer jsonBuffer;
+            JsonObject& root = jsonBuffer.parseObject(_data);
+
+            if (!root.success()) return;
+
+            BLINKER_LOG_ALL(BLINKER_F("subDevice: "), _id, BLINKER_F(", data: "), _data);
+
+            for (JsonObject::iterator it = root.begin(); it != root.end(); ++it)
+            {
+                String _key = BLINKER_F("");
+
+                if (_id)
+                {
+                    _key = _SubNode[_id - 1]->getName();
+                    _key += BLINKER_GATEWAY_NS_SEPARATOR;
+                }
+                _key += it->key;
+
+                String _msg = BLINKER_F("\"");
+                _msg += _key;
+                _msg += BLINKER_F("\":");
+                it->value.printTo(_msg);
+
+                BProto::print(_key, _msg);
+            }
+        }
+
+        void BlinkerApi::gatewayParse(const JsonObject& data)
+        {
+            if (!_subCount || !_gatewayPrint) return;
+
+            String state = data[BLINKER_CMD_GET];
+
+            if (state == BLINKER_CMD_STATE)
+            {
+                String _msg = BLINKER_F("{\"");
+                _msg += BLINKER_CMD_GET;
+                _msg += BLINKER_F("\":\"");
+                _msg += BLINKER_CMD_STATE;
+                _msg += BLINKER_F("\"}");
+
+                gatewaySend(BLINKER_FRAME_BROADCAST, _msg);
+            }
+
+            char _ns[BLINKER_SUB_DEVICE_NS_SIZE];
+
+            for (JsonObject::const_iterator it = data.begin(); it != data.end(); ++it)
+            {
+                const char * _sep = strchr(it->key, BLINKER_GATEWAY_NS_SEPARATOR);
+
+                if (_sep == NULL || (_sep - it->key) >= BLINKER_SUB_DEVICE_NS_SIZE) continue;
+
+                memcpy(_ns, it->key, _sep - it->key);
+                _ns[_sep - it->key] = '\0';
+
+                int8_t num = subDeviceFind(_ns);
+
+                if (num == BLINKER_OBJECT_NOT_AVAIL) continue;
+
+                String & _msg = _SubNode[num]->downMsg();
+
+                _msg += _msg.length() ? BLINKER_F(",\"") : BLINKER_F("{\"");
+                _msg += (_sep + 1);
+                _msg += BLINKER_F("\":");
+                it->value.printTo(_msg);
+
+                _fresh = true;
+            }
+
+            for (uint8_t num = 0; num < _subCount; num++)
+            {
+                String & _msg = _SubNode[num]->downMsg();
+
+                if (_msg.length() == 0) continue;
+
+                _msg += BLINKER_F("}");
+
+                BLINKER_LOG_ALL(BLINKER_F("to subDevice: "), _SubNode[num]->getName(), \
+                            BLINKER_F(", data: "), _msg);
+
+                String _tlv;
+
+                if (_SubNode[num]->isTLV()) _tlv = _SubNode[num]->tlv()->encode(_msg);
+
+                if (_tlv.length())
+                {
+                    if (gatewaySend(_SubNode[num]->getId(), _tlv, BLINKER_FRAME_MAGIC_TLV))
+                    {
+                        _SubNode[num]->tlv()->commit();
+                    }
+                }
+                else
+                {
+                    gatewaySend(_SubNode[num]->getId(), _msg);
+                }
+
+                _msg = BLINKER_F("");
+            }
+        }
+    #endif
+
     #if defined(BLINKER_SUBDEVICE)
         void BlinkerApi::broadCast(const JsonObject& data)
         {
@@ -6152,31 +6359,31 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
         defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
         defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
-        void BlinkerApi::bridgeParse(char * _bName, const JsonObject& data)
+        void BlinkerApi::bridgeParse(const JsonObject& data)
         {
-            // int8_t num = checkNum(_bName, _Bridge, _bridgeCount);
+            if (!_bridgeCount || !data.containsKey(BLINKER_CMD_FROMDEVICE))
+            {
+                return;
+            }
 
-            // if (num == BLINKER_OBJECT_NOT_AVAIL ||
-            //     !data.containsKey(BLINKER_CMD_FROMDEVICE))
-            // {
-            //     return;
-            // }
+            const char * _name = data[BLINKER_CMD_FROMDEVICE];
 
-            // String _name = data[BLINKER_CMD_FROMDEVICE];
+            // missing or not a string
+            if (_name == NULL) return;
 
-            // // if (data.containsKey(_bName))
-            // if (_name == _bName)
-            // {
-            //     String state = data[BLINKER_CMD_DATA];//[_bName];
+            int8_t num = bridgeFind(_name);
 
-            //     _fresh = true;
+            if (num == BLINKER_OBJECT_NOT_AVAIL) return;
+
+            String state = data[BLINKER_CMD_DATA];
 
-            //     BLINKER_LOG_ALL(BLINKER_F("bridgeParse: "), _bName);
+            _fresh = true;
 
-            //     blinker_callback_with_string_arg_t nbFunc = _Bridge[num]->getFunc();
+            BLINKER_LOG_ALL(BLINKER_F("bridgeParse: "), _name);
 
-            //     if (nbFunc) nbFunc(state);
-            // }
+            blinker_callback_with_string_arg_t nbFunc = _Bridge[num]->getFunc();
+
+            if (nbFunc) nbFunc(state);
         }
     #endif
 
@@ -6343,15 +6550,21 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
 #else
 
-    int16_t BlinkerApi::ahrs(b_ahrsattitude_t attitude, char data[])
+    int16_t BlinkerApi::ahrs(b_ahrsattitude_t attitude, const BlinkerToken& data)
     {
-        int16_t aAttiValue = STRING_find_array_numberic_value(data, BLINKER_CMD_AHRS, attitude);
+        if (_ahrsWait && data.contains(BLINKER_CMD_AHRS))
+        {
+            BLINKER_LOG(BLINKER_F("AHRS attach sucessed..."));
+            _ahrsWait = false;
+        }
+
+        int16_t aAttiValue = data.arrayNumber(BLINKER_CMD_AHRS, attitude);
 
         if (aAttiValue != FIND_KEY_VALUE_FAILED)
         {
-            ahrsValue[Yaw] = STRING_find_array_numberic_value(data, BLINKER_CMD_AHRS, Yaw);
-            ahrsValue[Roll] = STRING_find_array_numberic_value(data, BLINKER_CMD_AHRS, Roll);
-            ahrsValue[Pitch] = STRING_find_array_numberic_value(data, BLINKER_CMD_AHRS, Pitch);
+            ahrsValue[Yaw] = data.arrayNumber(BLINKER_CMD_AHRS, Yaw);
+            ahrsValue[Roll] = data.arrayNumber(BLINKER_CMD_AHRS, Roll);
+            ahrsValue[Pitch] = data.arrayNumber(BLINKER_CMD_AHRS, Pitch);
 
             _fresh = true;
 
@@ -6362,7 +6575,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    float BlinkerApi::gps(b_gps_t axis, char data[])
+    float BlinkerApi::gps(b_gps_t axis, const BlinkerToken& data)
     {
         // if (((millis() - gps_get_time) >= BLINKER_GPS_MSG_LIMIT ||
         //     gps_get_time == 0) && !newData)
@@ -6372,11 +6585,9 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         //     delay(100);
         // }
 
-        String axisValue = STRING_find_array_string_value(data, BLINKER_CMD_GPS, axis);
-
-        if (axisValue != "") {
-            gpsValue[LONG] = STRING_find_array_string_value(data, BLINKER_CMD_GPS, LONG).toFloat();
-            gpsValue[LAT] = STRING_find_array_string_value(data, BLINKER_CMD_GPS, LAT).toFloat();
+        if (data.arrayFloat(BLINKER_CMD_GPS, axis) != (float)FIND_KEY_VALUE_FAILED) {
+            gpsValue[LONG] = data.arrayFloat(BLINKER_CMD_GPS, LONG);
+            gpsValue[LAT] = data.arrayFloat(BLINKER_CMD_GPS, LAT);
 
             _fresh = true;
 
@@ -6392,11 +6603,12 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    void BlinkerApi::heartBeat(char data[])
+    void BlinkerApi::heartBeat(const BlinkerToken& data)
     {
-        if (strstr(data, BLINKER_CMD_GET) && \
-            strstr(data, BLINKER_CMD_STATE))
+        if (data.equal(BLINKER_CMD_GET, BLINKER_CMD_STATE))
         {
+            _shadowEpoch++;
+
             #if defined(BLINKER_BLE)
                 print(BLINKER_CMD_STATE, BLINKER_CMD_CONNECTED);
             #else
@@ -6454,21 +6666,20 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    void BlinkerApi::getVersion(char data[])
+    void BlinkerApi::getVersion(const BlinkerToken& data)
     {
-        if (strstr(data, BLINKER_CMD_GET) && \
-            strstr(data, BLINKER_CMD_VERSION))
+        if (data.equal(BLINKER_CMD_GET, BLINKER_CMD_VERSION))
         {
             print(BLINKER_CMD_VERSION, BLINKER_VERSION);
             _fresh = true;
         }
     }
 
-    void BlinkerApi::setSwitch(char data[])
+    void BlinkerApi::setSwitch(const BlinkerToken& data)
     {
         String state;
 
-        if (STRING_find_string_value(data, state, BLINKER_CMD_BUILTIN_SWITCH))
+        if (data.value(BLINKER_CMD_BUILTIN_SWITCH, state))
         {
             // if (_BUILTIN_SWITCH)
             // {
@@ -6483,7 +6694,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    void BlinkerApi::strWidgetsParse(char _wName[], char _data[])
+    void BlinkerApi::strWidgetsParse(char _wName[], const BlinkerToken& data)
     {
         int8_t num = checkNum(_wName, _Widgets_str, _wCount_str);
 
@@ -6494,7 +6705,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
         String state;
 
-        if (STRING_find_string_value(_data, state, _wName))
+        if (data.value(_wName, state))
         {
             BLINKER_LOG_ALL("state: ", state);
 
@@ -6506,19 +6717,17 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     }
 
     #if defined(BLINKER_BLE)
-        void BlinkerApi::joyWidgetsParse(char _wName[], char _data[])
+        void BlinkerApi::joyWidgetsParse(char _wName[], const BlinkerToken& data)
         {
             int8_t num = checkNum(_wName, _Widgets_joy, _wCount_joy);
 
             if (num == BLINKER_OBJECT_NOT_AVAIL) return;
 
-            int16_t jxAxisValue = STRING_find_array_numberic_value(_data, \
-                                                _wName, BLINKER_J_Xaxis);
+            int16_t jxAxisValue = data.arrayNumber(_wName, BLINKER_J_Xaxis);
 
             if (jxAxisValue != FIND_KEY_VALUE_FAILED)
             {
-                uint8_t jyAxisValue = STRING_find_array_numberic_value(_data, \
-                                                    _wName, BLINKER_J_Yaxis);
+                uint8_t jyAxisValue = data.arrayNumber(_wName, BLINKER_J_Yaxis);
 
                 _fresh = true;
 
@@ -6529,20 +6738,19 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     #endif
 
-    void BlinkerApi::rgbWidgetsParse(char _wName[], char _data[])
+    void BlinkerApi::rgbWidgetsParse(char _wName[], const BlinkerToken& data)
     {
         int8_t num = checkNum(_wName, _Widgets_rgb, _wCount_rgb);
 
         if (num == BLINKER_OBJECT_NOT_AVAIL) return;
 
-        int16_t _rValue = STRING_find_array_numberic_value(_data, \
-                                                _wName, BLINKER_R);
+        int16_t _rValue = data.arrayNumber(_wName, BLINKER_R);
 
         if (_rValue != FIND_KEY_VALUE_FAILED)
         {
-            uint8_t _gValue = STRING_find_array_numberic_value(_data, _wName, BLINKER_G);
-            uint8_t _bValue = STRING_find_array_numberic_value(_data, _wName, BLINKER_B);
-            uint8_t _brightValue = STRING_find_array_numberic_value(_data, _wName, BLINKER_BRIGHT);
+            uint8_t _gValue = data.arrayNumber(_wName, BLINKER_G);
+            uint8_t _bValue = data.arrayNumber(_wName, BLINKER_B);
+            uint8_t _brightValue = data.arrayNumber(_wName, BLINKER_BRIGHT);
 
             _fresh = true;
 
@@ -6552,13 +6760,13 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    void BlinkerApi::intWidgetsParse(char _wName[], char _data[])
+    void BlinkerApi::intWidgetsParse(char _wName[], const BlinkerToken& data)
     {
         int8_t num = checkNum(_wName, _Widgets_int, _wCount_int);
 
         if (num == BLINKER_OBJECT_NOT_AVAIL) return;
 
-        int _number = STRING_find_numberic_value(_data, _wName);
+        int _number = data.number(_wName);
 
         if (_number != FIND_KEY_VALUE_FAILED)
         {
@@ -6570,7 +6778,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     }
 
-    void BlinkerApi::tabWidgetsParse(char _wName[], char _data[])
+    void BlinkerApi::tabWidgetsParse(char _wName[], const BlinkerToken& data)
     {
         int8_t num = checkNum(_wName, _Widgets_tab, _wCount_tab);
 
@@ -6578,7 +6786,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
         String _setData;
 
-        if (STRING_find_string_value(_data, _setData, _wName))
+        if (data.value(_wName, _setData))
         {
             BLINKER_LOG_ALL("_setData: ", _setData);
 
@@ -6648,28 +6856,28 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         // }
     }
 
-    void BlinkerApi::json_parse(char _data[])
+    void BlinkerApi::json_parse(const BlinkerToken& data)
     {
-        setSwitch(_data);
+        setSwitch(data);
 
         BLINKER_LOG_ALL("====_wCount_str: ", _wCount_str, " ====");
 
         for (uint8_t wNum = 0; wNum < _wCount_str; wNum++) {
-            strWidgetsParse(_Widgets_str[wNum]->getName(), _data);
+            strWidgetsParse(_Widgets_str[wNum]->getName(), data);
         }
         for (uint8_t wNum_int = 0; wNum_int < _wCount_int; wNum_int++) {
-            intWidgetsParse(_Widgets_int[wNum_int]->getName(), _data);
+            intWidgetsParse(_Widgets_int[wNum_int]->getName(), data);
         }
         for (uint8_t wNum_rgb = 0; wNum_rgb < _wCount_rgb; wNum_rgb++) {
-            rgbWidgetsParse(_Widgets_rgb[wNum_rgb]->getName(), _data);
+            rgbWidgetsParse(_Widgets_rgb[wNum_rgb]->getName(), data);
         }
         #if defined(BLINKER_BLE)
             for (uint8_t wNum_joy = 0; wNum_joy < _wCount_joy; wNum_joy++) {
-                joyWidgetsParse(_Widgets_joy[wNum_joy]->getName(), _data);
+                joyWidgetsParse(_Widgets_joy[wNum_joy]->getName(), data);
             }
         #endif
         for (uint8_t wNum_tab = 0; wNum_tab < _wCount_tab; wNum_tab++) {
-            tabWidgetsParse(_Widgets_tab[wNum_tab]->getName(), _data);
+            tabWidgetsParse(_Widgets_tab[wNum_tab]->getName(), data);
         }
     }
 #endif
@@ -8456,7 +8664,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
                     if(_autoData_array.length())
                     {
-                        DynamicJsonBuffer _jsonBuffer;
+                        BlinkerJsonBuffer _jsonBuffer;
                         JsonObject& _array = _jsonBuffer.parseObject(_autoData_array);
 
                         json_parse(_array);
@@ -8548,7 +8756,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         {
             String value = data[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -8571,7 +8779,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         {
             String value = data[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -8627,7 +8835,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         {
             String value = data[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -8663,7 +8871,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         {
             String value = data[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -9584,7 +9792,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
                     BLINKER_LOG_ALL(payload);
 
-                    DynamicJsonBuffer jsonBuffer;
+                    BlinkerJsonBuffer jsonBuffer;
                     JsonObject& data_rp = jsonBuffer.parseObject(payload);
 
                     if (data_rp.success())
@@ -9711,7 +9919,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     {
         BLINKER_LOG_ALL(BLINKER_F("AliGenie parse data: "), _data);
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(_data);
 
         if (!root.success()) return;
@@ -9754,7 +9962,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         else if (root.containsKey(BLINKER_CMD_SET)) {
             String value = root[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -9829,7 +10037,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     {
         BLINKER_LOG_ALL(BLINKER_F("DuerOS parse data: "), _data);
 
-        DynamicJsonBuffer jsonBuffer;
+        BlinkerJsonBuffer jsonBuffer;
         JsonObject& root = jsonBuffer.parseObject(_data);
 
         if (!root.success()) return;
@@ -9866,7 +10074,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         else if (root.containsKey(BLINKER_CMD_SET)) {
             String value = root[BLINKER_CMD_SET];
 
-            DynamicJsonBuffer jsonBufferSet;
+            BlinkerJsonBuffer jsonBufferSet;
             JsonObject& rootSet = jsonBufferSet.parseObject(value);
 
             if (!rootSet.success()) {
@@ -10126,772 +10334,1025 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     {
         String reqData;
 
-        if (_slaverAT->cmd() == BLINKER_CMD_AT) {
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_RST) {
-            BProto::serialPrint(BLINKER_CMD_OK);
-            ::delay(100);
-            ESP.restart();
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_GMR) {
-            // reqData = "+" + STRING_format(BLINKER_CMD_GMR) +
-            //         "=<MQTT_CONFIG_MODE>,<MQTT_AUTH_KEY>" +
-            //         "[,<MQTT_WIFI_SSID>,<MQTT_WIFI_PSWD>]";
-            BProto::serialPrint(BLINKER_ESP_AT_VERSION);
-            BProto::serialPrint(BLINKER_VERSION);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_UART_CUR) {
-            blinker_at_state_t at_state = _slaverAT->state();
+        switch (atCmdFind(_slaverAT->cmd()))
+        {
+            case AT_CMD_AT :
+            {
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_RST :
+            {
+                BProto::serialPrint(BLINKER_CMD_OK);
+                BProto::serialFlush();
+                ::delay(100);
+                ESP.restart();
+                break;
+            }
+            case AT_CMD_GMR :
+            {
+                // reqData = "+" + STRING_format(BLINKER_CMD_GMR) +
+                //         "=<MQTT_CONFIG_MODE>,<MQTT_AUTH_KEY>" +
+                //         "[,<MQTT_WIFI_SSID>,<MQTT_WIFI_PSWD>]";
+                BProto::serialPrint(BLINKER_ESP_AT_VERSION);
+                BProto::serialPrint(BLINKER_VERSION);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_UART_CUR :
+            {
+                blinker_at_state_t at_state = _slaverAT->state();
 
-            BLINKER_LOG(at_state);
+                BLINKER_LOG(at_state);
 
-            switch (at_state)
-            {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;// +
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_UART_CUR;// +
-                    reqData += BLINKER_F("=<baudrate>,<databits>,<stopbits>,<parity>");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_UART_CUR;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(serialSet >> 8 & 0x00FFFFFF);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet >> 4 & 0x0F);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet >> 2 & 0x03);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet      & 0x03);
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("SER_BAUD: "), _slaverAT->getParam(SER_BAUD));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_DBIT: "), _slaverAT->getParam(SER_DBIT));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_SBIT: "), _slaverAT->getParam(SER_SBIT));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), _slaverAT->getParam(SER_PRIT));
-                    if (BLINKER_UART_PARAM_NUM != _slaverAT->paramNum()) return;
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;// +
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_UART_CUR;// +
+                        reqData += BLINKER_F("=<baudrate>,<databits>,<stopbits>,<parity>");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_UART_CUR;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(serialSet >> 8 & 0x00FFFFFF);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet >> 4 & 0x0F);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet >> 2 & 0x03);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet      & 0x03);
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("SER_BAUD: "), _slaverAT->getParam(SER_BAUD));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_DBIT: "), _slaverAT->getParam(SER_DBIT));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_SBIT: "), _slaverAT->getParam(SER_SBIT));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), _slaverAT->getParam(SER_PRIT));
+                        if (BLINKER_UART_PARAM_NUM != _slaverAT->paramNum())
+                        {
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
+                            return;
+                        }
 
-                    serialSet = (_slaverAT->getParam(SER_BAUD)).toInt() << 8 |
-                                (_slaverAT->getParam(SER_DBIT)).toInt() << 4 |
-                                (_slaverAT->getParam(SER_SBIT)).toInt() << 2 |
-                                (_slaverAT->getParam(SER_PRIT)).toInt();
+                        serialSet = (_slaverAT->getParam(SER_BAUD)).toInt() << 8 |
+                                    (_slaverAT->getParam(SER_DBIT)).toInt() << 4 |
+                                    (_slaverAT->getParam(SER_SBIT)).toInt() << 2 |
+                                    (_slaverAT->getParam(SER_PRIT)).toInt();
 
-                    ss_cfg = serConfig();
+                        ss_cfg = serConfig();
 
-                    BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), serialSet);
+                        BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), serialSet);
 
-                    BProto::serialPrint(BLINKER_CMD_OK);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        BProto::serialFlush();
 
-                    // if (isHWS) {
-                        Serial.begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
-                    // }
-                    // else {
-                    //     SSerialBLE->begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
-                    // }
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
-                    break;
+                        // if (isHWS) {
+                            Serial.begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
+                        // }
+                        // else {
+                        //     SSerialBLE->begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
+                        // }
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
             }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_UART_DEF) {
-            blinker_at_state_t at_state = _slaverAT->state();
+            case AT_CMD_UART_DEF :
+            {
+                blinker_at_state_t at_state = _slaverAT->state();
 
-            BLINKER_LOG(at_state);
+                BLINKER_LOG(at_state);
 
-            switch (at_state)
-            {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_UART_DEF;
-                    reqData += BLINKER_F("=<baudrate>,<databits>,<stopbits>,<parity>");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_UART_DEF;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(serialSet >> 8 & 0x00FFFFFF);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet >> 4 & 0x0F);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet >> 2 & 0x03);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(serialSet      & 0x03);
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("SER_BAUD: "), _slaverAT->getParam(SER_BAUD));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_DBIT: "), _slaverAT->getParam(SER_DBIT));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_SBIT: "), _slaverAT->getParam(SER_SBIT));
-                    BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), _slaverAT->getParam(SER_PRIT));
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_UART_DEF;
+                        reqData += BLINKER_F("=<baudrate>,<databits>,<stopbits>,<parity>");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_UART_DEF;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(serialSet >> 8 & 0x00FFFFFF);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet >> 4 & 0x0F);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet >> 2 & 0x03);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(serialSet      & 0x03);
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("SER_BAUD: "), _slaverAT->getParam(SER_BAUD));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_DBIT: "), _slaverAT->getParam(SER_DBIT));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_SBIT: "), _slaverAT->getParam(SER_SBIT));
+                        BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), _slaverAT->getParam(SER_PRIT));
 
-                    if (BLINKER_UART_PARAM_NUM != _slaverAT->paramNum()) return;
+                        if (BLINKER_UART_PARAM_NUM != _slaverAT->paramNum())
+                        {
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
+                            return;
+                        }
 
-                    serialSet = (_slaverAT->getParam(SER_BAUD)).toInt() << 8 |
-                                (_slaverAT->getParam(SER_DBIT)).toInt() << 4 |
-                                (_slaverAT->getParam(SER_SBIT)).toInt() << 2 |
-                                (_slaverAT->getParam(SER_PRIT)).toInt();
+                        serialSet = (_slaverAT->getParam(SER_BAUD)).toInt() << 8 |
+                                    (_slaverAT->getParam(SER_DBIT)).toInt() << 4 |
+                                    (_slaverAT->getParam(SER_SBIT)).toInt() << 2 |
+                                    (_slaverAT->getParam(SER_PRIT)).toInt();
 
-                    ss_cfg = serConfig();
+                        ss_cfg = serConfig();
 
-                    BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), serialSet);
+                        BLINKER_LOG_ALL(BLINKER_F("SER_PRIT: "), serialSet);
 
-                    BProto::serialPrint(BLINKER_CMD_OK);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        BProto::serialFlush();
 
-                    // if (isHWS) {
-                        Serial.begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
-                    // }
-                    // else {
-                    //     SSerialBLE->begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
-                    // }
+                        // if (isHWS) {
+                            Serial.begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
+                        // }
+                        // else {
+                        //     SSerialBLE->begin(serialSet >> 8 & 0x00FFFFFF, ss_cfg);
+                        // }
 
-                    EEPROM.begin(BLINKER_EEP_SIZE);
-                    EEPROM.put(BLINKER_EEP_ADDR_SERIALCFG, serialSet);
-                    EEPROM.commit();
-                    EEPROM.end();
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
+                        EEPROM.begin(BLINKER_EEP_SIZE);
+                        EEPROM.put(BLINKER_EEP_ADDR_SERIALCFG, serialSet);
+                        EEPROM.commit();
+                        EEPROM.end();
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
+            }
+            case AT_CMD_RAM :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
                     break;
+                }
+
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_F(BLINKER_CMD_RAM);
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(BLINKER_FreeHeap());
+
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_RAM && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_F(BLINKER_CMD_RAM);
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(BLINKER_FreeHeap());
+            case AT_CMD_ADC :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_ADC && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_ADC;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(analogRead(A0));
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_ADC;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(analogRead(A0));
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_IOSETCFG && _slaverAT->state() == AT_SETTING) {
-            BLINKER_LOG_ALL(BLINKER_F("PIN_SET: "), _slaverAT->getParam(PIN_SET));
-            BLINKER_LOG_ALL(BLINKER_F("PIN_MODE: "), _slaverAT->getParam(PIN_MODE));
-            BLINKER_LOG_ALL(BLINKER_F("PIN_PULLSTATE: "), _slaverAT->getParam(PIN_PULLSTATE));
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_IOSETCFG :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            if (BLINKER_IOSETCFG_PARAM_NUM != _slaverAT->paramNum()) return;
+                BLINKER_LOG_ALL(BLINKER_F("PIN_SET: "), _slaverAT->getParam(PIN_SET));
+                BLINKER_LOG_ALL(BLINKER_F("PIN_MODE: "), _slaverAT->getParam(PIN_MODE));
+                BLINKER_LOG_ALL(BLINKER_F("PIN_PULLSTATE: "), _slaverAT->getParam(PIN_PULLSTATE));
 
-            uint8_t set_pin = (_slaverAT->getParam(PIN_SET)).toInt();
-            uint8_t set_mode = (_slaverAT->getParam(PIN_MODE)).toInt();
-            uint8_t set_pull = (_slaverAT->getParam(PIN_PULLSTATE)).toInt();
+                if (BLINKER_IOSETCFG_PARAM_NUM != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            if (set_pin >= BLINKER_MAX_PIN_NUM ||
-                set_mode > BLINKER_IO_OUTPUT_NUM ||
-                set_pull > 2)
-            {
-                return;
-            }
+                uint8_t set_pin = (_slaverAT->getParam(PIN_SET)).toInt();
+                uint8_t set_mode = (_slaverAT->getParam(PIN_MODE)).toInt();
+                uint8_t set_pull = (_slaverAT->getParam(PIN_PULLSTATE)).toInt();
 
-            if (pinDataNum == 0) {
-                _pinData[pinDataNum] = new PinData(set_pin, set_mode, set_pull);
-                pinDataNum++;
-            }
-            else {
-                bool _isSet = false;
-                for (uint8_t _num = 0; _num < pinDataNum; _num++)
+                if (set_pin >= BLINKER_MAX_PIN_NUM ||
+                    set_mode > BLINKER_IO_OUTPUT_NUM ||
+                    set_pull > 2)
                 {
-                    if (_pinData[_num]->checkPin(set_pin))
-                    {
-                        _isSet = true;
-                        _pinData[_num]->fresh(set_mode, set_pull);
-                    }
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
                 }
-                if (!_isSet) {
+
+                if (pinDataNum == 0) {
                     _pinData[pinDataNum] = new PinData(set_pin, set_mode, set_pull);
                     pinDataNum++;
                 }
+                else {
+                    bool _isSet = false;
+                    for (uint8_t _num = 0; _num < pinDataNum; _num++)
+                    {
+                        if (_pinData[_num]->checkPin(set_pin))
+                        {
+                            _isSet = true;
+                            _pinData[_num]->fresh(set_mode, set_pull);
+                        }
+                    }
+                    if (!_isSet) {
+                        _pinData[pinDataNum] = new PinData(set_pin, set_mode, set_pull);
+                        pinDataNum++;
+                    }
+                }
+
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
+            case AT_CMD_IOGETCFG :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_IOGETCFG && _slaverAT->state() == AT_SETTING) {
-            BLINKER_LOG_ALL(BLINKER_F("PIN_SET: "), _slaverAT->getParam(PIN_SET));
+                BLINKER_LOG_ALL(BLINKER_F("PIN_SET: "), _slaverAT->getParam(PIN_SET));
 
-            if (BLINKER_IOGETCFG_PARAM_NUM != _slaverAT->paramNum()) return;
+                if (BLINKER_IOGETCFG_PARAM_NUM != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            uint8_t set_pin = (_slaverAT->getParam(PIN_SET)).toInt();
+                uint8_t set_pin = (_slaverAT->getParam(PIN_SET)).toInt();
 
-            if (set_pin >= BLINKER_MAX_PIN_NUM) return;
+                if (set_pin >= BLINKER_MAX_PIN_NUM)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            bool _isGet = false;
-            for (uint8_t _num = 0; _num < pinDataNum; _num++)
-            {
-                if (_pinData[_num]->checkPin(set_pin))
+                bool _isGet = false;
+                for (uint8_t _num = 0; _num < pinDataNum; _num++)
                 {
-                    _isGet = true;
+                    if (_pinData[_num]->checkPin(set_pin))
+                    {
+                        _isGet = true;
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_IOGETCFG;
+                        reqData += BLINKER_F(":");
+                        reqData += _pinData[_num]->data();
+                        BProto::serialPrint(reqData);
+                    }
+                }
+                if (!_isGet) {
                     reqData = BLINKER_F("+");
                     reqData += BLINKER_CMD_IOGETCFG;
                     reqData += BLINKER_F(":");
-                    reqData += _pinData[_num]->data();
+                    reqData += _slaverAT->getParam(PIN_SET);
+                    reqData += BLINKER_F(",2,0");
                     BProto::serialPrint(reqData);
                 }
+
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
-            if (!_isGet) {
-                reqData = BLINKER_F("+");
-                reqData += BLINKER_CMD_IOGETCFG;
-                reqData += BLINKER_F(":");
-                reqData += _slaverAT->getParam(PIN_SET);
-                reqData += BLINKER_F(",2,0");
-                BProto::serialPrint(reqData);
-            }
+            case AT_CMD_GPIOWRITE :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_GPIOWRITE && _slaverAT->state() == AT_SETTING) {
-            BLINKER_LOG_ALL(BLINKER_F("IO_PIN: "), _slaverAT->getParam(IO_PIN));
-            BLINKER_LOG_ALL(BLINKER_F("IO_LVL: "),  _slaverAT->getParam(IO_LVL));
+                BLINKER_LOG_ALL(BLINKER_F("IO_PIN: "), _slaverAT->getParam(IO_PIN));
+                BLINKER_LOG_ALL(BLINKER_F("IO_LVL: "),  _slaverAT->getParam(IO_LVL));
 
-            if (BLINKER_GPIOWRITE_PARAM_NUM != _slaverAT->paramNum()) return;
+                if (BLINKER_GPIOWRITE_PARAM_NUM != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            uint8_t set_pin = (_slaverAT->getParam(IO_PIN)).toInt();
-            uint8_t set_lvl = (_slaverAT->getParam(IO_LVL)).toInt();
+                uint8_t set_pin = (_slaverAT->getParam(IO_PIN)).toInt();
+                uint8_t set_lvl = (_slaverAT->getParam(IO_LVL)).toInt();
 
-            if (set_pin >= BLINKER_MAX_PIN_NUM) return;
+                if (set_pin >= BLINKER_MAX_PIN_NUM)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            // bool _isSet = false;
-            for (uint8_t _num = 0; _num < pinDataNum; _num++)
-            {
-                if (_pinData[_num]->checkPin(set_pin))
+                // bool _isSet = false;
+                for (uint8_t _num = 0; _num < pinDataNum; _num++)
                 {
-                    if (_pinData[_num]->getMode() == BLINKER_IO_OUTPUT_NUM)
+                    if (_pinData[_num]->checkPin(set_pin))
                     {
-                        if (set_lvl <= 1) {
-                            digitalWrite(set_pin, set_lvl ? HIGH : LOW);
-                            BProto::serialPrint(BLINKER_CMD_OK);
-                            return;
+                        if (_pinData[_num]->getMode() == BLINKER_IO_OUTPUT_NUM)
+                        {
+                            if (set_lvl <= 1) {
+                                digitalWrite(set_pin, set_lvl ? HIGH : LOW);
+                                BProto::serialPrint(BLINKER_CMD_OK);
+                                return;
+                            }
                         }
                     }
                 }
+
+                BProto::serialPrint(BLINKER_CMD_ERROR);
+                break;
             }
+            case AT_CMD_GPIOWREAD :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(BLINKER_CMD_ERROR);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_GPIOWREAD && _slaverAT->state() == AT_SETTING) {
-            BLINKER_LOG_ALL(BLINKER_F("IO_PIN: "), _slaverAT->getParam(IO_PIN));
+                BLINKER_LOG_ALL(BLINKER_F("IO_PIN: "), _slaverAT->getParam(IO_PIN));
 
-            if (BLINKER_GPIOREAD_PARAM_NUM != _slaverAT->paramNum()) return;
+                if (BLINKER_GPIOREAD_PARAM_NUM != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            uint8_t set_pin = (_slaverAT->getParam(IO_PIN)).toInt();
+                uint8_t set_pin = (_slaverAT->getParam(IO_PIN)).toInt();
 
-            if (set_pin >= BLINKER_MAX_PIN_NUM)
-            {
-                BProto::serialPrint(BLINKER_CMD_ERROR);
-                return;
-            }
+                if (set_pin >= BLINKER_MAX_PIN_NUM)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            // bool _isSet = false;
-            for (uint8_t _num = 0; _num < pinDataNum; _num++)
-            {
-                if (_pinData[_num]->checkPin(set_pin))
+                // bool _isSet = false;
+                for (uint8_t _num = 0; _num < pinDataNum; _num++)
                 {
-                    // if (_pinData[_num]->getMode() == BLINKER_IO_INPUT_NUM)
-                    // {
-                    //     if (set_lvl <= 1) {
-                            reqData = BLINKER_F("+");
-                            reqData += BLINKER_CMD_GPIOWREAD;
-                            reqData += BLINKER_F(":");
-                            reqData += STRING_format(set_pin);
-                            reqData += BLINKER_F(",");
-                            reqData += STRING_format(_pinData[_num]->getMode());
-                            reqData += BLINKER_F(",");
-                            reqData += STRING_format(digitalRead(set_pin));
-                            BProto::serialPrint(reqData);
-                            BProto::serialPrint(BLINKER_CMD_OK);
-                            return;
-                    //     }
-                    // }
+                    if (_pinData[_num]->checkPin(set_pin))
+                    {
+                        // if (_pinData[_num]->getMode() == BLINKER_IO_INPUT_NUM)
+                        // {
+                        //     if (set_lvl <= 1) {
+                                reqData = BLINKER_F("+");
+                                reqData += BLINKER_CMD_GPIOWREAD;
+                                reqData += BLINKER_F(":");
+                                reqData += STRING_format(set_pin);
+                                reqData += BLINKER_F(",");
+                                reqData += STRING_format(_pinData[_num]->getMode());
+                                reqData += BLINKER_F(",");
+                                reqData += STRING_format(digitalRead(set_pin));
+                                BProto::serialPrint(reqData);
+                                BProto::serialPrint(BLINKER_CMD_OK);
+                                return;
+                        //     }
+                        // }
+                    }
                 }
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_GPIOWREAD;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(set_pin);
+                reqData += BLINKER_F(",3,");
+                reqData += STRING_format(digitalRead(set_pin));
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                // BProto::serialPrint(BLINKER_CMD_ERROR);
+                break;
             }
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_GPIOWREAD;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(set_pin);
-            reqData += BLINKER_F(",3,");
-            reqData += STRING_format(digitalRead(set_pin));
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-            // BProto::serialPrint(BLINKER_CMD_ERROR);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_BLINKER_MQTT) {
-            // BProto::serialPrint(BLINKER_CMD_OK);
+            case AT_CMD_BLINKER_MQTT :
+            {
+                // wlan config may block, send queued responses first
+                BProto::serialFlush();
+
+                // BProto::serialPrint(BLINKER_CMD_OK);
+
+                BLINKER_LOG(BLINKER_CMD_BLINKER_MQTT);
+
+                blinker_at_state_t at_state = _slaverAT->state();
+
+                BLINKER_LOG(at_state);
+
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_MQTT;
+                        reqData += BLINKER_F("=<MQTT_CONFIG_MODE>,<MQTT_AUTH_KEY>");
+                        reqData += BLINKER_F("[,<MQTT_WIFI_SSID>,<MQTT_WIFI_PSWD>]");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_MQTT;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(_wlanMode);
+                        reqData += BLINKER_F(",");
+                        reqData += STRING_format(BProto::authKey());
+                        reqData += BLINKER_F(",");
+                        reqData += WiFi.SSID();
+                        reqData += BLINKER_F(",");
+                        reqData += WiFi.psk();
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("MQTT_CONFIG_MODE: "), _slaverAT->getParam(MQTT_CONFIG_MODE));
+                        BLINKER_LOG_ALL(BLINKER_F("MQTT_AUTH_KEY: "),  _slaverAT->getParam(MQTT_AUTH_KEY));
+                        BLINKER_LOG_ALL(BLINKER_F("MQTT_WIFI_SSID: "), _slaverAT->getParam(MQTT_WIFI_SSID));
+                        BLINKER_LOG_ALL(BLINKER_F("MQTT_WIFI_PSWD: "), _slaverAT->getParam(MQTT_WIFI_PSWD));
+
+                        if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_COMCONFIG_NUM)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("BLINKER_CMD_COMWLAN"));
+
+                            if (BLINKER_COMWLAN_PARAM_NUM != _slaverAT->paramNum())
+                            {
+                                BProto::serialPrint(BLINKER_CMD_ERROR);
+                                return;
+                            }
+
+                            if (_status == BL_INITED)
+                            {
+                                reqData = BLINKER_F("+");
+                                reqData += BLINKER_CMD_BLINKER_MQTT;
+                                reqData += BLINKER_F(":");
+                                reqData += BProto::deviceId();
+                                reqData += BLINKER_F(",");
+                                reqData += BProto::uuid();
+                                BProto::serialPrint(reqData);
+                                BProto::serialPrint(BLINKER_CMD_OK);
+                                return;
+                            }
+
+                            BProto::connectWiFi((_slaverAT->getParam(MQTT_WIFI_SSID)).c_str(),
+                                        (_slaverAT->getParam(MQTT_WIFI_PSWD)).c_str());
+
+                            BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
+                            _status = BL_INITED;
+                            _wlanMode = BLINKER_CMD_COMCONFIG_NUM;
+                        }
+                        else if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_SMARTCONFIG_NUM)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("BLINKER_CMD_SMARTCONFIG"));
+
+                            if (BLINKER_SMCFG_PARAM_NUM != _slaverAT->paramNum())
+                            {
+                                BProto::serialPrint(BLINKER_CMD_ERROR);
+                                return;
+                            }
+
+                            if (_status == BL_INITED)
+                            {
+                                reqData = BLINKER_F("+");
+                                reqData += BLINKER_CMD_BLINKER_MQTT;
+                                reqData += BLINKER_F(":");
+                                reqData += BProto::deviceId();
+                                reqData += BLINKER_F(",");
+                                reqData += BProto::uuid();
+                                BProto::serialPrint(reqData);
+                                BProto::serialPrint(BLINKER_CMD_OK);
+                                return;
+                            }
+
+                            // if (!BProto::autoInit())
+                            BProto::smartconfig();
 
-            BLINKER_LOG(BLINKER_CMD_BLINKER_MQTT);
+                            BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
+                            _status = BL_INITED;
+                            _wlanMode = BLINKER_CMD_SMARTCONFIG_NUM;
+                        }
+                        else if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_APCONFIG_NUM)
+                        {
+                            BLINKER_LOG(BLINKER_F("BLINKER_CMD_APCONFIG"));
 
-            blinker_at_state_t at_state = _slaverAT->state();
+                            if (BLINKER_APCFG_PARAM_NUM != _slaverAT->paramNum())
+                            {
+                                BProto::serialPrint(BLINKER_CMD_ERROR);
+                                return;
+                            }
 
-            BLINKER_LOG(at_state);
+                            if (_status == BL_INITED)
+                            {
+                                reqData = BLINKER_F("+");
+                                reqData += BLINKER_CMD_BLINKER_MQTT;
+                                reqData += BLINKER_F(":");
+                                reqData += BProto::deviceId();
+                                reqData += BLINKER_F(",");
+                                reqData += BProto::uuid();
+                                BProto::serialPrint(reqData);
+                                BProto::serialPrint(BLINKER_CMD_OK);
+                                return;
+                            }
 
-            switch (at_state)
+                            if (!BProto::autoInit())
+                            {
+                                BProto::softAPinit();
+                                // while(WiFi.status() != WL_CONNECTED) {
+                                //     BProto::serverClient();
+
+                                //     ::delay(10);
+                                // }
+                            }
+
+                            BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
+                            _status = BL_INITED;
+                            _wlanMode = BLINKER_CMD_APCONFIG_NUM;
+                        }
+                        else {
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
+                            return;
+                        }
+
+                        // reqData = BLINKER_F("+");
+                        // reqData += BLINKER_CMD_BLINKER_MQTT;
+                        // reqData += BLINKER_F(":");
+                        // reqData += BProto::deviceId();
+                        // reqData += BLINKER_F(",");
+                        // reqData += BProto::uuid();
+                        // BProto::serialPrint(reqData);
+                        // BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
+            }
+            case AT_CMD_BLINKER_ALIGENIE :
             {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_MQTT;
-                    reqData += BLINKER_F("=<MQTT_CONFIG_MODE>,<MQTT_AUTH_KEY>");
-                    reqData += BLINKER_F("[,<MQTT_WIFI_SSID>,<MQTT_WIFI_PSWD>]");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_MQTT;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(_wlanMode);
-                    reqData += BLINKER_F(",");
-                    reqData += STRING_format(BProto::authKey());
-                    reqData += BLINKER_F(",");
-                    reqData += WiFi.SSID();
-                    reqData += BLINKER_F(",");
-                    reqData += WiFi.psk();
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("MQTT_CONFIG_MODE: "), _slaverAT->getParam(MQTT_CONFIG_MODE));
-                    BLINKER_LOG_ALL(BLINKER_F("MQTT_AUTH_KEY: "),  _slaverAT->getParam(MQTT_AUTH_KEY));
-                    BLINKER_LOG_ALL(BLINKER_F("MQTT_WIFI_SSID: "), _slaverAT->getParam(MQTT_WIFI_SSID));
-                    BLINKER_LOG_ALL(BLINKER_F("MQTT_WIFI_PSWD: "), _slaverAT->getParam(MQTT_WIFI_PSWD));
+                // BProto::serialPrint(BLINKER_CMD_OK);
 
-                    if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_COMCONFIG_NUM)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("BLINKER_CMD_COMWLAN"));
+                BLINKER_LOG(BLINKER_CMD_BLINKER_ALIGENIE);
+
+                blinker_at_state_t at_state = _slaverAT->state();
 
-                        if (BLINKER_COMWLAN_PARAM_NUM != _slaverAT->paramNum()) return;
+                BLINKER_LOG_ALL(at_state);
+
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_ALIGENIE;
+                        reqData += BLINKER_F("=<type>");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_ALIGENIE;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(_aliType);
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("BLINKER_ALIGENIE_CFG_NUM: "), _slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM));
 
-                        if (_status == BL_INITED)
+                        if (BLINKER_ALIGENIE_PARAM_NUM != _slaverAT->paramNum())
                         {
-                            reqData = BLINKER_F("+");
-                            reqData += BLINKER_CMD_BLINKER_MQTT;
-                            reqData += BLINKER_F(":");
-                            reqData += BProto::deviceId();
-                            reqData += BLINKER_F(",");
-                            reqData += BProto::uuid();
-                            BProto::serialPrint(reqData);
-                            BProto::serialPrint(BLINKER_CMD_OK);
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
                             return;
                         }
 
-                        BProto::connectWiFi((_slaverAT->getParam(MQTT_WIFI_SSID)).c_str(),
-                                    (_slaverAT->getParam(MQTT_WIFI_PSWD)).c_str());
+                        if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_LIGHT)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("ALI_LIGHT"));
+                            _aliType = ALI_LIGHT;
+                        }
+                        else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_OUTLET)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("ALI_OUTLET"));
+                            _aliType = ALI_OUTLET;
+                        }
+                        else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_SENSOR)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("ALI_SENSOR"));
+                            _aliType = ALI_SENSOR;
+                        }
+                        else {
+                            BLINKER_LOG_ALL(BLINKER_F("ALI_NONE"));
+                            _aliType = ALI_NONE;
+                        }
+                        BProto::aligenieType(_aliType);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
+            }
+            case AT_CMD_BLINKER_DUEROS :
+            {
+                // BProto::serialPrint(BLINKER_CMD_OK);
+
+                BLINKER_LOG(BLINKER_CMD_BLINKER_DUEROS);
 
-                        BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
-                        _status = BL_INITED;
-                        _wlanMode = BLINKER_CMD_COMCONFIG_NUM;
-                    }
-                    else if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_SMARTCONFIG_NUM)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("BLINKER_CMD_SMARTCONFIG"));
+                blinker_at_state_t at_state = _slaverAT->state();
+
+                BLINKER_LOG_ALL(at_state);
 
-                        if (BLINKER_SMCFG_PARAM_NUM != _slaverAT->paramNum()) return;
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_DUEROS;
+                        reqData += BLINKER_F("=<type>");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_DUEROS;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(_duerType);
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("BLINKER_DUEROS_CFG_NUM: "), _slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM));
 
-                        if (_status == BL_INITED)
+                        if (BLINKER_DUEROS_PARAM_NUM != _slaverAT->paramNum())
                         {
-                            reqData = BLINKER_F("+");
-                            reqData += BLINKER_CMD_BLINKER_MQTT;
-                            reqData += BLINKER_F(":");
-                            reqData += BProto::deviceId();
-                            reqData += BLINKER_F(",");
-                            reqData += BProto::uuid();
-                            BProto::serialPrint(reqData);
-                            BProto::serialPrint(BLINKER_CMD_OK);
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
                             return;
                         }
 
-                        // if (!BProto::autoInit())
-                        BProto::smartconfig();
-
-                        BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
-                        _status = BL_INITED;
-                        _wlanMode = BLINKER_CMD_SMARTCONFIG_NUM;
-                    }
-                    else if ((_slaverAT->getParam(MQTT_CONFIG_MODE)).toInt() == BLINKER_CMD_APCONFIG_NUM)
-                    {
-                        BLINKER_LOG(BLINKER_F("BLINKER_CMD_APCONFIG"));
-
-                        if (BLINKER_APCFG_PARAM_NUM != _slaverAT->paramNum()) return;
-
-                        if (_status == BL_INITED)
+                        if ((_slaverAT->getParam(BLINKER_DUEROS_CFG_NUM)).toInt() == ALI_LIGHT)
                         {
-                            reqData = BLINKER_F("+");
-                            reqData += BLINKER_CMD_BLINKER_MQTT;
-                            reqData += BLINKER_F(":");
-                            reqData += BProto::deviceId();
-                            reqData += BLINKER_F(",");
-                            reqData += BProto::uuid();
-                            BProto::serialPrint(reqData);
-                            BProto::serialPrint(BLINKER_CMD_OK);
-                            return;
+                            BLINKER_LOG_ALL(BLINKER_F("DUER_LIGHT"));
+                            _duerType = DUER_LIGHT;
                         }
-
-                        if (!BProto::autoInit())
+                        else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_OUTLET)
                         {
-                            BProto::softAPinit();
-                            // while(WiFi.status() != WL_CONNECTED) {
-                            //     BProto::serverClient();
-
-                            //     ::delay(10);
-                            // }
+                            BLINKER_LOG_ALL(BLINKER_F("DUER_OUTLET"));
+                            _duerType = DUER_OUTLET;
                         }
+                        else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_SENSOR)
+                        {
+                            BLINKER_LOG_ALL(BLINKER_F("DUER_SENSOR"));
+                            _duerType = DUER_SENSOR;
+                        }
+                        else {
+                            BLINKER_LOG_ALL(BLINKER_F("DUER_NONE"));
+                            _duerType = DUER_NONE;
+                        }
+                        BProto::duerType(_duerType);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
+            }
+            case AT_CMD_TIMEZONE :
+            {
 
-                        BProto::begin((_slaverAT->getParam(MQTT_AUTH_KEY)).c_str());
-                        _status = BL_INITED;
-                        _wlanMode = BLINKER_CMD_APCONFIG_NUM;
-                    }
-                    else {
-                        return;
-                    }
+                BLINKER_LOG(BLINKER_CMD_TIMEZONE);
 
-                    // reqData = BLINKER_F("+");
-                    // reqData += BLINKER_CMD_BLINKER_MQTT;
-                    // reqData += BLINKER_F(":");
-                    // reqData += BProto::deviceId();
-                    // reqData += BLINKER_F(",");
-                    // reqData += BProto::uuid();
-                    // BProto::serialPrint(reqData);
-                    // BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
-                    break;
-            }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_BLINKER_ALIGENIE) {
-            // BProto::serialPrint(BLINKER_CMD_OK);
+                blinker_at_state_t at_state = _slaverAT->state();
 
-            BLINKER_LOG(BLINKER_CMD_BLINKER_ALIGENIE);
+                BLINKER_LOG(at_state);
+
+                switch (at_state)
+                {
+                    case AT_NONE:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    case AT_TEST:
+                        reqData = BLINKER_CMD_AT;
+                        reqData += BLINKER_F("+");
+                        reqData += BLINKER_CMD_TIMEZONE;
+                        reqData += BLINKER_F("=<TIMEZONE>");
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_QUERY:
+                        reqData = BLINKER_F("+");
+                        reqData += BLINKER_CMD_BLINKER_MQTT;
+                        reqData += BLINKER_F(":");
+                        reqData += STRING_format(getTimezone());
+                        BProto::serialPrint(reqData);
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_SETTING:
+                        BLINKER_LOG_ALL(BLINKER_F("BLINKER_TIMEZONE_CFG_NUM: "), _slaverAT->getParam(BLINKER_TIMEZONE_CFG_NUM));
 
-            blinker_at_state_t at_state = _slaverAT->state();
+                        if (BLINKER_TIMEZONE_PARAM_NUM != _slaverAT->paramNum())
+                        {
+                            BProto::serialPrint(BLINKER_CMD_ERROR);
+                            return;
+                        }
 
-            BLINKER_LOG_ALL(at_state);
+                        setTimezone((_slaverAT->getParam(BLINKER_TIMEZONE_CFG_NUM)).toFloat());
 
-            switch (at_state)
+                        BProto::serialPrint(BLINKER_CMD_OK);
+                        break;
+                    case AT_ACTION:
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                    default :
+                        BProto::serialPrint(BLINKER_CMD_ERROR);
+                        break;
+                }
+                break;
+            }
+            case AT_CMD_TIME :
             {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_ALIGENIE;
-                    reqData += BLINKER_F("=<type>");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_ALIGENIE;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(_aliType);
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
                     break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("BLINKER_ALIGENIE_CFG_NUM: "), _slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM));
+                }
 
-                    if (BLINKER_ALIGENIE_PARAM_NUM != _slaverAT->paramNum()) return;
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_TIME_AT;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(time());
 
-                    if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_LIGHT)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("ALI_LIGHT"));
-                        _aliType = ALI_LIGHT;
-                    }
-                    else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_OUTLET)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("ALI_OUTLET"));
-                        _aliType = ALI_OUTLET;
-                    }
-                    else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_SENSOR)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("ALI_SENSOR"));
-                        _aliType = ALI_SENSOR;
-                    }
-                    else {
-                        BLINKER_LOG_ALL(BLINKER_F("ALI_NONE"));
-                        _aliType = ALI_NONE;
-                    }
-                    BProto::aligenieType(_aliType);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
-                    break;
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_BLINKER_DUEROS) {
-            // BProto::serialPrint(BLINKER_CMD_OK);
+            case AT_CMD_SECOND :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BLINKER_LOG(BLINKER_CMD_BLINKER_DUEROS);
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_SECOND;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(second());
 
-            blinker_at_state_t at_state = _slaverAT->state();
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_MINUTE :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BLINKER_LOG_ALL(at_state);
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_MINUTE;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(minute());
 
-            switch (at_state)
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_HOUR :
             {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_DUEROS;
-                    reqData += BLINKER_F("=<type>");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_DUEROS;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(_duerType);
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
                     break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("BLINKER_DUEROS_CFG_NUM: "), _slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM));
+                }
 
-                    if (BLINKER_DUEROS_PARAM_NUM != _slaverAT->paramNum()) return;
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_HOUR;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(hour());
 
-                    if ((_slaverAT->getParam(BLINKER_DUEROS_CFG_NUM)).toInt() == ALI_LIGHT)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("DUER_LIGHT"));
-                        _duerType = DUER_LIGHT;
-                    }
-                    else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_OUTLET)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("DUER_OUTLET"));
-                        _duerType = DUER_OUTLET;
-                    }
-                    else if ((_slaverAT->getParam(BLINKER_ALIGENIE_CFG_NUM)).toInt() == ALI_SENSOR)
-                    {
-                        BLINKER_LOG_ALL(BLINKER_F("DUER_SENSOR"));
-                        _duerType = DUER_SENSOR;
-                    }
-                    else {
-                        BLINKER_LOG_ALL(BLINKER_F("DUER_NONE"));
-                        _duerType = DUER_NONE;
-                    }
-                    BProto::duerType(_duerType);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
-                    break;
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_TIMEZONE) {
+            case AT_CMD_WDAY :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BLINKER_LOG(BLINKER_CMD_TIMEZONE);
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_WDAY;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(wday());
 
-            blinker_at_state_t at_state = _slaverAT->state();
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_MDAY :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BLINKER_LOG(at_state);
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_MDAY;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(mday());
 
-            switch (at_state)
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_YDAY :
             {
-                case AT_NONE:
-                    // BProto::serialPrint();
-                    break;
-                case AT_TEST:
-                    reqData = BLINKER_CMD_AT;
-                    reqData += BLINKER_F("+");
-                    reqData += BLINKER_CMD_TIMEZONE;
-                    reqData += BLINKER_F("=<TIMEZONE>");
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_QUERY:
-                    reqData = BLINKER_F("+");
-                    reqData += BLINKER_CMD_BLINKER_MQTT;
-                    reqData += BLINKER_F(":");
-                    reqData += STRING_format(getTimezone());
-                    BProto::serialPrint(reqData);
-                    BProto::serialPrint(BLINKER_CMD_OK);
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
                     break;
-                case AT_SETTING:
-                    BLINKER_LOG_ALL(BLINKER_F("BLINKER_TIMEZONE_CFG_NUM: "), _slaverAT->getParam(BLINKER_TIMEZONE_CFG_NUM));
-
-                    if (BLINKER_TIMEZONE_PARAM_NUM != _slaverAT->paramNum()) return;
+                }
 
-                    setTimezone((_slaverAT->getParam(BLINKER_TIMEZONE_CFG_NUM)).toFloat());
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_YDAY;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(yday());
 
-                    BProto::serialPrint(BLINKER_CMD_OK);
-                    break;
-                case AT_ACTION:
-                    // BProto::serialPrint();
-                    break;
-                default :
-                    break;
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
             }
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_TIME_AT && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_TIME_AT;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(time());
-
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_SECOND && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_SECOND;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(second());
-
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_SECOND && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_SECOND;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(second());
+            case AT_CMD_MONTH :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_MINUTE && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_MINUTE;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(minute());
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_MONTH;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(month());
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_HOUR && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_HOUR;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(hour());
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_YEAR :
+            {
+                if (_slaverAT->state() != AT_QUERY)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_WDAY && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_WDAY;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(wday());
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_YEAR;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(year());
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_MDAY && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_MDAY;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(mday());
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_WEATHER :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_YDAY && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_YDAY;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(yday());
+                if (1 != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_MONTH && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_MONTH;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(month());
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_WEATHER_AT;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(weather(_slaverAT->getParam(0)));
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_YEAR && _slaverAT->state() == AT_QUERY) {
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_YEAR;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(year());
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_AQI :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_WEATHER_AT && _slaverAT->state() == AT_SETTING) {
-            if (1 != _slaverAT->paramNum()) return;
+                if (1 != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_WEATHER_AT;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(weather(_slaverAT->getParam(0)));
+                reqData = BLINKER_F("+");
+                reqData += BLINKER_CMD_AQI_AT;
+                reqData += BLINKER_F(":");
+                reqData += STRING_format(aqi(_slaverAT->getParam(0)));
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_AQI_AT && _slaverAT->state() == AT_SETTING) {
-            if (1 != _slaverAT->paramNum()) return;
+                BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_NOTICE :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            reqData = BLINKER_F("+");
-            reqData += BLINKER_CMD_AQI_AT;
-            reqData += BLINKER_F(":");
-            reqData += STRING_format(aqi(_slaverAT->getParam(0)));
+                if (1 != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_NOTICE_AT && _slaverAT->state() == AT_SETTING) {
-            if (1 != _slaverAT->paramNum()) return;
+                // reqData = "+" + STRING_format(BLINKER_CMD_NOTICE_AT) +
+                //         ":" + STRING_format(aqi(_slaverAT->getParam(0)));
+                notify(_slaverAT->getParam(0));
+                // BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            case AT_CMD_SMS :
+            {
+                if (_slaverAT->state() != AT_SETTING)
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    break;
+                }
 
-            // reqData = "+" + STRING_format(BLINKER_CMD_NOTICE_AT) +
-            //         ":" + STRING_format(aqi(_slaverAT->getParam(0)));
-            notify(_slaverAT->getParam(0));
-            // BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
-        }
-        else if (_slaverAT->cmd() == BLINKER_CMD_SMS_AT && _slaverAT->state() == AT_SETTING) {
-            if (1 != _slaverAT->paramNum()) return;
+                if (1 != _slaverAT->paramNum())
+                {
+                    BProto::serialPrint(BLINKER_CMD_ERROR);
+                    return;
+                }
 
-            // reqData = "+" + STRING_format(BLINKER_CMD_NOTICE_AT) +
-            //         ":" + STRING_format(aqi(_slaverAT->getParam(0)));
-            sms(_slaverAT->getParam(0));
-            // BProto::serialPrint(reqData);
-            BProto::serialPrint(BLINKER_CMD_OK);
+                // reqData = "+" + STRING_format(BLINKER_CMD_NOTICE_AT) +
+                //         ":" + STRING_format(aqi(_slaverAT->getParam(0)));
+                sms(_slaverAT->getParam(0));
+                // BProto::serialPrint(reqData);
+                BProto::serialPrint(BLINKER_CMD_OK);
+                break;
+            }
+            default :
+                BProto::serialPrint(BLINKER_CMD_ERROR);
+                break;
         }
     }
 
@@ -10912,9 +11373,11 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
 
     bool BlinkerApi::serialAvailable()
     {
-        if (BProto::serialAvailable())
+        if (_slaverAT == NULL) _slaverAT = new BlinkerSlaverAT();
+
+        for (uint8_t num = 0; num < BLINKER_AT_PIPELINE_SIZE; num++)
         {
-            _slaverAT = new BlinkerSlaverAT();
+            if (!BProto::serialAvailable()) break;
 
             _slaverAT->update(BProto::serialLastRead());
 
@@ -10922,23 +11385,19 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             BLINKER_LOG_ALL(BLINKER_F("cmd: "), _slaverAT->cmd());
             BLINKER_LOG_ALL(BLINKER_F("paramNum: "), _slaverAT->paramNum());
 
-            if (_slaverAT->state())
+            if (!_slaverAT->state())
             {
-                parseATdata();
+                BProto::serialFlush();
 
-                free(_slaverAT);
-
-                return false;
+                return true;
             }
 
-            free(_slaverAT);
-
-            return true;
-        }
-        else
-        {
-            return false;
+            parseATdata();
         }
+
+        BProto::serialFlush();
+
+        return false;
     }
 
     void BlinkerApi::serialPrint(const String & s)
@@ -11014,13 +11473,13 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         while (!BProto::isAvail)
         {
             run();
-            ::delay(1);
+            yield();
             if (millis() - at_start > BLINKER_AT_MSG_TIMEOUT) break;
         }
 
         BLINKER_LOG_ALL(BLINKER_F("parseATdata"));
 
-        _masterAT = new BlinkerMasterAT();
+        if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
         _masterAT->update(STRING_format(BProto::dataParse()));
 
         BLINKER_LOG_ALL(BLINKER_F("getState: "), _masterAT->getState());
@@ -11092,14 +11551,9 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             // if (BProto::available())
             if (BProto::isAvail)
             {
-                // if (!_masterAT) {
-                _masterAT = new BlinkerMasterAT();
+                if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
 
                 _masterAT->update(STRING_format(BProto::dataParse()));
-                // }
-                // else {
-                //     _masterAT->update(STRING_format(BProto::dataParse()));
-                // }
 
                 BLINKER_LOG_ALL(BLINKER_F("getState: "), _masterAT->getState());
                 BLINKER_LOG_ALL(BLINKER_F("reqName: "), _masterAT->reqName());
@@ -11114,7 +11568,6 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     BLINKER_LOG_ALL(BLINKER_F("ESP AT init"));
                 }
 
-                free(_masterAT);
             }
         }
     }
@@ -11132,13 +11585,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             _masterAT->reqName() == BLINKER_CMD_ADC) {
 
             int a_read = _masterAT->getParam(0).toInt();
-            free(_masterAT);
 
             return a_read;
         }
         else {
-            free(_masterAT);
-
             return 0;
         }
     }
@@ -11207,13 +11657,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             _masterAT->reqName() == BLINKER_CMD_GPIOWREAD) {
 
             int d_read = _masterAT->getParam(2).toInt();
-            free(_masterAT);
 
             return d_read;
         }
         else {
-            free(_masterAT);
-
             return 0;
         }
     }
@@ -11242,13 +11689,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             _masterAT->reqName() == BLINKER_CMD_TIMEZONE) {
 
             float tz_read = _masterAT->getParam(0).toFloat();
-            free(_masterAT);
 
             return tz_read;
         }
         else {
-            free(_masterAT);
-
             return 8.0;
         }
     }
@@ -11266,13 +11710,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             _masterAT->reqName() == cmd) {
 
             int32_t at_read = _masterAT->getParam(0).toInt();
-            free(_masterAT);
 
             return at_read;
         }
         else {
-            free(_masterAT);
-
             return 0;
         }
     }
@@ -11292,13 +11733,10 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             _masterAT->reqName() == cmd) {
 
             String at_read = _masterAT->getParam(0);
-            free(_masterAT);
 
             return at_read;
         }
         else {
-            free(_masterAT);
-
             return "";
         }
     }
@@ -11622,7 +12060,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             case NB_INITED :
                 if (BProto::isAvail)
                 {
-                    _masterAT = new BlinkerMasterAT();
+                    if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
                     _masterAT->update(STRING_format(BProto::dataParse()));
 
                     if (_masterAT->getState() != AT_M_NONE &&
@@ -11650,8 +12088,6 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     }
 
                     nb_run_time = millis();
-
-                    free(_masterAT);
                 }
                 else if (millis() - nb_run_time > BLINKER_NB_STREAM_TIMEOUT)
                 {
@@ -11690,7 +12126,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             case NB_CGATT_SUCCESS :
                 if (BProto::isAvail)
                 {
-                    _masterAT = new BlinkerMasterAT();
+                    if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
                     _masterAT->update(STRING_format(BProto::dataParse()));
 
                     if (_masterAT->getState() != AT_M_NONE &&
@@ -11727,8 +12163,6 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     }
 
                     nb_run_time = millis();
-
-                    free(_masterAT);
                 }
 
                 else if (millis() - nb_run_time > BLINKER_NB_STREAM_TIMEOUT)
@@ -11754,7 +12188,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             case NB_MIPLC_FAILED :
                 if (BProto::isAvail)
                 {
-                    _masterAT = new BlinkerMasterAT();
+                    if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
                     _masterAT->update(STRING_format(BProto::dataParse()));
 
                     if (_masterAT->getState() != AT_M_NONE &&
@@ -11785,8 +12219,6 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     }
 
                     nb_run_time = millis();
-
-                    free(_masterAT);
                 }
                 else if (millis() - nb_run_time > BLINKER_NB_STREAM_TIMEOUT)
                 {
@@ -11826,7 +12258,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             case NB_MIPLOPEN_SUCCESS :
                 if (BProto::isAvail)
                 {
-                    _masterAT = new BlinkerMasterAT();
+                    if (_masterAT == NULL) _masterAT = new BlinkerMasterAT();
                     _masterAT->update(STRING_format(BProto::dataParse()));
 
                     if (_masterAT->getState() != AT_M_NONE &&
@@ -11841,8 +12273,6 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                     }
 
                     nb_run_time = millis();
-
-                    free(_masterAT);
                 }
                 else if (millis() - nb_run_time > BLINKER_NB_STREAM_TIMEOUT)
                 {
@@ -4,6 +4,8 @@
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+#include "Blinker/BlinkerTLV.h"
 
 template <class T>
 int8_t checkNum(char * name, T * c, uint8_t count)
@@ -25,7 +27,7 @@ class BlinkerWidgets_num
     public :
         BlinkerWidgets_num(char * _name)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             autoUpdate = true;
@@ -51,7 +53,7 @@ class BlinkerWidgets_string
     public :
         BlinkerWidgets_string(char * _name, blinker_callback_with_string_arg_t _func = NULL)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             wfunc = _func;
@@ -74,7 +76,7 @@ class BlinkerWidgets_int32
     public :
         BlinkerWidgets_int32(char * _name, blinker_callback_with_int32_arg_t _func = NULL)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             wfunc = _func;
@@ -97,7 +99,7 @@ class BlinkerWidgets_rgb
     public :
         BlinkerWidgets_rgb(char * _name, blinker_callback_with_rgb_arg_t _func = NULL)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             wfunc = _func;
@@ -120,7 +122,7 @@ class BlinkerWidgets_joy
     public :
         BlinkerWidgets_joy(char * _name, blinker_callback_with_joy_arg_t _func = NULL)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             wfunc = _func;
@@ -145,7 +147,7 @@ class BlinkerWidgets_table
             blinker_callback_with_table_arg_t _func = NULL,
             blinker_callback_t _func2 = NULL)
         {
-            wName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            wName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(wName, _name);
 
             wfunc = _func;
@@ -178,7 +180,7 @@ class BlinkerWidgets_table
         public :
             BlinkerBridge_key(char * _key, blinker_callback_with_string_arg_t _func = NULL)
             {
-                bKey = (char*)malloc((strlen(_key)+1)*sizeof(char));
+                bKey = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_key)+1)*sizeof(char));
                 strcpy(bKey, _key);
 
                 wfunc = _func;
@@ -193,17 +195,70 @@ class BlinkerWidgets_table
                 if (_register) return bName;
                 else return "false";
             }
+            uint32_t getHash() { return bHash; }
+            bool isRegister() { return _register; }
             void name(const String & name)
             {
+                if (_register) BLINKER_FREE(bName);
+
                 _register = true;
-                bName = (char*)malloc((name.length()+1)*sizeof(char));
+                bName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (name.length()+1)*sizeof(char));
                 strcpy(bName, name.c_str());
+                bHash = STRING_hash(bName);
+            }
+
+            bool isPending() { return bMsg.length() > 0; }
+            String & pendingMsg() { return bMsg; }
+            uint32_t pendingTime() { return bTime; }
+            void flush() { bMsg = ""; }
+            // an empty queue takes any message, only merges are capped
+            bool batch(const String & data)
+            {
+                if (bMsg.length() == 0)
+                {
+                    bMsg = data;
+                    bTime = millis();
+                    return true;
+                }
+
+                if (data.length() > BLINKER_MAX_BRIDGE_BATCH_SIZE) return false;
+
+                String _msg;
+
+                #if defined(BLINKER_ARDUINOJSON)
+                    BlinkerJsonBuffer jsonBuffer;
+                    JsonObject& root = jsonBuffer.parseObject(bMsg);
+                    JsonObject& fresh = jsonBuffer.parseObject(data);
+
+                    if (!root.success() || !fresh.success()) return false;
+
+                    for (JsonObject::iterator it = fresh.begin(); it != fresh.end(); ++it)
+                    {
+                        root[it->key] = it->value;
+                    }
+
+                    root.printTo(_msg);
+                #else
+                    if (!bMsg.endsWith("}") || !data.startsWith("{")) return false;
+
+                    _msg = bMsg.substring(0, bMsg.length() - 1);
+                    _msg += BLINKER_F(",");
+                    _msg += data.substring(1);
+                #endif
+
+                if (_msg.length() > BLINKER_MAX_BRIDGE_BATCH_SIZE) return false;
+
+                bMsg = _msg;
+                return true;
             }
 
         private :
             char *bKey;
             char *bName;
             bool _register = false;
+            uint32_t bHash = 0;
+            String bMsg;
+            uint32_t bTime = 0;
             blinker_callback_with_string_arg_t wfunc;
         // public :
         //     BlinkerBridge() {}
@@ -227,6 +282,42 @@ class BlinkerWidgets_table
         //     char *bridgeName;
     };
 
+    #if defined(BLINKER_GATEWAY)
+    class BlinkerSubNode
+    {
+        public :
+            BlinkerSubNode(char * _ns, uint8_t _id)
+                : nTLV(NULL)
+            {
+                nName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_ns)+1)*sizeof(char));
+                strcpy(nName, _ns);
+
+                nHash = STRING_hash(nName);
+                nId = _id;
+            }
+
+            char * getName() { return nName; }
+            uint32_t getHash() { return nHash; }
+            uint8_t getId() { return nId; }
+            bool checkName(char * _ns) { return strcmp(_ns, nName) == 0; }
+            String & downMsg() { return nMsg; }
+            bool isTLV() { return nTLV != NULL; }
+
+            BlinkerTLV * tlv()
+            {
+                if (nTLV == NULL) nTLV = new BlinkerTLV();
+                return nTLV;
+            }
+
+        private :
+            char *nName;
+            uint32_t nHash;
+            uint8_t nId;
+            String nMsg;
+            BlinkerTLV *nTLV;
+    };
+    #endif
+
     class BlinkerData
     {
         public :
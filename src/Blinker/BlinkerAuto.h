@@ -21,6 +21,7 @@
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerUtility.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 class BlinkerAUTO
 {
@@ -302,7 +303,7 @@ void BlinkerAUTO::run(const String & key, const String & state, int32_t nowTime)
 
 void BlinkerAUTO::manager(const String & data)
 {
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& root = jsonBuffer.parseObject(data);
     
     _autoState = root[BLINKER_CMD_ENABLE];
@@ -0,0 +1,107 @@
+#ifndef BLINKER_BOOT_H
+#define BLINKER_BOOT_H
+
+#if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
+    defined(BLINKER_PRO_ESP)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+enum b_boot_step_t {
+    BOOT_WLAN,
+    BOOT_REGISTER,
+    BOOT_NTP,
+    BOOT_MQTT,
+    BOOT_OTA,
+    BOOT_STEP_NUM
+};
+
+// boot steps and what each one waits for, run() starts a step as soon as
+// its needs are done, so ntp goes along with the registration and the ota
+// check waits for mqtt instead of holding it up
+class BlinkerBoot
+{
+    public :
+        BlinkerBoot()
+            : started(0), finished(0)
+        {
+            memset(beginTime, 0, sizeof(beginTime));
+            memset(endTime, 0, sizeof(endTime));
+        }
+
+        // needs done and not started yet
+        bool ready(uint8_t step)
+        {
+            return !(started & stepBit(step)) && (finished & needs(step)) == needs(step);
+        }
+        bool isDone(uint8_t step)   { return finished & stepBit(step); }
+        void start(uint8_t step);
+        void done(uint8_t step);
+        void report();
+
+    private :
+        uint8_t     started;
+        uint8_t     finished;
+        uint32_t    beginTime[BOOT_STEP_NUM];
+        uint32_t    endTime[BOOT_STEP_NUM];
+
+        uint8_t stepBit(uint8_t step)   { return 1 << step; }
+        uint8_t needs(uint8_t step);
+        uint32_t span(uint8_t step)
+        {
+            return isDone(step) ? endTime[step] - beginTime[step] : 0;
+        }
+};
+
+uint8_t BlinkerBoot::needs(uint8_t step)
+{
+    switch (step)
+    {
+        case BOOT_REGISTER :
+        case BOOT_NTP :
+            return stepBit(BOOT_WLAN);
+        case BOOT_MQTT :
+            return stepBit(BOOT_REGISTER);
+        case BOOT_OTA :
+            return stepBit(BOOT_MQTT);
+        default :
+            return 0;
+    }
+}
+
+void BlinkerBoot::start(uint8_t step)
+{
+    if (started & stepBit(step)) return;
+
+    started |= stepBit(step);
+    beginTime[step] = millis();
+}
+
+void BlinkerBoot::done(uint8_t step)
+{
+    if (finished & stepBit(step)) return;
+
+    start(step);
+    finished |= stepBit(step);
+    endTime[step] = millis();
+}
+
+void BlinkerBoot::report()
+{
+    BLINKER_LOG(BLINKER_F("boot wlan: "), endTime[BOOT_WLAN], \
+                BLINKER_F(", register: "), span(BOOT_REGISTER), \
+                BLINKER_F(", ntp: "), span(BOOT_NTP), \
+                BLINKER_F(", mqtt: "), span(BOOT_MQTT), \
+                BLINKER_F(", ota: "), span(BOOT_OTA), \
+                BLINKER_F(", total: "), endTime[BOOT_OTA]);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef BLINKER_CLOCK_H
+#define BLINKER_CLOCK_H
+
+#include <time.h>
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+// local clock disciplined by the ntp/sntp source, the source is read once
+// every BLINKER_TIME_SYNC_INTERVAL, in between the time comes from millis()
+// scaled by the crystal drift measured between syncs
+// time is kept the way the source gives it, see ntpConfig()
+class BlinkerClock
+{
+    public :
+        BlinkerClock() { reset(); }
+
+        void reset();
+        void sync(time_t source);
+        // the source could not be read, wait a bit before the next try
+        void miss()         { missTime = millis() ? millis() : 1; }
+        bool synced()       { return isSync; }
+        bool needSync();
+        time_t now();
+        // broken-down now(), recomputed in full once a day
+        const struct tm & civil();
+        // seconds since midnight
+        int32_t daySecond();
+        // measured crystal drift, ppm
+        int32_t drift()     { return ppm; }
+
+    private :
+        bool        isSync;
+        time_t      baseTime;
+        uint32_t    baseMs;
+        uint32_t    missTime;
+        // a step back waiting for a second sync to confirm it
+        time_t      backTime;
+        uint32_t    backMs;
+        int32_t     ppm;
+        time_t      tmTime;
+        time_t      dayStart;
+        struct tm   tmCache;
+};
+
+void BlinkerClock::reset()
+{
+    isSync = false;
+    baseTime = 0;
+    baseMs = 0;
+    missTime = 0;
+    backTime = 0;
+    backMs = 0;
+    ppm = 0;
+    tmTime = 0;
+    dayStart = 0;
+}
+
+bool BlinkerClock::needSync()
+{
+    if (missTime && millis() - missTime < BLINKER_TIME_RETRY) return false;
+
+    return !isSync || backTime || millis() - baseMs >= BLINKER_TIME_SYNC_INTERVAL;
+}
+
+time_t BlinkerClock::now()
+{
+    uint32_t elapsed = millis() - baseMs;
+    int64_t fixed = (int64_t)elapsed + (int64_t)elapsed * ppm / 1000000;
+
+    return baseTime + (time_t)(fixed / 1000);
+}
+
+void BlinkerClock::sync(time_t source)
+{
+    missTime = 0;
+
+    if (isSync)
+    {
+        uint32_t elapsed = millis() - baseMs;
+        int32_t error = source - now();
+
+        // a big step back is only taken once the next sync agrees,
+        // so one bad reply can't throw the clock back, nor keep it ahead
+        if (error <= -BLINKER_TIME_STEP)
+        {
+            int32_t gap = source - (backTime + (time_t)((millis() - backMs) / 1000));
+
+            if (!backTime || gap > 2 || gap < -2)
+            {
+                BLINKER_LOG_ALL(BLINKER_F("time source went back: "), source);
+
+                backTime = source;
+                backMs = millis();
+                // ask again after the retry time, not the sync interval
+                miss();
+                return;
+            }
+
+            BLINKER_LOG_ALL(BLINKER_F("time step back confirmed: "), error);
+        }
+
+        backTime = 0;
+
+        // only learn from a long enough span, a step is not drift
+        if (elapsed >= BLINKER_TIME_DRIFT_SPAN && \
+            error < BLINKER_TIME_STEP && error > -BLINKER_TIME_STEP)
+        {
+            // the source only has whole seconds, go slowly
+            ppm += (int32_t)((int64_t)error * 1000000000LL / elapsed) / 4;
+
+            if (ppm > BLINKER_TIME_DRIFT_MAX) ppm = BLINKER_TIME_DRIFT_MAX;
+            else if (ppm < -BLINKER_TIME_DRIFT_MAX) ppm = -BLINKER_TIME_DRIFT_MAX;
+        }
+
+        BLINKER_LOG_ALL(BLINKER_F("time sync error: "), error, \
+                        BLINKER_F(", drift ppm: "), ppm);
+    }
+
+    baseTime = source;
+    baseMs = millis();
+    isSync = true;
+    tmTime = 0;
+}
+
+const struct tm & BlinkerClock::civil()
+{
+    time_t t = now();
+
+    if (t == tmTime) return tmCache;
+
+    if (tmTime && t >= dayStart && t - dayStart < 86400)
+    {
+        int32_t sec = t - dayStart;
+
+        tmCache.tm_hour = sec / 3600;
+        tmCache.tm_min = sec / 60 % 60;
+        tmCache.tm_sec = sec % 60;
+    }
+    else
+    {
+        #if defined(ESP32)
+            localtime_r(&t, &tmCache);
+        #else
+            gmtime_r(&t, &tmCache);
+        #endif
+
+        dayStart = t - (tmCache.tm_hour * 3600L + tmCache.tm_min * 60 + tmCache.tm_sec);
+    }
+
+    tmTime = t;
+
+    return tmCache;
+}
+
+int32_t BlinkerClock::daySecond()
+{
+    const struct tm & timeinfo = civil();
+
+    return timeinfo.tm_hour * 3600L + timeinfo.tm_min * 60 + timeinfo.tm_sec;
+}
+
+#endif
@@ -12,6 +12,24 @@
 
 #define BLINKER_NTP_TIMEOUT             1000UL
 
+#ifndef BLINKER_TIME_SYNC_INTERVAL
+    #if defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_GPRS_AIR202) || \
+        defined(BLINKER_PRO_SIM7020) || defined(BLINKER_PRO_AIR202) || \
+        defined(BLINKER_LOWPOWER_AIR202)
+        #define BLINKER_TIME_SYNC_INTERVAL  10800000UL
+    #else
+        #define BLINKER_TIME_SYNC_INTERVAL  600000UL
+    #endif
+#endif
+
+#define BLINKER_TIME_RETRY              60000UL
+
+#define BLINKER_TIME_DRIFT_SPAN         1800000UL
+
+#define BLINKER_TIME_DRIFT_MAX          500
+
+#define BLINKER_TIME_STEP               60
+
 #define BLINKER_GPS_MSG_LIMIT           30000UL
 
 #define BLINKER_PRINT_MSG_LIMIT         20
@@ -22,6 +40,16 @@
 
 #define BLINKER_MQTT_CONNECT_TIMESLOT   5000UL
 
+#define BLINKER_MQTT_BACKOFF_MAX        300000UL
+
+#define BLINKER_MQTT_CONNACK_TIMEOUT    6000UL
+
+#define BLINKER_MQTT_PING_MIN           15000UL
+
+#define BLINKER_MQTT_PING_MAX           120000UL
+
+#define BLINKER_MQTT_PING_WAIT          5000UL
+
 #define BLINKER_BRIDGE_MSG_LIMIT        10000UL
 
 #define BLINKER_LINK_MSG_LIMIT          10000UL
@@ -86,6 +114,82 @@
 
 #define BLINKER_OBJECT_NOT_AVAIL        -1
 
+// key/value entries kept per message by the lightweight (no ArduinoJson) parser
+#ifndef BLINKER_MAX_TOKEN_SIZE
+    #define BLINKER_MAX_TOKEN_SIZE      8
+#endif
+
+#define BLINKER_TOKEN_DEPTH             8
+
+#ifndef BLINKER_MAX_TASK_SIZE
+    #if defined(ESP8266) || defined(ESP32)
+        #define BLINKER_MAX_TASK_SIZE       8
+    #else
+        #define BLINKER_MAX_TASK_SIZE       4
+    #endif
+#endif
+
+// time run() may spend in scheduled tasks per pass, us
+#ifndef BLINKER_TASK_BUDGET
+    #define BLINKER_TASK_BUDGET             5000UL
+#endif
+
+#if defined(BLINKER_PROFILE)
+    // log2 buckets of us, the last one takes everything from ~4s up
+    #define BLINKER_PROFILE_BUCKETS         24
+
+    // head of the message handled by the slowest pass
+    #ifndef BLINKER_PROFILE_MSG_SIZE
+        #define BLINKER_PROFILE_MSG_SIZE    64
+    #endif
+#endif
+
+#if defined(BLINKER_HEAP_TRACK)
+    // live blocks followed one by one, later ones are only counted
+    #ifndef BLINKER_HEAP_TRACK_SIZE
+        #if defined(ESP8266) || defined(ESP32)
+            #define BLINKER_HEAP_TRACK_SIZE 64
+        #else
+            #define BLINKER_HEAP_TRACK_SIZE 16
+        #endif
+    #endif
+#endif
+
+#ifndef BLINKER_SHADOW_SIZE
+    #if defined(ESP8266) || defined(ESP32)
+        #define BLINKER_SHADOW_SIZE         64
+    #else
+        #define BLINKER_SHADOW_SIZE         24
+    #endif
+#endif
+
+#define BLINKER_SHADOW_HASH_NUM         2
+
+#if (defined(ESP8266) || defined(ESP32)) && \
+    (defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+    defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
+    defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP))
+    #define BLINKER_SENSOR_STREAM
+
+    // binary frame: magic | type | seq(2) | values, little endian
+    // ahrs: yaw, pitch, roll as int16 in 0.1 degree
+    // gps: long, lat as int32 in 0.000001 degree
+    #define BLINKER_SENSOR_MAGIC        0xB5
+    #define BLINKER_SENSOR_AHRS         0x01
+    #define BLINKER_SENSOR_GPS          0x02
+
+    #ifndef BLINKER_SENSOR_FREQ
+        #define BLINKER_SENSOR_FREQ         50
+    #endif
+
+    #define BLINKER_SENSOR_FREQ_MAX     100
+
+    // power of two
+    #ifndef BLINKER_SENSOR_RING_SIZE
+        #define BLINKER_SENSOR_RING_SIZE    8
+    #endif
+#endif
+
 #ifndef BLINKER_MAX_READ_SIZE
     #if defined(ESP8266) || defined(ESP32)
         #define BLINKER_MAX_READ_SIZE       1024
@@ -98,6 +202,17 @@
     #endif
 #endif
 
+// json buffers on ESP come from a static arena instead of the heap,
+// must stay below 32k, the pool is in BlinkerJson.cpp so only a build
+// flag resizes it
+#if defined(ESP8266) || defined(ESP32)
+    #ifndef BLINKER_JSON_ARENA_SIZE
+        #define BLINKER_JSON_ARENA_SIZE     (BLINKER_MAX_READ_SIZE * 4)
+    #endif
+
+    #define BLINKER_JSON_ARENA_NONE     0xFFFF
+#endif
+
 #ifndef BLINKER_MAX_SEND_SIZE
     #if defined(ESP8266) || defined(ESP32)
         #if defined(BLINKER_MQTT) || defined(BLINKER_AT_MQTT) || \
@@ -138,8 +253,49 @@
     #endif
 #endif
 
+#if defined(BLINKER_ARDUINOJSON) && (defined(ESP8266) || defined(ESP32))
+    #define BLINKER_SNAPSHOT
+
+    // state, timer, version, net, summary and snap go out with it
+    #define BLINKER_SNAPSHOT_HEAD_SIZE  192
+
+    #ifndef BLINKER_SNAPSHOT_SIZE
+        #define BLINKER_SNAPSHOT_SIZE       (BLINKER_MAX_SEND_BUFFER_SIZE - BLINKER_SNAPSHOT_HEAD_SIZE)
+    #endif
+
+    #if BLINKER_SNAPSHOT_SIZE > BLINKER_MAX_SEND_BUFFER_SIZE - BLINKER_SNAPSHOT_HEAD_SIZE
+        #error "BLINKER_SNAPSHOT_SIZE does not fit in a heartbeat reply"
+    #endif
+
+    #ifndef BLINKER_SNAPSHOT_KEYS
+        #define BLINKER_SNAPSHOT_KEYS       32
+    #endif
+
+    #define BLINKER_SNAPSHOT_KEY_SIZE   16
+#endif
+
 #define BLINKER_AUTHKEY_SIZE            14
 
+#if defined(BLINKER_LOWPOWER_AIR202)
+    #define BLINKER_RETAIN_NAME_SIZE        40
+
+    #ifndef BLINKER_RETAIN_PENDING_SIZE
+        #if defined(ESP8266) || defined(ESP32)
+            #define BLINKER_RETAIN_PENDING_SIZE 256
+        #else
+            #define BLINKER_RETAIN_PENDING_SIZE 64
+        #endif
+    #endif
+
+    // first rtc user memory block used on ESP8266, the ones before are
+    // left to the sketch
+    #ifndef BLINKER_RETAIN_RTC_BLOCK
+        #define BLINKER_RETAIN_RTC_BLOCK    32
+    #endif
+
+    #define BLINKER_RETAIN_FAIL_MAX         3
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
     #define BLINKER_LOGO_3D    
 #else
@@ -200,6 +356,10 @@
 
 #define BLINKER_CMD_VERSION             "version"
 
+#define BLINKER_CMD_SNAPSHOT            "snap"
+
+#define BLINKER_CMD_NET                 "net"
+
 #define BLINKER_CMD_NOTICE              "notice"
 
 #define BLINKER_CMD_BUILTIN_SWITCH      "switch"
@@ -554,6 +714,69 @@
     #endif
 #endif
 
+#ifdef BLINKER_MAX_BRIDGE_SIZE
+    #define BLINKER_BRIDGE_HASH_SIZE            (BLINKER_MAX_BRIDGE_SIZE * 2)
+#endif
+
+#define BLINKER_MAX_BRIDGE_BATCH_SIZE   256
+
+#define BLINKER_BRIDGE_BATCH_TIMEOUT    100UL
+
+#define BLINKER_BRIDGE_RETRY_TIME       1000UL
+
+// cached bridge names are asked for again after this many days
+#define BLINKER_BRIDGE_CACHE_DAYS       7
+
+#if defined(BLINKER_GATEWAY)
+    #ifndef BLINKER_MAX_SUB_DEVICE_SIZE
+        #if defined(ESP32)
+            #define BLINKER_MAX_SUB_DEVICE_SIZE     32
+        #else
+            #define BLINKER_MAX_SUB_DEVICE_SIZE     16
+        #endif
+    #endif
+
+    #define BLINKER_SUB_DEVICE_HASH_SIZE        (BLINKER_MAX_SUB_DEVICE_SIZE * 2)
+
+    #define BLINKER_SUB_DEVICE_NS_SIZE          12
+
+    #define BLINKER_GATEWAY_NS_SEPARATOR        '/'
+
+    #define BLINKER_GATEWAY_READ_LIMIT          8
+#endif
+
+#if defined(BLINKER_GATEWAY) || defined(BLINKER_SUBDEVICE)
+    #define BLINKER_TLV_DICT_SIZE               16
+
+    #define BLINKER_TLV_KEY_SIZE                12
+
+    #define BLINKER_TLV_ID_DEFINE               0
+
+    #define BLINKER_TLV_ID_LITERAL              31
+
+    #define BLINKER_TLV_TYPE_STRING             0
+
+    #define BLINKER_TLV_TYPE_INT                1
+
+    #define BLINKER_TLV_TYPE_BYTES              2
+
+    #define BLINKER_TLV_TYPE_FLOAT              3
+
+    #define BLINKER_TLV_TYPE_TRUE               4
+
+    #define BLINKER_TLV_TYPE_FALSE              5
+
+    #define BLINKER_TLV_TYPE_JSON               6
+
+    #define BLINKER_TLV_TYPE_NULL               7
+
+    #define BLINKER_TLV_FLAG_RESET              0x01
+
+    #define BLINKER_TLV_FLAG_RESET_REQ          0x02
+
+    #define BLINKER_TLV_ESCAPE                  0xDB
+#endif
+
 #define BLINKER_MAX_BLINKER_DATA_SIZE   8
 
 #define BLINKER_MAX_DATA_COUNT          4
@@ -564,6 +787,14 @@
 
     #define BLINKER_ESP_AT_VERSION              "0.1.0"
 
+    #ifndef BLINKER_AT_RX_BUFFER_SIZE
+        #define BLINKER_AT_RX_BUFFER_SIZE           512
+    #endif
+
+    #define BLINKER_AT_TX_BUFFER_SIZE           256
+
+    #define BLINKER_AT_PIPELINE_SIZE            4
+
     #define BLINKER_UART_PARAM_NUM              4
 
     #define BLINKER_COMWLAN_PARAM_NUM           4
@@ -1414,6 +1645,11 @@ Success--[AT+MIPLDISCOVERRSP=0,22903,1,24,"5850;5851;5852;5853;5750"]
 
     #define BLINKER_MQTT_MAX_SHARERS_NUM    9
 
+    // power of two, keep it above twice the sharers number
+    #define BLINKER_SHARER_INDEX_SIZE       16
+
+    #define BLINKER_SHARER_EMPTY            0xFF
+
     #define BLINKER_MQTT_FROM_AUTHER        BLINKER_MQTT_MAX_SHARERS_NUM
 
     #define BLINKER_MQTT_FORM_SERVER        BLINKER_MQTT_MAX_SHARERS_NUM + 1
@@ -1722,6 +1958,43 @@ Success--[AT+MIPLDISCOVERRSP=0,22903,1,24,"5850;5851;5852;5853;5750"]
 
     #define BLINKER_SERIALCFG_SIZE              4
 
+    #define BLINKER_EEP_ADDR_BRIDGE             2560
+
+    #define BLINKER_BRIDGE_KEY_HASH_SIZE        4
+
+    #define BLINKER_BRIDGE_DAY_SIZE             2
+
+    #define BLINKER_BRIDGE_NAME_SIZE            26
+
+    #define BLINKER_ONE_BRIDGE_SIZE             (BLINKER_BRIDGE_KEY_HASH_SIZE + BLINKER_BRIDGE_DAY_SIZE + BLINKER_BRIDGE_NAME_SIZE)
+
+    // 16 x 32, 2560 ~ 3072
+
+    #define BLINKER_EEP_ADDR_WLAN_CACHE         2448
+
+    #define BLINKER_WLAN_CACHE_SIZE             32
+
+    // 2448 ~ 2480
+
+    #ifndef BLINKER_WLAN_FAST_TIMEOUT
+        #define BLINKER_WLAN_FAST_TIMEOUT       3000UL
+    #endif
+
+    #define BLINKER_EEP_ADDR_REG_CACHE          3072
+
+    #define BLINKER_REG_CACHE_SIZE              768
+
+    // 3072 ~ 3856
+
+    #define BLINKER_REG_CACHE_VERSION           1
+
+    // 2001-09-09, anything earlier means the clock is not set yet
+    #define BLINKER_REG_CACHE_CLOCK             1000000000L
+
+    #ifndef BLINKER_REG_CACHE_TTL
+        #define BLINKER_REG_CACHE_TTL           604800UL
+    #endif
+
 #endif
 
 #if defined(BLINKER_GPRS_AIR202) || defined(BLINKER_PRO_AIR202) || \
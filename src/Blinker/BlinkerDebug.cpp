@@ -1,5 +1,10 @@
 #include "Blinker/BlinkerDebug.h"
 
+// a log level below default turns these into macros, which would swallow
+// the definitions at the bottom of this file
+#undef BLINKER_LOG_FreeHeap
+#undef BLINKER_LOG_FreeHeap_ALL
+
 #include <stddef.h>
 #ifdef ESP8266
     extern "C" {
@@ -59,6 +64,158 @@ void BlinkerDebug::time()
     return;
 }
 
+void BlinkerDebug::logPut(const uint8_t * data, uint8_t len)
+{
+    if (logBuf == NULL)
+    {
+        logBuf = (uint8_t*)malloc(BLINKER_LOG_BUFFER_SIZE*sizeof(uint8_t));
+
+        if (logBuf == NULL) return;
+    }
+
+    uint16_t used = (logHead + BLINKER_LOG_BUFFER_SIZE - logTail) % BLINKER_LOG_BUFFER_SIZE;
+
+    // logFlush reads every entry into a buffer of this size
+    if (len > BLINKER_LOG_ENTRY_SIZE || used + len + 1 >= BLINKER_LOG_BUFFER_SIZE)
+    {
+        logDrop++;
+        return;
+    }
+
+    logBuf[logHead] = len;
+    logHead = (logHead + 1) % BLINKER_LOG_BUFFER_SIZE;
+
+    for (uint8_t num = 0; num < len; num++)
+    {
+        logBuf[logHead] = data[num];
+        logHead = (logHead + 1) % BLINKER_LOG_BUFFER_SIZE;
+    }
+}
+
+void BlinkerDebug::logFlush()
+{
+    if (!isInit || logBuf == NULL) return;
+
+    uint8_t data[BLINKER_LOG_ENTRY_SIZE];
+
+    while (logTail != logHead)
+    {
+        uint8_t len = logBuf[logTail];
+        logTail = (logTail + 1) % BLINKER_LOG_BUFFER_SIZE;
+
+        for (uint8_t num = 0; num < len; num++)
+        {
+            data[num] = logBuf[logTail];
+            logTail = (logTail + 1) % BLINKER_LOG_BUFFER_SIZE;
+        }
+
+        logPrint(data, len);
+    }
+
+    if (logDrop)
+    {
+        debugger->print(BLINKER_DEBUG_F("log dropped: "));
+        debugger->println(logDrop);
+        logDrop = 0;
+    }
+}
+
+void BlinkerDebug::logPrint(const uint8_t * data, uint8_t len)
+{
+    uint32_t _time;
+    uint8_t pos = 1;
+
+    if (len < 1 + sizeof(_time)) return;
+
+    memcpy(&_time, data + pos, sizeof(_time));
+    pos += sizeof(_time);
+
+    debugger->print(BLINKER_DEBUG_F("["));
+    debugger->print(_time);
+    debugger->print(BLINKER_DEBUG_F("] "));
+
+    if (data[0] & BLINKER_LOG_FLAG_ERR) debugger->print(BLINKER_DEBUG_F("ERROR: "));
+
+    while (pos < len)
+    {
+        uint8_t tag = data[pos++];
+
+        if (tag == BLINKER_LOG_TAG_TEXT)
+        {
+            if (pos >= len) break;
+
+            uint8_t size = data[pos++];
+
+            if (size > len - pos) break;
+
+            for (uint8_t num = 0; num < size; num++)
+            {
+                debugger->print((char)data[pos++]);
+            }
+            continue;
+        }
+
+        if (tag == BLINKER_LOG_TAG_FLASH)
+        {
+            const __FlashStringHelper * _str;
+
+            if (pos + sizeof(_str) > len) break;
+
+            memcpy(&_str, data + pos, sizeof(_str));
+            pos += sizeof(_str);
+            debugger->print(_str);
+            continue;
+        }
+
+        if (tag == BLINKER_LOG_TAG_INT64 || tag == BLINKER_LOG_TAG_UINT64)
+        {
+            uint64_t _wide;
+
+            if (pos + sizeof(_wide) > len) break;
+
+            memcpy(&_wide, data + pos, sizeof(_wide));
+            pos += sizeof(_wide);
+
+            if (tag == BLINKER_LOG_TAG_INT64 && (int64_t)_wide < 0)
+            {
+                debugger->print('-');
+                _wide = 0 - _wide;
+            }
+
+            // Print has no 64 bit overload on every core
+            char _digit[21];
+            uint8_t _at = sizeof(_digit) - 1;
+            _digit[_at] = '\0';
+
+            do {
+                _digit[--_at] = '0' + _wide % 10;
+                _wide /= 10;
+            } while (_wide);
+
+            debugger->print(_digit + _at);
+            continue;
+        }
+
+        uint32_t _num;
+
+        if (pos + sizeof(_num) > len) break;
+
+        memcpy(&_num, data + pos, sizeof(_num));
+        pos += sizeof(_num);
+
+        if (tag == BLINKER_LOG_TAG_INT) debugger->print((int32_t)_num);
+        else if (tag == BLINKER_LOG_TAG_UINT) debugger->print(_num);
+        else if (tag == BLINKER_LOG_TAG_FLOAT)
+        {
+            float _float;
+            memcpy(&_float, &_num, sizeof(_float));
+            debugger->print(_float);
+        }
+    }
+
+    debugger->println();
+}
+
 // uint32_t BlinkerDebug::BLINKER_FreeHeap()
 // {
 // #if defined(ARDUINO) 
@@ -12,8 +12,117 @@
 #define BLINKER_DEBUG_F(s)  F(s)
 #define BLINKER_F(s)        F(s)
 
+// levels below BLINKER_LOG_LEVEL are compiled out, arguments included,
+// set it as a build flag, a #define in the sketch misses the .cpp files
+#define BLINKER_LOG_LEVEL_NONE      0
+#define BLINKER_LOG_LEVEL_ERROR     1
+#define BLINKER_LOG_LEVEL_DEFAULT   2
+#define BLINKER_LOG_LEVEL_ALL       3
+
+#ifndef BLINKER_LOG_LEVEL
+    #define BLINKER_LOG_LEVEL       BLINKER_LOG_LEVEL_ALL
+#endif
+
+#if !defined(ESP8266) && !defined(ESP32)
+    #undef BLINKER_LOG_DEFERRED
+#endif
+
+#ifndef BLINKER_LOG_BUFFER_SIZE
+    #define BLINKER_LOG_BUFFER_SIZE 2048
+#endif
+
+#define BLINKER_LOG_ENTRY_SIZE      128
+
+#define BLINKER_LOG_FLAG_ERR        0x01
+
+#define BLINKER_LOG_TAG_FLASH       'F'
+
+#define BLINKER_LOG_TAG_TEXT        's'
+
+#define BLINKER_LOG_TAG_INT         'i'
+
+#define BLINKER_LOG_TAG_UINT        'u'
+
+#define BLINKER_LOG_TAG_FLOAT       'f'
+
+#define BLINKER_LOG_TAG_INT64       'I'
+
+#define BLINKER_LOG_TAG_UINT64      'U'
+
 uint32_t BLINKER_FreeHeap();
 
+// one deferred log record: flag | millis | tag + raw value ...
+class BlinkerLogEntry : public Print
+{
+    public :
+        BlinkerLogEntry(uint8_t flag)
+            : len(0)
+        {
+            uint32_t now = millis();
+
+            write(flag);
+            raw(&now, sizeof(now));
+        }
+
+        size_t write(uint8_t c)
+        {
+            if (len >= BLINKER_LOG_ENTRY_SIZE) return 0;
+
+            buf[len++] = c;
+            return 1;
+        }
+
+        void flash(const __FlashStringHelper * arg)
+        {
+            write(BLINKER_LOG_TAG_FLASH);
+            raw(&arg, sizeof(arg));
+        }
+
+        void number(uint32_t arg, bool isSigned)
+        {
+            write(isSigned ? BLINKER_LOG_TAG_INT : BLINKER_LOG_TAG_UINT);
+            raw(&arg, sizeof(arg));
+        }
+
+        void number(uint64_t arg, bool isSigned)
+        {
+            write(isSigned ? BLINKER_LOG_TAG_INT64 : BLINKER_LOG_TAG_UINT64);
+            raw(&arg, sizeof(arg));
+        }
+
+        void number(float arg)
+        {
+            write(BLINKER_LOG_TAG_FLOAT);
+            raw(&arg, sizeof(arg));
+        }
+
+        template <typename T>
+        void text(const T & arg)
+        {
+            if (len + 2 > BLINKER_LOG_ENTRY_SIZE) return;
+
+            write(BLINKER_LOG_TAG_TEXT);
+            uint8_t start = len++;
+            print(arg);
+            buf[start] = len - start - 1;
+        }
+
+        const uint8_t * data() { return buf; }
+        uint8_t length() { return len; }
+
+    private :
+        uint8_t buf[BLINKER_LOG_ENTRY_SIZE];
+        uint8_t len;
+
+        void raw(const void * data, uint8_t size)
+        {
+            if (len + size > BLINKER_LOG_ENTRY_SIZE) return;
+
+            memcpy(buf + len, data, size);
+            len += size;
+        }
+};
+
 class BlinkerDebug
 {
     enum blinker_debug_level_t
@@ -43,6 +152,9 @@ class BlinkerDebug
         bool isDebug()      { return isInit ? debug_level != _debug_none : false; }
         bool isDebugAll()   { return isInit ? debug_level == _debug_all : false;}
 
+        void logPut(const uint8_t * data, uint8_t len);
+        void logFlush();
+
         template <typename T>
         void print(T arg)   { debugger->print(arg); }
 
@@ -55,6 +167,13 @@ class BlinkerDebug
         Stream* debugger;
         blinker_debug_level_t debug_level;
 
+        uint8_t *   logBuf = NULL;
+        uint16_t    logHead = 0;
+        uint16_t    logTail = 0;
+        uint16_t    logDrop = 0;
+
+        void logPrint(const uint8_t * data, uint8_t len);
+
         // uint32_t BLINKER_FreeHeap();
 };
 
@@ -65,6 +184,59 @@ void BLINKER_LOG_FreeHeap();
 void BLINKER_LOG_FreeHeap_ALL();
 extern void BLINKER_LOG_T();
 
+#if defined(BLINKER_LOG_DEFERRED)
+    #include <type_traits>
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+BLINKER_LOG_D_ARG(BlinkerLogEntry & entry, T arg)
+{
+    if (sizeof(T) > sizeof(uint32_t))
+        entry.number((uint64_t)arg, std::is_signed<T>::value);
+    else
+        entry.number((uint32_t)arg, std::is_signed<T>::value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+BLINKER_LOG_D_ARG(BlinkerLogEntry & entry, T arg)
+{
+    entry.number((float)arg);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value>::type
+BLINKER_LOG_D_ARG(BlinkerLogEntry & entry, const T & arg)
+{
+    entry.text(arg);
+}
+
+inline void BLINKER_LOG_D_ARG(BlinkerLogEntry & entry, char arg) { entry.text(arg); }
+
+inline void BLINKER_LOG_D_ARG(BlinkerLogEntry & entry, const __FlashStringHelper * arg)
+{
+    entry.flash(arg);
+}
+
+inline void BLINKER_LOG_D_T(BlinkerLogEntry & entry) {}
+
+template <typename T,typename... Ts>
+void BLINKER_LOG_D_T(BlinkerLogEntry & entry, T arg, Ts... args)
+{
+    BLINKER_LOG_D_ARG(entry, arg);
+    BLINKER_LOG_D_T(entry, args...);
+}
+
+/* 记录到 RAM 环形缓冲, 由 BLINKER_DEBUG.logFlush() 输出 */
+template <typename... Ts>
+void BLINKER_LOG_D(uint8_t flag, Ts... args)
+{
+    BlinkerLogEntry entry(flag);
+    BLINKER_LOG_D_T(entry, args...);
+    BLINKER_DEBUG.logPut(entry.data(), entry.length());
+}
+#endif
+
 /* BLINKER_LOG_T递归模板 */
 template <typename T,typename... Ts>
 void BLINKER_LOG_T(T arg,Ts... args)
@@ -80,8 +252,12 @@ void BLINKER_LOG_T(T arg,Ts... args)
 template <typename... Ts>
 void BLINKER_LOG(Ts... args)
 {
+#if defined(BLINKER_LOG_DEFERRED)
+    if (BLINKER_DEBUG.isDebug()) BLINKER_LOG_D(0, args...);
+#else
     BLINKER_LOG_TIME();
     BLINKER_LOG_T(args...);
+#endif
     return;
 }
 /* BLINKER_ERR_LOG可变参数模板 */
@@ -90,9 +266,13 @@ void BLINKER_ERR_LOG(Ts... args)
 {
     if (BLINKER_DEBUG.isDebug())
     {
+    #if defined(BLINKER_LOG_DEFERRED)
+        BLINKER_LOG_D(BLINKER_LOG_FLAG_ERR, args...);
+    #else
         BLINKER_LOG_TIME();
         BLINKER_DEBUG.print(BLINKER_DEBUG_F("ERROR: "));
         BLINKER_LOG_T(args...);
+    #endif
     }
     return;
 }
@@ -102,8 +282,12 @@ void BLINKER_LOG_ALL(Ts... args)
 {
     if (BLINKER_DEBUG.isDebugAll())
     {
+    #if defined(BLINKER_LOG_DEFERRED)
+        BLINKER_LOG_D(0, args...);
+    #else
         BLINKER_LOG_TIME();
         BLINKER_LOG_T(args...);
+    #endif
     }
     return;
 }
@@ -115,4 +299,19 @@ void BLINKER_ERR_LOG_ALL(Ts... args)
     return;
 }
 
+#if BLINKER_LOG_LEVEL < BLINKER_LOG_LEVEL_ALL
+    #define BLINKER_LOG_ALL(...)        ((void)0)
+    #define BLINKER_ERR_LOG_ALL(...)    ((void)0)
+    #define BLINKER_LOG_FreeHeap_ALL()  ((void)0)
+#endif
+
+#if BLINKER_LOG_LEVEL < BLINKER_LOG_LEVEL_DEFAULT
+    #define BLINKER_LOG(...)            ((void)0)
+    #define BLINKER_LOG_FreeHeap()      ((void)0)
+#endif
+
+#if BLINKER_LOG_LEVEL < BLINKER_LOG_LEVEL_ERROR
+    #define BLINKER_ERR_LOG(...)        ((void)0)
+#endif
+
 #endif
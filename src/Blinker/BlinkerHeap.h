@@ -0,0 +1,277 @@
+#ifndef BLINKER_HEAP_H
+#define BLINKER_HEAP_H
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+
+// allocations of the core go through these, with BLINKER_HEAP_TRACK they
+// are counted per tag, otherwise they are plain malloc/realloc/free
+#if defined(BLINKER_HEAP_TRACK)
+    #define BLINKER_MALLOC(tag, size)           BLINKER_HEAP.alloc(tag, size)
+    #define BLINKER_REALLOC(tag, ptr, size)     BLINKER_HEAP.resize(tag, ptr, size)
+    #define BLINKER_FREE(ptr)                   BLINKER_HEAP.release(ptr)
+#else
+    #define BLINKER_MALLOC(tag, size)           malloc(size)
+    #define BLINKER_REALLOC(tag, ptr, size)     realloc(ptr, size)
+    #define BLINKER_FREE(ptr)                   free(ptr)
+#endif
+
+#if defined(BLINKER_HEAP_TRACK)
+
+enum b_heap_tag_t {
+    // widget and attribute names
+    HEAP_WIDGET,
+    // send buffers and tlv frames
+    HEAP_MSG,
+    // timer actions
+    HEAP_TIMER,
+    // auth key and broker credentials
+    HEAP_CRED,
+    // aligenie and dueros reply attributes
+    HEAP_ATTR,
+    HEAP_TAG_NUM
+};
+
+struct blinker_heap_block_t
+{
+    void *      ptr;
+    size_t      size;
+    uint8_t     tag;
+};
+
+// live bytes of every tag plus how broken up the heap is, blocks are kept
+// in a small table so free() finds the size again, blocks allocated while
+// the table was full are only counted and a pointer free() does not know
+// is taken as one of them
+class BlinkerHeap
+{
+    public :
+        BlinkerHeap()
+            : untracked(0)
+        {
+            memset(block, 0, sizeof(block));
+            memset(liveBytes, 0, sizeof(liveBytes));
+            memset(liveNum, 0, sizeof(liveNum));
+            memset(peakBytes, 0, sizeof(peakBytes));
+            memset(allocNum, 0, sizeof(allocNum));
+            memset(failNum, 0, sizeof(failNum));
+        }
+
+        void * alloc(uint8_t tag, size_t size);
+        void * resize(uint8_t tag, void * ptr, size_t size);
+        void release(void * ptr);
+        // blocks still allocated, tracked or not
+        uint16_t leaks();
+        uint32_t maxBlock();
+        // % of the free heap outside the largest free block
+        uint8_t fragmentation();
+        String snapshot();
+        void report();
+
+    private :
+        blinker_heap_block_t    block[BLINKER_HEAP_TRACK_SIZE];
+        uint32_t    liveBytes[HEAP_TAG_NUM];
+        uint16_t    liveNum[HEAP_TAG_NUM];
+        uint32_t    peakBytes[HEAP_TAG_NUM];
+        uint32_t    allocNum[HEAP_TAG_NUM];
+        uint16_t    failNum[HEAP_TAG_NUM];
+        // live blocks allocated while the table was full
+        uint16_t    untracked;
+
+        void add(uint8_t tag, void * ptr, size_t size);
+        bool drop(void * ptr);
+        void tagName(String & data, uint8_t tag);
+};
+
+BlinkerHeap BLINKER_HEAP;
+
+void * BlinkerHeap::alloc(uint8_t tag, size_t size)
+{
+    void * ptr = malloc(size);
+
+    if (ptr == NULL)
+    {
+        failNum[tag]++;
+        return NULL;
+    }
+
+    add(tag, ptr, size);
+
+    return ptr;
+}
+
+void * BlinkerHeap::resize(uint8_t tag, void * ptr, size_t size)
+{
+    void * data = realloc(ptr, size);
+
+    if (data == NULL)
+    {
+        failNum[tag]++;
+        return NULL;
+    }
+
+    if (!drop(ptr) && ptr && untracked) untracked--;
+    add(tag, data, size);
+
+    return data;
+}
+
+void BlinkerHeap::release(void * ptr)
+{
+    if (ptr == NULL) return;
+
+    if (!drop(ptr) && untracked) untracked--;
+    free(ptr);
+}
+
+void BlinkerHeap::add(uint8_t tag, void * ptr, size_t size)
+{
+    allocNum[tag]++;
+
+    for (uint16_t num = 0; num < BLINKER_HEAP_TRACK_SIZE; num++)
+    {
+        if (block[num].ptr == NULL)
+        {
+            block[num].ptr = ptr;
+            block[num].size = size;
+            block[num].tag = tag;
+
+            liveBytes[tag] += size;
+            liveNum[tag]++;
+
+            if (liveBytes[tag] > peakBytes[tag]) peakBytes[tag] = liveBytes[tag];
+
+            return;
+        }
+    }
+
+    untracked++;
+}
+
+bool BlinkerHeap::drop(void * ptr)
+{
+    if (ptr == NULL) return false;
+
+    for (uint16_t num = 0; num < BLINKER_HEAP_TRACK_SIZE; num++)
+    {
+        if (block[num].ptr == ptr)
+        {
+            liveBytes[block[num].tag] -= block[num].size;
+            liveNum[block[num].tag]--;
+            block[num].ptr = NULL;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint16_t BlinkerHeap::leaks()
+{
+    uint16_t num = untracked;
+
+    for (uint8_t tag = 0; tag < HEAP_TAG_NUM; tag++) num += liveNum[tag];
+
+    return num;
+}
+
+uint32_t BlinkerHeap::maxBlock()
+{
+    #if defined(ESP8266)
+        return ESP.getMaxFreeBlockSize();
+    #elif defined(ESP32)
+        return ESP.getMaxAllocHeap();
+    #else
+        // avr heap only grows, the gap below the stack is one block
+        return BLINKER_FreeHeap();
+    #endif
+}
+
+uint8_t BlinkerHeap::fragmentation()
+{
+    uint32_t freeHeap = BLINKER_FreeHeap();
+    uint32_t largest = maxBlock();
+
+    if (freeHeap == 0 || largest >= freeHeap) return 0;
+
+    return 100 - largest * 100 / freeHeap;
+}
+
+void BlinkerHeap::tagName(String & data, uint8_t tag)
+{
+    switch (tag)
+    {
+        case HEAP_WIDGET :  data += BLINKER_F("widget"); break;
+        case HEAP_MSG :     data += BLINKER_F("msg"); break;
+        case HEAP_TIMER :   data += BLINKER_F("timer"); break;
+        case HEAP_CRED :    data += BLINKER_F("cred"); break;
+        default :           data += BLINKER_F("attr"); break;
+    }
+}
+
+// {"free":n,"block":n,"frag":n,"untracked":n,
+//  "widget":{"live":n,"num":n,"peak":n,"allocs":n,"fails":n},...}
+String BlinkerHeap::snapshot()
+{
+    String data = BLINKER_F("{\"free\":");
+    data += STRING_format(BLINKER_FreeHeap());
+    data += BLINKER_F(",\"block\":");
+    data += STRING_format(maxBlock());
+    data += BLINKER_F(",\"frag\":");
+    data += STRING_format(fragmentation());
+    data += BLINKER_F(",\"untracked\":");
+    data += STRING_format(untracked);
+
+    for (uint8_t tag = 0; tag < HEAP_TAG_NUM; tag++)
+    {
+        data += BLINKER_F(",\"");
+        tagName(data, tag);
+        data += BLINKER_F("\":{\"live\":");
+        data += STRING_format(liveBytes[tag]);
+        data += BLINKER_F(",\"num\":");
+        data += STRING_format(liveNum[tag]);
+        data += BLINKER_F(",\"peak\":");
+        data += STRING_format(peakBytes[tag]);
+        data += BLINKER_F(",\"allocs\":");
+        data += STRING_format(allocNum[tag]);
+        data += BLINKER_F(",\"fails\":");
+        data += STRING_format(failNum[tag]);
+        data += '}';
+    }
+
+    data += '}';
+
+    return data;
+}
+
+void BlinkerHeap::report()
+{
+    BLINKER_LOG(BLINKER_F("heap free: "), BLINKER_FreeHeap(), \
+                BLINKER_F(", block: "), maxBlock(), \
+                BLINKER_F(", frag: "), fragmentation(), \
+                BLINKER_F("%, untracked: "), untracked);
+
+    for (uint8_t tag = 0; tag < HEAP_TAG_NUM; tag++)
+    {
+        String name;
+        tagName(name, tag);
+
+        BLINKER_LOG(BLINKER_F("heap "), name, \
+                    BLINKER_F(" live: "), liveBytes[tag], \
+                    BLINKER_F(", num: "), liveNum[tag], \
+                    BLINKER_F(", peak: "), peakBytes[tag], \
+                    BLINKER_F(", allocs: "), allocNum[tag], \
+                    BLINKER_F(", fails: "), failNum[tag]);
+    }
+}
+
+#endif
+
+#endif
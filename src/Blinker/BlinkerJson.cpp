@@ -0,0 +1,60 @@
+#include "Blinker/BlinkerJson.h"
+
+#if defined(BLINKER_JSON_ARENA_SIZE)
+
+// block sizes are uint16 with bit 15 marking a freed block
+#if BLINKER_JSON_ARENA_SIZE > 0x7FFF
+    #error "BLINKER_JSON_ARENA_SIZE must stay below 32k"
+#endif
+
+static uint32_t     _arenaBuf[(BLINKER_JSON_ARENA_SIZE + 3) / 4];
+
+#define BLINKER_JSON_ARENA_POOL     ((uint8_t *)_arenaBuf)
+
+BlinkerJsonArena    BLINKER_JSON_ARENA;
+
+void * BlinkerJsonArena::allocate(size_t size)
+{
+    size_t total = ((size + 3) & ~(size_t)3) + 4;
+
+    if (top + total > BLINKER_JSON_ARENA_SIZE)
+    {
+        miss++;
+        return malloc(size);
+    }
+
+    uint8_t * block = BLINKER_JSON_ARENA_POOL + top;
+
+    ((uint16_t *)block)[0] = last;
+    ((uint16_t *)block)[1] = total;
+
+    last = top;
+    top += total;
+
+    if (top > peak) peak = top;
+
+    return block + 4;
+}
+
+void BlinkerJsonArena::deallocate(void * pointer)
+{
+    if (pointer < (void *)BLINKER_JSON_ARENA_POOL || \
+        pointer >= (void *)(BLINKER_JSON_ARENA_POOL + BLINKER_JSON_ARENA_SIZE))
+    {
+        free(pointer);
+        return;
+    }
+
+    uint8_t * block = (uint8_t *)pointer - 4;
+
+    ((uint16_t *)block)[1] |= 0x8000;
+
+    while (last != BLINKER_JSON_ARENA_NONE && \
+        (((uint16_t *)(BLINKER_JSON_ARENA_POOL + last))[1] & 0x8000))
+    {
+        top = last;
+        last = ((uint16_t *)(BLINKER_JSON_ARENA_POOL + last))[0];
+    }
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef BLINKER_JSON_H
+#define BLINKER_JSON_H
+
+#include "Blinker/BlinkerConfig.h"
+#include "modules/ArduinoJson/ArduinoJson.h"
+
+// raw span [start, end) of a top level value, found without parsing,
+// so it can still be copied out before an in-situ parse rewrites the text
+inline bool JSON_find_value(const char * json, const char * key, uint16_t & start, uint16_t & end)
+{
+    size_t keyLen = strlen(key);
+    uint16_t keyStart = 0;
+    uint8_t depth = 0;
+    bool quote = false;
+    bool isKey = false;
+    bool isValue = false;
+    bool match = false;
+
+    for (uint16_t pos = 0; json[pos]; pos++)
+    {
+        char c = json[pos];
+
+        if (quote)
+        {
+            if (c == '\\' && json[pos + 1]) pos++;
+            else if (c == '"')
+            {
+                quote = false;
+
+                if (isKey)
+                {
+                    match = (pos - keyStart) == keyLen && \
+                            strncmp(json + keyStart, key, keyLen) == 0;
+                    isKey = false;
+                }
+            }
+            continue;
+        }
+
+        if (c == '"')
+        {
+            quote = true;
+
+            if (depth == 1 && !isValue)
+            {
+                isKey = true;
+                keyStart = pos + 1;
+            }
+        }
+        else if (c == ':' && depth == 1 && !isValue)
+        {
+            isValue = true;
+            start = pos + 1;
+
+            while (json[start] == ' ') start++;
+        }
+        else if (c == '{' || c == '[')
+        {
+            depth++;
+        }
+        else if ((c == '}' || c == ']' || c == ',') && depth == 1)
+        {
+            if (isValue && match)
+            {
+                end = pos;
+
+                while (end > start && json[end - 1] == ' ') end--;
+
+                return true;
+            }
+
+            isValue = false;
+            match = false;
+
+            if (c != ',') depth--;
+        }
+        else if (c == '}' || c == ']')
+        {
+            depth--;
+        }
+    }
+
+    return false;
+}
+
+#if defined(BLINKER_JSON_ARENA_SIZE)
+
+// preallocated stack arena behind BlinkerJsonBuffer
+// json buffers are scoped locals, so their blocks come and go in LIFO
+// order, a block freed out of order is only reclaimed once the blocks
+// above it are gone, anything that does not fit falls back to malloc
+// the pool itself lives in BlinkerJson.cpp, so its size is only taken
+// from a build flag and the class looks the same to every unit
+class BlinkerJsonArena
+{
+    public :
+        BlinkerJsonArena()
+            : top(0)
+            , last(BLINKER_JSON_ARENA_NONE)
+            , peak(0)
+            , miss(0)
+        {}
+
+        void * allocate(size_t size);
+        void deallocate(void * pointer);
+
+        uint16_t used()     { return top; }
+        uint16_t maxUsed()  { return peak; }
+        uint32_t missNum()  { return miss; }
+
+    private :
+        uint16_t    top;
+        uint16_t    last;
+        uint16_t    peak;
+        uint32_t    miss;
+};
+
+extern BlinkerJsonArena BLINKER_JSON_ARENA;
+
+class BlinkerJsonAllocator
+{
+    public :
+        void * allocate(size_t size)    { return BLINKER_JSON_ARENA.allocate(size); }
+        void deallocate(void * pointer) { BLINKER_JSON_ARENA.deallocate(pointer); }
+};
+
+typedef ArduinoJson::Internals::DynamicJsonBufferBase<BlinkerJsonAllocator> \
+    BlinkerJsonBuffer;
+
+#else
+
+typedef DynamicJsonBuffer   BlinkerJsonBuffer;
+
+#endif
+
+#endif
@@ -23,6 +23,8 @@
 
 uint8_t parseMode(uint8_t _mode, uint8_t _pullState);
 
+int8_t atCmdFind(const String & cmd);
+
 enum blinker_at_state_t {
     AT_NONE,
     AT_TEST,
@@ -67,6 +69,38 @@ enum blinker_at_dueros_t {
     DUER_SENSOR
 };
 
+enum blinker_at_cmd_t {
+    AT_CMD_AT,
+    AT_CMD_RST,
+    AT_CMD_GMR,
+    AT_CMD_UART_CUR,
+    AT_CMD_UART_DEF,
+    AT_CMD_RAM,
+    AT_CMD_ADC,
+    AT_CMD_IOSETCFG,
+    AT_CMD_IOGETCFG,
+    AT_CMD_GPIOWRITE,
+    AT_CMD_GPIOWREAD,
+    AT_CMD_BLINKER_MQTT,
+    AT_CMD_BLINKER_ALIGENIE,
+    AT_CMD_BLINKER_DUEROS,
+    AT_CMD_TIMEZONE,
+    AT_CMD_TIME,
+    AT_CMD_SECOND,
+    AT_CMD_MINUTE,
+    AT_CMD_HOUR,
+    AT_CMD_WDAY,
+    AT_CMD_MDAY,
+    AT_CMD_YDAY,
+    AT_CMD_MONTH,
+    AT_CMD_YEAR,
+    AT_CMD_WEATHER,
+    AT_CMD_AQI,
+    AT_CMD_NOTICE,
+    AT_CMD_SMS,
+    AT_CMD_NUM
+};
+
 uint32_t serialSet = BLINKER_SERIAL_DEFAULT;
 
 #if defined(ESP8266)
@@ -186,6 +220,73 @@ uint8_t parseMode(uint8_t _mode, uint8_t _pullState)
     }
 }
 
+// same order as blinker_at_cmd_t
+const char * const atCmdTable[AT_CMD_NUM] = {
+    BLINKER_CMD_AT,
+    BLINKER_CMD_RST,
+    BLINKER_CMD_GMR,
+    BLINKER_CMD_UART_CUR,
+    BLINKER_CMD_UART_DEF,
+    BLINKER_CMD_RAM,
+    BLINKER_CMD_ADC,
+    BLINKER_CMD_IOSETCFG,
+    BLINKER_CMD_IOGETCFG,
+    BLINKER_CMD_GPIOWRITE,
+    BLINKER_CMD_GPIOWREAD,
+    BLINKER_CMD_BLINKER_MQTT,
+    BLINKER_CMD_BLINKER_ALIGENIE,
+    BLINKER_CMD_BLINKER_DUEROS,
+    BLINKER_CMD_TIMEZONE,
+    BLINKER_CMD_TIME_AT,
+    BLINKER_CMD_SECOND,
+    BLINKER_CMD_MINUTE,
+    BLINKER_CMD_HOUR,
+    BLINKER_CMD_WDAY,
+    BLINKER_CMD_MDAY,
+    BLINKER_CMD_YDAY,
+    BLINKER_CMD_MONTH,
+    BLINKER_CMD_YEAR,
+    BLINKER_CMD_WEATHER_AT,
+    BLINKER_CMD_AQI_AT,
+    BLINKER_CMD_NOTICE_AT,
+    BLINKER_CMD_SMS_AT
+};
+
+// open addressed on the low bits of the command hash, slot holds
+// command + 1 so 0 is empty, kept at least twice AT_CMD_NUM
+#define BLINKER_AT_CMD_SLOTS    64
+
+uint8_t atCmdSlot[BLINKER_AT_CMD_SLOTS] = { 0 };
+bool    atCmdReady = false;
+
+int8_t atCmdFind(const String & cmd)
+{
+    if (!atCmdReady)
+    {
+        for (uint8_t num = 0; num < AT_CMD_NUM; num++)
+        {
+            uint8_t slot = STRING_hash(atCmdTable[num]) & (BLINKER_AT_CMD_SLOTS - 1);
+
+            while (atCmdSlot[slot]) slot = (slot + 1) & (BLINKER_AT_CMD_SLOTS - 1);
+
+            atCmdSlot[slot] = num + 1;
+        }
+
+        atCmdReady = true;
+    }
+
+    uint8_t slot = STRING_hash(cmd.c_str()) & (BLINKER_AT_CMD_SLOTS - 1);
+
+    while (atCmdSlot[slot])
+    {
+        if (cmd == atCmdTable[atCmdSlot[slot] - 1]) return atCmdSlot[slot] - 1;
+
+        slot = (slot + 1) & (BLINKER_AT_CMD_SLOTS - 1);
+    }
+
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
 class BlinkerSlaverAT
 {
     public :
@@ -0,0 +1,237 @@
+#ifndef BLINKER_PROFILER_H
+#define BLINKER_PROFILER_H
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+
+// probes in run(), they are gone unless BLINKER_PROFILE is defined
+#if defined(BLINKER_PROFILE)
+    #define BLINKER_PROFILE_BEGIN()         _profiler.begin()
+    #define BLINKER_PROFILE_MARK(phase)     _profiler.mark(phase)
+    #define BLINKER_PROFILE_MSG(msg)        _profiler.message(msg)
+#else
+    #define BLINKER_PROFILE_BEGIN()
+    #define BLINKER_PROFILE_MARK(phase)
+    #define BLINKER_PROFILE_MSG(msg)
+#endif
+
+#if defined(BLINKER_PROFILE)
+
+enum b_profile_phase_t {
+    PROF_TASK,
+    PROF_LINK,
+    PROF_TIMER,
+    PROF_PARSE,
+    PROF_AUTO,
+    PROF_FLUSH,
+    // sketch loop() and whatever run() did after its last probe
+    PROF_USER,
+    PROF_NUM
+};
+
+// where run() spends its time, each pass adds the time of every phase it
+// went through to a log2 histogram of us, the slowest pass is kept along
+// with the message it handled
+class BlinkerProfiler
+{
+    public :
+        BlinkerProfiler() { reset(); }
+
+        // top of run(), closes the pass before
+        void begin();
+        // time since the last mark is charged to phase
+        void mark(uint8_t phase);
+        // copied now, the adapter frees its read buffer on flush
+        void message(const char * msg);
+        void reset();
+        String dump();
+
+    private :
+        uint16_t    hist[PROF_NUM][BLINKER_PROFILE_BUCKETS];
+        uint32_t    phaseMax[PROF_NUM];
+        uint32_t    phaseNow[PROF_NUM];
+        uint8_t     touched;
+        bool        isRun;
+        uint32_t    loopNum;
+        uint32_t    loopStart;
+        uint32_t    lastMark;
+        uint32_t    worst;
+        uint8_t     worstPhase;
+        char        worstMsg[BLINKER_PROFILE_MSG_SIZE];
+        char        lastMsg[BLINKER_PROFILE_MSG_SIZE];
+
+        void close(uint32_t now);
+        void record(uint8_t phase, uint32_t us);
+        void phaseName(String & data, uint8_t phase);
+};
+
+void BlinkerProfiler::reset()
+{
+    memset(hist, 0, sizeof(hist));
+    memset(phaseMax, 0, sizeof(phaseMax));
+    memset(phaseNow, 0, sizeof(phaseNow));
+    touched = 0;
+    isRun = false;
+    loopNum = 0;
+    loopStart = 0;
+    lastMark = 0;
+    worst = 0;
+    worstPhase = PROF_USER;
+    worstMsg[0] = '\0';
+    lastMsg[0] = '\0';
+}
+
+void BlinkerProfiler::begin()
+{
+    uint32_t now = micros();
+
+    if (isRun)
+    {
+        mark(PROF_USER);
+        close(now);
+    }
+
+    isRun = true;
+    loopStart = now;
+    lastMark = now;
+    touched = 0;
+    lastMsg[0] = '\0';
+    memset(phaseNow, 0, sizeof(phaseNow));
+}
+
+void BlinkerProfiler::mark(uint8_t phase)
+{
+    uint32_t now = micros();
+
+    phaseNow[phase] += now - lastMark;
+    touched |= 1 << phase;
+    lastMark = now;
+}
+
+void BlinkerProfiler::message(const char * msg)
+{
+    if (msg == NULL) return;
+
+    strncpy(lastMsg, msg, BLINKER_PROFILE_MSG_SIZE - 1);
+    lastMsg[BLINKER_PROFILE_MSG_SIZE - 1] = '\0';
+}
+
+void BlinkerProfiler::close(uint32_t now)
+{
+    uint32_t total = now - loopStart;
+    uint8_t slow = PROF_USER;
+
+    for (uint8_t num = 0; num < PROF_NUM; num++)
+    {
+        if (!(touched & (1 << num))) continue;
+
+        record(num, phaseNow[num]);
+
+        if (phaseNow[num] > phaseNow[slow]) slow = num;
+    }
+
+    loopNum++;
+
+    if (total <= worst) return;
+
+    worst = total;
+    worstPhase = slow;
+
+    memcpy(worstMsg, lastMsg, BLINKER_PROFILE_MSG_SIZE);
+}
+
+void BlinkerProfiler::record(uint8_t phase, uint32_t us)
+{
+    uint8_t slot = 0;
+
+    if (us > phaseMax[phase]) phaseMax[phase] = us;
+
+    while (us && slot < BLINKER_PROFILE_BUCKETS - 1)
+    {
+        us >>= 1;
+        slot++;
+    }
+
+    // keep the shape when a bucket is full
+    if (hist[phase][slot] == 0xFFFF)
+    {
+        for (uint8_t num = 0; num < BLINKER_PROFILE_BUCKETS; num++)
+        {
+            hist[phase][num] >>= 1;
+        }
+    }
+
+    hist[phase][slot]++;
+}
+
+void BlinkerProfiler::phaseName(String & data, uint8_t phase)
+{
+    switch (phase)
+    {
+        case PROF_TASK :    data += BLINKER_F("task"); break;
+        case PROF_LINK :    data += BLINKER_F("link"); break;
+        case PROF_TIMER :   data += BLINKER_F("timer"); break;
+        case PROF_PARSE :   data += BLINKER_F("parse"); break;
+        case PROF_AUTO :    data += BLINKER_F("auto"); break;
+        case PROF_FLUSH :   data += BLINKER_F("flush"); break;
+        default :           data += BLINKER_F("user"); break;
+    }
+}
+
+// {"loops":n,"worst":{"us":n,"phase":"..","msg":".."},
+//  "task":{"max":n,"hist":[..]},...}, hist[0] is 0us, hist[i] is
+// [2^(i-1), 2^i) us, trailing empty buckets are left out
+String BlinkerProfiler::dump()
+{
+    String data = BLINKER_F("{\"loops\":");
+    data += STRING_format(loopNum);
+    data += BLINKER_F(",\"worst\":{\"us\":");
+    data += STRING_format(worst);
+    data += BLINKER_F(",\"phase\":\"");
+    phaseName(data, worstPhase);
+    data += BLINKER_F("\",\"msg\":\"");
+
+    for (uint16_t num = 0; worstMsg[num]; num++)
+    {
+        if (worstMsg[num] == '"' || worstMsg[num] == '\\') data += '\\';
+        if ((uint8_t)worstMsg[num] >= ' ') data += worstMsg[num];
+    }
+
+    data += BLINKER_F("\"}");
+
+    for (uint8_t phase = 0; phase < PROF_NUM; phase++)
+    {
+        uint8_t used = BLINKER_PROFILE_BUCKETS;
+
+        while (used && !hist[phase][used - 1]) used--;
+
+        data += BLINKER_F(",\"");
+        phaseName(data, phase);
+        data += BLINKER_F("\":{\"max\":");
+        data += STRING_format(phaseMax[phase]);
+        data += BLINKER_F(",\"hist\":[");
+
+        for (uint8_t num = 0; num < used; num++)
+        {
+            if (num) data += ',';
+            data += STRING_format(hist[phase][num]);
+        }
+
+        data += BLINKER_F("]}");
+    }
+
+    data += '}';
+
+    return data;
+}
+
+#endif
+
+#endif
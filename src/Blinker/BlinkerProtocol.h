@@ -5,6 +5,7 @@
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerStream.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
 
 enum _blinker_state_t
 {
@@ -65,7 +66,8 @@ class BlinkerProtocol
         void flush();
         void checkState(bool state = true)      { isCheck = state; }
         void print(const String & data);
-        void print(const String & key, const String & data);
+        // false when the pending message has no room for it
+        bool print(const String & key, const String & data);
 
         #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
             defined(BLINKER_AT_MQTT) || defined(BLINKER_MQTT_AT) || \
@@ -96,12 +98,19 @@ class BlinkerProtocol
             void freshAlive() { if (isInit) conn->freshAlive(); }
         #endif
 
+        #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+            defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+            defined(BLINKER_PRO_ESP)
+            BlinkerSupervisor * link() { return isInit ? conn->link() : NULL; }
+        #endif
+
         #if defined(BLINKER_LOWPOWER_AIR202)
             char * deviceName() { if (isInit) return conn->deviceName(); else return ""; }
             char * authKey()    { if (isInit) return conn->authKey(); else return "";  }
             int init()          { return isInit ? conn->init() : false; }
             void begin(const char* _key, const char* _type, String _imei) { conn->begin(_key, _type, _imei); }
             int deviceRegister(){ return conn->deviceRegister(); }
+            int restore(const char* _key, const char* _name) { return conn->restore(_key, _name); }
         #endif
 
         #if defined(BLINKER_PRO) || defined(BLINKER_MQTT_AUTO) || \
@@ -145,6 +154,9 @@ class BlinkerProtocol
 
             void attachSubDisconnect(blinker_callback_t func)
             { if (isInit) conn->attachDisconnect(func); }
+
+            void subAddress(uint8_t id)
+            { if (isInit) conn->subAddress(id); }
         #endif
     // #endif
     private :
@@ -186,6 +198,7 @@ class BlinkerProtocol
             int mqttPrint(const String & data)
             { return conn->mqttPrint(data); }
             char * serialLastRead() { return conn->serialLastRead(); }
+            void serialFlush()      { conn->serialFlush(); }
             void aligenieType(blinker_at_aligenie_t _type)
             { conn->aligenieType(_type); }
             void duerType(blinker_at_dueros_t _type)
@@ -202,13 +215,17 @@ class BlinkerProtocol
         void checkAutoFormat();
         char* dataParse()       { if (canParse) return conn->lastRead(); else return ""; }
         char* lastRead()        { return conn->lastRead(); }
+        #if defined(BLINKER_MQTT) && defined(BLINKER_ARDUINOJSON)
+            JsonObject* dataObject()    { if (canParse) return conn->lastObject(); else return NULL; }
+            void dataHold(bool state)   { conn->hold(state); }
+        #endif
         void isParsed()         { flush(); }
         int parseState()        { return canParse; }
         int printNow();
         void _timerPrint(const String & n);
         int _print(char * n, bool needCheckLength = true);
 
-        void autoFormatData(const String & key, const String & jsonValue);
+        bool autoFormatData(const String & key, const String & jsonValue);
     // #endif
 };
 
@@ -257,7 +274,7 @@ void BlinkerProtocol::checkAutoFormat()
                 #endif
                 // #endif
             }
-            free(_sendBuf);
+            BLINKER_FREE(_sendBuf);
             autoFormat = false;
             BLINKER_LOG_FreeHeap_ALL();
         }
@@ -276,7 +293,7 @@ int BlinkerProtocol::printNow()
             if (_print(_sendBuf)) print_state = BLINKER_SUCCESS;
         #endif
 
-        free(_sendBuf);
+        BLINKER_FREE(_sendBuf);
         autoFormat = false;
         BLINKER_LOG_FreeHeap_ALL();
 
@@ -328,20 +345,22 @@ void BlinkerProtocol::print(const String & data)
     checkFormat();
     strcpy(_sendBuf, data.c_str());
     _print(_sendBuf);
-    free(_sendBuf);
+    BLINKER_FREE(_sendBuf);
     autoFormat = false;
     BLINKER_LOG_FreeHeap_ALL();
     #endif
 }
 
-void BlinkerProtocol::print(const String & key, const String & data)
+bool BlinkerProtocol::print(const String & key, const String & data)
 {
     checkFormat();
-    autoFormatData(key, data);
+    bool state = autoFormatData(key, data);
     if ((millis() - autoFormatFreshTime) >= BLINKER_MSG_AUTOFORMAT_TIMEOUT)
     {
         autoFormatFreshTime = millis();
     }
+
+    return state;
 }
 
 void BlinkerProtocol::checkFormat()
@@ -349,12 +368,12 @@ void BlinkerProtocol::checkFormat()
     if (!autoFormat)
     {
         autoFormat = true;
-        _sendBuf = (char*)malloc(BLINKER_MAX_SEND_SIZE*sizeof(char));
+        _sendBuf = (char*)BLINKER_MALLOC(HEAP_MSG, BLINKER_MAX_SEND_SIZE*sizeof(char));
         memset(_sendBuf, '\0', BLINKER_MAX_SEND_SIZE);
     }
 }
 
-void BlinkerProtocol::autoFormatData(const String & key, const String & jsonValue)
+bool BlinkerProtocol::autoFormatData(const String & key, const String & jsonValue)
 {
     #if defined(BLINKER_ARDUINOJSON)
         BLINKER_LOG_ALL(BLINKER_F("autoFormatData key: "), key, \
@@ -365,7 +384,7 @@ void BlinkerProtocol::autoFormatData(const String & key, const String & jsonValu
         if (STRING_contains_string(STRING_format(_sendBuf), key))
         {
 
-            DynamicJsonBuffer jsonSendBuffer;                
+            BlinkerJsonBuffer jsonSendBuffer;                
 
             if (strlen(_sendBuf)) {
                 BLINKER_LOG_ALL(BLINKER_F("add"));
@@ -416,7 +435,7 @@ void BlinkerProtocol::autoFormatData(const String & key, const String & jsonValu
         if (_data.length() > BLINKER_MAX_SEND_BUFFER_SIZE)
         {
             BLINKER_ERR_LOG(BLINKER_F("FORMAT DATA SIZE IS MAX THAN LIMIT: "), BLINKER_MAX_SEND_BUFFER_SIZE);
-            return;
+            return false;
         }
 
         strcpy(_sendBuf, _data.c_str());
@@ -430,7 +449,7 @@ void BlinkerProtocol::autoFormatData(const String & key, const String & jsonValu
         if ((strlen(_sendBuf) + jsonValue.length()) >= BLINKER_MAX_SEND_BUFFER_SIZE)
         {
             BLINKER_ERR_LOG(BLINKER_F("FORMAT DATA SIZE IS MAX THAN LIMIT"));
-            return;
+            return false;
         }
 
         if (strlen(_sendBuf) > 0) {
@@ -442,6 +461,8 @@ void BlinkerProtocol::autoFormatData(const String & key, const String & jsonValu
             strcpy(_sendBuf, data.c_str());
         }
     #endif
+
+    return true;
 }
 
 // #elif defined(BLINKER_LOWPOWER_AIR202)
@@ -0,0 +1,205 @@
+#ifndef BLINKER_REG_CACHE_H
+#define BLINKER_REG_CACHE_H
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include <time.h>
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include <EEPROM.h>
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+struct blinker_reg_cache_t
+{
+    // left out of the crc, it is stamped once the clock is set
+    uint32_t    saveTime;
+    uint32_t    crc;
+    uint16_t    version;
+    uint16_t    len;
+    uint32_t    keyHash;
+};
+
+// last good registration reply kept in eeprom, a warm boot uses it instead
+// of the https round trip, it is dropped when the broker turns it down or
+// BLINKER_REG_CACHE_TTL after it was saved
+class BlinkerRegCache
+{
+    public :
+        BlinkerRegCache()
+            : isChecked(false)
+        {}
+
+        bool load(const char * key, String & payload);
+        void save(const char * key, const String & payload);
+        // true once when the clock is set and the record is too old
+        bool expired();
+        void erase();
+
+    private :
+        bool        isChecked;
+
+        bool loadHead(blinker_reg_cache_t & head);
+        uint32_t crc32(uint32_t crc, const uint8_t * data, uint16_t len);
+};
+
+bool BlinkerRegCache::loadHead(blinker_reg_cache_t & head)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    EEPROM.get(BLINKER_EEP_ADDR_REG_CACHE, head);
+
+    if (head.version != BLINKER_REG_CACHE_VERSION || \
+        head.len == 0 || head.len > BLINKER_REG_CACHE_SIZE)
+    {
+        EEPROM.end();
+        return false;
+    }
+
+    crc = crc32(crc, (uint8_t *)&head.version, sizeof(head) - 8);
+
+    for (uint16_t num = 0; num < head.len; num++)
+    {
+        uint8_t c = EEPROM.read(BLINKER_EEP_ADDR_REG_CACHE + sizeof(head) + num);
+        crc = crc32(crc, &c, 1);
+    }
+
+    EEPROM.end();
+
+    return head.crc == ~crc;
+}
+
+bool BlinkerRegCache::load(const char * key, String & payload)
+{
+    blinker_reg_cache_t head;
+
+    if (!loadHead(head)) return false;
+
+    if (head.keyHash != ~crc32(0xFFFFFFFF, (const uint8_t *)key, strlen(key)))
+    {
+        return false;
+    }
+
+    payload = "";
+    payload.reserve(head.len);
+
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    for (uint16_t num = 0; num < head.len; num++)
+    {
+        payload += (char)EEPROM.read(BLINKER_EEP_ADDR_REG_CACHE + sizeof(head) + num);
+    }
+    EEPROM.end();
+
+    BLINKER_LOG_ALL(BLINKER_F("registration from cache, saved: "), head.saveTime);
+
+    return true;
+}
+
+void BlinkerRegCache::save(const char * key, const String & payload)
+{
+    blinker_reg_cache_t head;
+
+    if (payload.length() > BLINKER_REG_CACHE_SIZE)
+    {
+        BLINKER_ERR_LOG(BLINKER_F("registration too long to cache"));
+        return;
+    }
+
+    time_t now_ntp = ::time(nullptr);
+
+    head.saveTime = now_ntp > BLINKER_REG_CACHE_CLOCK ? now_ntp : 0;
+    head.version = BLINKER_REG_CACHE_VERSION;
+    head.len = payload.length();
+    head.keyHash = ~crc32(0xFFFFFFFF, (const uint8_t *)key, strlen(key));
+    head.crc = ~crc32(crc32(0xFFFFFFFF, (uint8_t *)&head.version, sizeof(head) - 8), \
+                        (const uint8_t *)payload.c_str(), head.len);
+
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    EEPROM.put(BLINKER_EEP_ADDR_REG_CACHE, head);
+    for (uint16_t num = 0; num < head.len; num++)
+    {
+        EEPROM.write(BLINKER_EEP_ADDR_REG_CACHE + sizeof(head) + num, payload[num]);
+    }
+    EEPROM.commit();
+    EEPROM.end();
+
+    isChecked = head.saveTime != 0;
+
+    BLINKER_LOG_ALL(BLINKER_F("registration cached"));
+}
+
+bool BlinkerRegCache::expired()
+{
+    if (isChecked) return false;
+
+    time_t now_ntp = ::time(nullptr);
+
+    if (now_ntp <= BLINKER_REG_CACHE_CLOCK) return false;
+
+    isChecked = true;
+
+    blinker_reg_cache_t head;
+
+    if (!loadHead(head)) return false;
+
+    // saved before the clock was set, the ttl starts now
+    if (!head.saveTime)
+    {
+        head.saveTime = now_ntp;
+
+        EEPROM.begin(BLINKER_EEP_SIZE);
+        EEPROM.put(BLINKER_EEP_ADDR_REG_CACHE, head);
+        EEPROM.commit();
+        EEPROM.end();
+
+        return false;
+    }
+
+    if ((uint32_t)now_ntp - head.saveTime < BLINKER_REG_CACHE_TTL) return false;
+
+    BLINKER_LOG_ALL(BLINKER_F("registration cache expired"));
+
+    return true;
+}
+
+void BlinkerRegCache::erase()
+{
+    blinker_reg_cache_t head;
+
+    if (!loadHead(head)) return;
+
+    memset(&head, 0, sizeof(head));
+
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    EEPROM.put(BLINKER_EEP_ADDR_REG_CACHE, head);
+    EEPROM.commit();
+    EEPROM.end();
+
+    BLINKER_LOG_ALL(BLINKER_F("registration cache erased"));
+}
+
+uint32_t BlinkerRegCache::crc32(uint32_t crc, const uint8_t * data, uint16_t len)
+{
+    while (len--)
+    {
+        crc ^= *data++;
+
+        for (uint8_t num = 0; num < 8; num++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+    }
+
+    return crc;
+}
+
+#endif
+
+#endif
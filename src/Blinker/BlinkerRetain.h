@@ -0,0 +1,182 @@
+#ifndef BLINKER_RETAIN_H
+#define BLINKER_RETAIN_H
+
+#if defined(BLINKER_LOWPOWER_AIR202)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+enum b_lp_phase_t {
+    LP_PHASE_CONNECT,
+    LP_PHASE_NTP,
+    LP_PHASE_GET,
+    LP_PHASE_USER,
+    LP_PHASE_UPLOAD,
+    LP_PHASE_NUM
+};
+
+struct blinker_retain_t
+{
+    uint32_t    crc;
+    uint32_t    wakes;
+    uint8_t     fails;
+    char        authKey[BLINKER_RETAIN_NAME_SIZE];
+    char        deviceName[BLINKER_RETAIN_NAME_SIZE];
+    // data whose upload failed, sent with the next wake's data
+    char        pending[BLINKER_RETAIN_PENDING_SIZE];
+};
+
+// rtc memory on ESP8266/ESP32, ram left alone by the startup code on AVR,
+// either may hold garbage after a power-on, so it is only used with a good crc
+#if defined(ESP32)
+    RTC_DATA_ATTR blinker_retain_t BLINKER_RETAIN_RTC;
+#elif defined(__AVR__)
+    blinker_retain_t BLINKER_RETAIN_RTC __attribute__ ((section (".noinit")));
+#elif !defined(ESP8266)
+    blinker_retain_t BLINKER_RETAIN_RTC;
+#endif
+
+// state kept from one low power wake to the next so a wake does not redo
+// the registration round trips, plus where the time of each wake went
+class BlinkerRetain
+{
+    public :
+        BlinkerRetain()
+            : lastMark(0)
+        {
+            memset(&ram, 0, sizeof(ram));
+            memset(phaseTime, 0, sizeof(phaseTime));
+        }
+
+        bool load();
+        void save();
+        bool hasAuth()          { return ram.authKey[0] && ram.deviceName[0]; }
+        const char * authKey()  { return ram.authKey; }
+        const char * deviceName() { return ram.deviceName; }
+        void keepAuth(const char * key, const char * name);
+        const char * pending()  { return ram.pending; }
+        // upload result of this wake, the data is kept for the next one
+        // if it failed, credentials are dropped after too many failures
+        void uploaded(bool state, const char * data);
+        void mark(uint8_t phase);
+        void report();
+
+    private :
+        blinker_retain_t    ram;
+        uint32_t            phaseTime[LP_PHASE_NUM];
+        uint32_t            lastMark;
+
+        uint32_t crc32(const uint8_t * data, uint16_t len);
+};
+
+bool BlinkerRetain::load()
+{
+    #if defined(ESP8266)
+        ESP.rtcUserMemoryRead(BLINKER_RETAIN_RTC_BLOCK, (uint32_t *)&ram, sizeof(ram));
+    #else
+        memcpy(&ram, &BLINKER_RETAIN_RTC, sizeof(ram));
+    #endif
+
+    if (ram.crc != crc32((uint8_t *)&ram + 4, sizeof(ram) - 4))
+    {
+        BLINKER_LOG_ALL(BLINKER_F("no retained state"));
+
+        memset(&ram, 0, sizeof(ram));
+        return false;
+    }
+
+    ram.wakes++;
+
+    BLINKER_LOG_ALL(BLINKER_F("retained state, wake: "), ram.wakes);
+
+    return true;
+}
+
+void BlinkerRetain::save()
+{
+    ram.crc = crc32((uint8_t *)&ram + 4, sizeof(ram) - 4);
+
+    #if defined(ESP8266)
+        ESP.rtcUserMemoryWrite(BLINKER_RETAIN_RTC_BLOCK, (uint32_t *)&ram, sizeof(ram));
+    #else
+        memcpy(&BLINKER_RETAIN_RTC, &ram, sizeof(ram));
+    #endif
+}
+
+void BlinkerRetain::keepAuth(const char * key, const char * name)
+{
+    if (strlen(key) >= BLINKER_RETAIN_NAME_SIZE || \
+        strlen(name) >= BLINKER_RETAIN_NAME_SIZE) return;
+
+    strcpy(ram.authKey, key);
+    strcpy(ram.deviceName, name);
+    ram.fails = 0;
+}
+
+void BlinkerRetain::uploaded(bool state, const char * data)
+{
+    if (state)
+    {
+        ram.fails = 0;
+        ram.pending[0] = '\0';
+        return;
+    }
+
+    if (strlen(data) < BLINKER_RETAIN_PENDING_SIZE) strcpy(ram.pending, data);
+    else BLINKER_ERR_LOG(BLINKER_F("pending data too long, dropped"));
+
+    // the retained credentials may be stale, register again next wake
+    if (++ram.fails >= BLINKER_RETAIN_FAIL_MAX)
+    {
+        ram.authKey[0] = '\0';
+        ram.deviceName[0] = '\0';
+        ram.fails = 0;
+    }
+}
+
+// time since the last mark is charged to phase
+void BlinkerRetain::mark(uint8_t phase)
+{
+    phaseTime[phase] += millis() - lastMark;
+    lastMark = millis();
+}
+
+void BlinkerRetain::report()
+{
+    BLINKER_LOG(BLINKER_F("wake: "), ram.wakes, \
+                BLINKER_F(", connect: "), phaseTime[LP_PHASE_CONNECT], \
+                BLINKER_F(", ntp: "), phaseTime[LP_PHASE_NTP], \
+                BLINKER_F(", get: "), phaseTime[LP_PHASE_GET], \
+                BLINKER_F(", user: "), phaseTime[LP_PHASE_USER], \
+                BLINKER_F(", upload: "), phaseTime[LP_PHASE_UPLOAD], \
+                BLINKER_F(", total: "), millis());
+
+    memset(phaseTime, 0, sizeof(phaseTime));
+}
+
+uint32_t BlinkerRetain::crc32(const uint8_t * data, uint16_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--)
+    {
+        crc ^= *data++;
+
+        for (uint8_t num = 0; num < 8; num++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+    }
+
+    return ~crc;
+}
+
+#endif
+
+#endif
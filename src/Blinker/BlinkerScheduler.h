@@ -0,0 +1,176 @@
+#ifndef BLINKER_SCHEDULER_H
+#define BLINKER_SCHEDULER_H
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+
+// cooperative tasks run from Blinker.run(), each task is a plain callback
+// that must return quickly and keeps its own state between calls
+// interval 0 runs the task once
+class BlinkerScheduler
+{
+    public :
+        BlinkerScheduler()
+            : taskMax(0)
+        {
+            for (uint8_t num = 0; num < BLINKER_MAX_TASK_SIZE; num++)
+            {
+                func[num] = NULL;
+                funcArg[num] = NULL;
+            }
+        }
+
+        int8_t attach(blinker_callback_t _func, uint32_t _interval, uint32_t _delay = 0);
+        int8_t attach(blinker_callback_with_arg_t _func, void * _arg, uint32_t _interval, uint32_t _delay = 0);
+        void detach(int8_t num);
+        void wake(int8_t num);
+        void run(uint32_t budget);
+        uint32_t nextWakeup();
+        uint32_t maxLatency()   { return taskMax; }
+
+    private :
+        blinker_callback_t          func[BLINKER_MAX_TASK_SIZE];
+        blinker_callback_with_arg_t funcArg[BLINKER_MAX_TASK_SIZE];
+        void *                      arg[BLINKER_MAX_TASK_SIZE];
+        uint32_t                    interval[BLINKER_MAX_TASK_SIZE];
+        uint32_t                    deadline[BLINKER_MAX_TASK_SIZE];
+        uint32_t                    taskMax;
+
+        int8_t slot();
+        bool used(uint8_t num) { return func[num] || funcArg[num]; }
+};
+
+int8_t BlinkerScheduler::slot()
+{
+    for (uint8_t num = 0; num < BLINKER_MAX_TASK_SIZE; num++)
+    {
+        if (!used(num)) return num;
+    }
+
+    BLINKER_ERR_LOG(BLINKER_F("no free task slot, max: "), BLINKER_MAX_TASK_SIZE);
+
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+int8_t BlinkerScheduler::attach(blinker_callback_t _func, uint32_t _interval, uint32_t _delay)
+{
+    int8_t num = slot();
+
+    if (num == BLINKER_OBJECT_NOT_AVAIL) return num;
+
+    func[num] = _func;
+    interval[num] = _interval;
+    deadline[num] = millis() + _delay;
+
+    return num;
+}
+
+int8_t BlinkerScheduler::attach(blinker_callback_with_arg_t _func, void * _arg, uint32_t _interval, uint32_t _delay)
+{
+    int8_t num = slot();
+
+    if (num == BLINKER_OBJECT_NOT_AVAIL) return num;
+
+    funcArg[num] = _func;
+    arg[num] = _arg;
+    interval[num] = _interval;
+    deadline[num] = millis() + _delay;
+
+    return num;
+}
+
+void BlinkerScheduler::detach(int8_t num)
+{
+    if (num < 0 || num >= BLINKER_MAX_TASK_SIZE) return;
+
+    func[num] = NULL;
+    funcArg[num] = NULL;
+}
+
+void BlinkerScheduler::wake(int8_t num)
+{
+    if (num < 0 || num >= BLINKER_MAX_TASK_SIZE) return;
+
+    deadline[num] = millis();
+}
+
+// run due tasks, most overdue first, until the budget (us) is spent,
+// whatever is left runs on the next pass
+void BlinkerScheduler::run(uint32_t budget)
+{
+    uint32_t start = micros();
+
+    while ((micros() - start) < budget)
+    {
+        uint32_t now = millis();
+        int8_t due = BLINKER_OBJECT_NOT_AVAIL;
+        int32_t late = -1;
+
+        for (uint8_t num = 0; num < BLINKER_MAX_TASK_SIZE; num++)
+        {
+            if (used(num) && (int32_t)(now - deadline[num]) > late)
+            {
+                due = num;
+                late = now - deadline[num];
+            }
+        }
+
+        if (due == BLINKER_OBJECT_NOT_AVAIL) return;
+
+        blinker_callback_t _func = func[due];
+        blinker_callback_with_arg_t _funcArg = funcArg[due];
+
+        if (interval[due] == 0)
+        {
+            detach(due);
+        }
+        else
+        {
+            deadline[due] += interval[due];
+
+            // too far behind, do not try to catch up
+            if ((int32_t)(now - deadline[due]) >= 0) deadline[due] = now + interval[due];
+        }
+
+        uint32_t taskStart = micros();
+
+        if (_func) _func();
+        else _funcArg(arg[due]);
+
+        uint32_t taskTime = micros() - taskStart;
+
+        if (taskTime > taskMax) taskMax = taskTime;
+
+        if (taskTime > budget)
+        {
+            BLINKER_LOG_ALL(BLINKER_F("task "), due, BLINKER_F(" over budget: "), taskTime);
+        }
+    }
+}
+
+// ms until the next task is due, 0 if one is due now
+uint32_t BlinkerScheduler::nextWakeup()
+{
+    uint32_t now = millis();
+    uint32_t wait = 0xFFFFFFFF;
+
+    for (uint8_t num = 0; num < BLINKER_MAX_TASK_SIZE; num++)
+    {
+        if (!used(num)) continue;
+
+        if ((int32_t)(deadline[num] - now) <= 0) return 0;
+
+        if (deadline[num] - now < wait) wait = deadline[num] - now;
+    }
+
+    return wait;
+}
+
+#endif
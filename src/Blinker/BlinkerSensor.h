@@ -0,0 +1,145 @@
+#ifndef BLINKER_SENSOR_H
+#define BLINKER_SENSOR_H
+
+#if defined(BLINKER_SENSOR_STREAM)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+typedef struct
+{
+    uint8_t     type;
+    uint16_t    seq;
+    uint32_t    time;
+    // ahrs: yaw, pitch, roll in 0.1 degree
+    // gps: long, lat in 0.000001 degree
+    int32_t     value[3];
+} b_sensor_t;
+
+// phone sensor samples from binary websocket frames or json messages,
+// the websocket event is the only producer and the sketch the only
+// consumer, so head and tail each have a single writer
+class BlinkerSensor
+{
+    public :
+        BlinkerSensor()
+            : head(0)
+            , tail(0)
+            , ahrsCount(0)
+            , gpsTime(0)
+            , drop(0)
+            , rate(0)
+        {
+            for (uint8_t num = 0; num < 3; num++) ahrsLast[num] = 0;
+            for (uint8_t num = 0; num < 2; num++) gpsLast[num] = 0;
+        }
+
+        bool push(const uint8_t * data, size_t len);
+        void put(const b_sensor_t & sample);
+        bool read(b_sensor_t & sample);
+
+        int16_t ahrs(uint8_t axis)  { return ahrsLast[axis] / 10; }
+        int32_t gps(uint8_t axis)   { return gpsLast[axis]; }
+        uint32_t ahrsNum()          { return ahrsCount; }
+        uint32_t gpsFresh()         { return gpsTime; }
+        uint32_t dropNum()          { return drop; }
+        uint8_t freq()              { return rate; }
+        void freq(uint8_t _rate)    { rate = _rate; }
+
+    private :
+        b_sensor_t          ring[BLINKER_SENSOR_RING_SIZE];
+        volatile uint8_t    head;
+        volatile uint8_t    tail;
+        volatile int16_t    ahrsLast[3];
+        volatile int32_t    gpsLast[2];
+        volatile uint32_t   ahrsCount;
+        volatile uint32_t   gpsTime;
+        uint32_t            drop;
+        uint8_t             rate;
+};
+
+bool BlinkerSensor::push(const uint8_t * data, size_t len)
+{
+    if (len < 4 || data[0] != BLINKER_SENSOR_MAGIC) return false;
+
+    b_sensor_t sample;
+
+    sample.type = data[1];
+    sample.seq = data[2] | (uint16_t)data[3] << 8;
+    sample.time = millis();
+    sample.value[2] = 0;
+
+    if (sample.type == BLINKER_SENSOR_AHRS && len >= 10)
+    {
+        for (uint8_t num = 0; num < 3; num++)
+        {
+            sample.value[num] = (int16_t)(data[4 + num*2] | (uint16_t)data[5 + num*2] << 8);
+        }
+    }
+    else if (sample.type == BLINKER_SENSOR_GPS && len >= 12)
+    {
+        for (uint8_t num = 0; num < 2; num++)
+        {
+            sample.value[num] = (int32_t)((uint32_t)data[4 + num*4] | \
+                                (uint32_t)data[5 + num*4] << 8 | \
+                                (uint32_t)data[6 + num*4] << 16 | \
+                                (uint32_t)data[7 + num*4] << 24);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    put(sample);
+
+    return true;
+}
+
+void BlinkerSensor::put(const b_sensor_t & sample)
+{
+    if (sample.type == BLINKER_SENSOR_AHRS)
+    {
+        for (uint8_t num = 0; num < 3; num++) ahrsLast[num] = sample.value[num];
+        ahrsCount++;
+    }
+    else
+    {
+        for (uint8_t num = 0; num < 2; num++) gpsLast[num] = sample.value[num];
+        gpsTime = sample.time ? sample.time : 1;
+    }
+
+    uint8_t next = (head + 1) & (BLINKER_SENSOR_RING_SIZE - 1);
+
+    // full, keep the older samples for the reader and count the loss
+    if (next == tail)
+    {
+        drop++;
+        return;
+    }
+
+    ring[head] = sample;
+    head = next;
+}
+
+bool BlinkerSensor::read(b_sensor_t & sample)
+{
+    if (tail == head) return false;
+
+    sample = ring[tail];
+    tail = (tail + 1) & (BLINKER_SENSOR_RING_SIZE - 1);
+
+    return true;
+}
+
+BlinkerSensor   BLINKER_SENSOR;
+
+#endif
+
+#endif
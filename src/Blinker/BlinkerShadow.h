@@ -0,0 +1,232 @@
+#ifndef BLINKER_SHADOW_H
+#define BLINKER_SHADOW_H
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+
+#if BLINKER_SHADOW_SIZE > 0xFF
+    #error "BLINKER_SHADOW_SIZE is indexed by uint8_t, keep it at 255 or below"
+#endif
+
+// last published widget attributes, up to 8 per widget
+// staged attributes keep their value in the slab as id | len | data,
+// values handed straight to print() only keep a hash, use ids
+// below BLINKER_SHADOW_HASH_NUM for them
+// a value the slab has no room for is kept on the heap as
+// id | len lo | len hi | data and sent once without a shadow
+class BlinkerShadow
+{
+    public :
+        BlinkerShadow()
+            : slabLen(0)
+            , stored(0)
+            , published(0)
+            , dirty(0)
+            , epoch(0)
+            , loose(NULL)
+            , looseLen(0)
+        {}
+
+        ~BlinkerShadow() { BLINKER_FREE(loose); }
+
+        // false only when the value can not be kept at all
+        bool stage(uint8_t num, const String & data)
+        {
+            uint8_t pos;
+            uint16_t room = BLINKER_SHADOW_SIZE - slabLen;
+            bool held = find(num, pos);
+
+            if (held)
+            {
+                if ((uint8_t)slab[pos + 1] == data.length() && \
+                    memcmp(slab + pos + 2, data.c_str(), data.length()) == 0)
+                {
+                    return true;
+                }
+
+                room += (uint8_t)slab[pos + 1] + 2;
+            }
+
+            // the new value replaces the old one either way
+            if (held) remove(pos);
+
+            if (data.length() > 0xFF || data.length() + 2 > room)
+            {
+                BLINKER_LOG_ALL(BLINKER_F("widget attribute not shadowed: "), data);
+
+                return loosen(num, data);
+            }
+
+            unloose(num);
+
+            slab[slabLen++] = num;
+            slab[slabLen++] = data.length();
+            memcpy(slab + slabLen, data.c_str(), data.length());
+            slabLen += data.length();
+
+            stored |= 0x01 << num;
+            dirty |= 0x01 << num;
+
+            return true;
+        }
+
+        bool check(uint8_t num, const String & data)
+        {
+            if (num >= BLINKER_SHADOW_HASH_NUM) return true;
+
+            uint32_t _hash = STRING_hash(data.c_str());
+
+            if ((published >> num & 0x01) && hash[num] == _hash) return false;
+
+            hash[num] = _hash;
+            dirty |= 0x01 << num;
+
+            return true;
+        }
+
+        // the app asked for full state, resend everything we hold
+        void sync(uint16_t _epoch)
+        {
+            if (_epoch == epoch) return;
+
+            epoch = _epoch;
+            published = 0;
+            dirty |= stored;
+        }
+
+        void emit(String & data, uint8_t num, const __FlashStringHelper * key)
+        {
+            uint8_t pos;
+            uint16_t lpos;
+            const char * value;
+            uint16_t len;
+
+            if (findLoose(num, lpos))
+            {
+                value = loose + lpos + 3;
+                len = (uint8_t)loose[lpos + 1] | ((uint16_t)(uint8_t)loose[lpos + 2] << 8);
+            }
+            else if ((dirty >> num & 0x01) && find(num, pos))
+            {
+                value = slab + pos + 2;
+                len = (uint8_t)slab[pos + 1];
+            }
+            else
+            {
+                return;
+            }
+
+            data += data.length() ? BLINKER_F(",\"") : BLINKER_F("{\"");
+            data += key;
+            data += BLINKER_F("\":\"");
+            for (uint16_t cnt = 0; cnt < len; cnt++) data += value[cnt];
+            data += BLINKER_F("\"");
+        }
+
+        void commit()
+        {
+            published |= dirty;
+            dirty = 0;
+
+            BLINKER_FREE(loose);
+            loose = NULL;
+            looseLen = 0;
+        }
+
+        bool isDirty() { return dirty != 0 || looseLen != 0; }
+        bool isDirty(uint8_t num)
+        {
+            uint16_t lpos;
+
+            return (dirty >> num & 0x01) || findLoose(num, lpos);
+        }
+
+    private :
+        char        slab[BLINKER_SHADOW_SIZE];
+        uint32_t    hash[BLINKER_SHADOW_HASH_NUM];
+        uint8_t     slabLen;
+        uint8_t     stored;
+        uint8_t     published;
+        uint8_t     dirty;
+        uint16_t    epoch;
+        char *      loose;
+        uint16_t    looseLen;
+
+        bool find(uint8_t num, uint8_t & pos)
+        {
+            if (!(stored >> num & 0x01)) return false;
+
+            for (pos = 0; pos < slabLen; pos += (uint8_t)slab[pos + 1] + 2)
+            {
+                if (slab[pos] == num) return true;
+            }
+
+            return false;
+        }
+
+        void remove(uint8_t pos)
+        {
+            uint8_t size = (uint8_t)slab[pos + 1] + 2;
+
+            stored &= ~(0x01 << slab[pos]);
+
+            memmove(slab + pos, slab + pos + size, slabLen - pos - size);
+            slabLen -= size;
+        }
+
+        bool findLoose(uint8_t num, uint16_t & pos)
+        {
+            for (pos = 0; pos < looseLen; )
+            {
+                if (loose[pos] == num) return true;
+
+                pos += ((uint8_t)loose[pos + 1] | ((uint16_t)(uint8_t)loose[pos + 2] << 8)) + 3;
+            }
+
+            return false;
+        }
+
+        void unloose(uint8_t num)
+        {
+            uint16_t pos;
+
+            if (!findLoose(num, pos)) return;
+
+            uint16_t size = ((uint8_t)loose[pos + 1] | ((uint16_t)(uint8_t)loose[pos + 2] << 8)) + 3;
+
+            memmove(loose + pos, loose + pos + size, looseLen - pos - size);
+            looseLen -= size;
+        }
+
+        bool loosen(uint8_t num, const String & data)
+        {
+            unloose(num);
+
+            char * grown = (char*)BLINKER_REALLOC(HEAP_WIDGET, loose, looseLen + data.length() + 3);
+
+            if (grown == NULL)
+            {
+                BLINKER_ERR_LOG(BLINKER_F("widget attribute dropped, no memory: "), data);
+                return false;
+            }
+
+            loose = grown;
+            loose[looseLen++] = num;
+            loose[looseLen++] = data.length() & 0xFF;
+            loose[looseLen++] = data.length() >> 8;
+            memcpy(loose + looseLen, data.c_str(), data.length());
+            looseLen += data.length();
+
+            return true;
+        }
+};
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef BLINKER_SNAPSHOT_H
+#define BLINKER_SNAPSHOT_H
+
+#if defined(BLINKER_SNAPSHOT)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerJson.h"
+
+// latest state of every widget, kept pre-serialized as
+// "name":{...},"name":{...} so a state request is answered with one copy,
+// widget updates are merged in as text when they are printed, every
+// widget keeps the hash and offset of its key so no lookup scans the text
+class BlinkerSnapshot
+{
+    public :
+        BlinkerSnapshot()
+            : len(0)
+            , ver(0)
+            , full(false)
+            , num(0)
+        { buf[0] = '\0'; }
+
+        void update(const String & key, const String & value);
+        // drop everything, the next full resend fills it again
+        void clear();
+        // the reply did not go out, state requests fall back to a full
+        // resend until the snapshot is rebuilt
+        void reject()           { full = true; }
+        bool contains(const char * key)
+        {
+            return find(key, strlen(key), STRING_hash(key)) != BLINKER_OBJECT_NOT_AVAIL;
+        }
+
+        const char * data()     { return buf; }
+        uint16_t length()       { return len; }
+        uint32_t version()      { return ver; }
+        // some widget did not fit, the snapshot is not complete
+        bool overflow()         { return full; }
+
+    private :
+        char        buf[BLINKER_SNAPSHOT_SIZE];
+        uint16_t    len;
+        uint32_t    ver;
+        bool        full;
+        uint8_t     num;
+        uint32_t    keyHash[BLINKER_SNAPSHOT_KEYS];
+        // offset of the opening quote of the key
+        uint16_t    keyPos[BLINKER_SNAPSHOT_KEYS];
+
+        int8_t find(const char * key, uint16_t keyLen, uint32_t _hash);
+        void drop(const String & key);
+        void merge(String & data, const String & value);
+        bool member(const String & data, uint16_t & pos, uint16_t & keyStart, \
+                    uint16_t & keyEnd, uint16_t & valStart, uint16_t & valEnd);
+};
+
+void BlinkerSnapshot::update(const String & key, const String & value)
+{
+    uint32_t _hash = STRING_hash(key.c_str());
+    int8_t slot = find(key.c_str(), key.length(), _hash);
+
+    if (slot == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        uint16_t size = key.length() + value.length() + 3 + (len ? 1 : 0);
+
+        if (num >= BLINKER_SNAPSHOT_KEYS || len + size >= BLINKER_SNAPSHOT_SIZE)
+        {
+            drop(key);
+            return;
+        }
+
+        if (len) buf[len++] = ',';
+
+        keyHash[num] = _hash;
+        keyPos[num] = len;
+        num++;
+
+        buf[len++] = '"';
+        memcpy(buf + len, key.c_str(), key.length());
+        len += key.length();
+        buf[len++] = '"';
+        buf[len++] = ':';
+        memcpy(buf + len, value.c_str(), value.length());
+        len += value.length();
+        buf[len] = '\0';
+    }
+    else
+    {
+        uint16_t start = keyPos[slot] + key.length() + 3;
+        uint16_t end = (slot + 1 < num) ? keyPos[slot + 1] - 1 : len;
+
+        String _data;
+        _data.reserve(end - start + value.length());
+        for (uint16_t pos = start; pos < end; pos++) _data += buf[pos];
+
+        merge(_data, value);
+
+        if (_data.length() == end - start && \
+            memcmp(buf + start, _data.c_str(), _data.length()) == 0)
+        {
+            return;
+        }
+
+        int16_t diff = (int16_t)_data.length() - (int16_t)(end - start);
+
+        if (len + diff >= BLINKER_SNAPSHOT_SIZE)
+        {
+            drop(key);
+            return;
+        }
+
+        memmove(buf + end + diff, buf + end, len - end + 1);
+        memcpy(buf + start, _data.c_str(), _data.length());
+        len += diff;
+
+        for (uint8_t next = slot + 1; next < num; next++) keyPos[next] += diff;
+    }
+
+    ver++;
+
+    BLINKER_LOG_ALL(BLINKER_F("snapshot ver: "), ver, BLINKER_F(", len: "), len);
+}
+
+void BlinkerSnapshot::drop(const String & key)
+{
+    BLINKER_ERR_LOG(BLINKER_F("snapshot full, drop: "), key);
+
+    full = true;
+    ver++;
+}
+
+void BlinkerSnapshot::clear()
+{
+    len = 0;
+    num = 0;
+    buf[0] = '\0';
+    full = false;
+    ver++;
+}
+
+int8_t BlinkerSnapshot::find(const char * key, uint16_t keyLen, uint32_t _hash)
+{
+    for (uint8_t slot = 0; slot < num; slot++)
+    {
+        if (keyHash[slot] != _hash) continue;
+
+        uint16_t pos = keyPos[slot] + 1;
+
+        if (strncmp(buf + pos, key, keyLen) == 0 && buf[pos + keyLen] == '"')
+        {
+            return slot;
+        }
+    }
+
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+// members of value replace or extend the ones in data, anything that is
+// not an object replaces data as a whole
+void BlinkerSnapshot::merge(String & data, const String & value)
+{
+    if (!data.startsWith("{") || !value.startsWith("{"))
+    {
+        data = value;
+        return;
+    }
+
+    uint16_t pos = 1;
+    uint16_t keyStart, keyEnd, valStart, valEnd;
+
+    while (member(value, pos, keyStart, keyEnd, valStart, valEnd))
+    {
+        char key[BLINKER_SNAPSHOT_KEY_SIZE];
+        uint16_t keyLen = keyEnd - keyStart;
+        uint16_t start, end;
+
+        if (keyLen >= BLINKER_SNAPSHOT_KEY_SIZE)
+        {
+            data = value;
+            return;
+        }
+
+        memcpy(key, value.c_str() + keyStart, keyLen);
+        key[keyLen] = '\0';
+
+        if (JSON_find_value(data.c_str(), key, start, end))
+        {
+            data = data.substring(0, start) + \
+                    value.substring(valStart, valEnd) + \
+                    data.substring(end);
+        }
+        else
+        {
+            uint16_t close = data.lastIndexOf('}');
+            String _member = data.substring(1, close).length() ? \
+                            BLINKER_F(",") : BLINKER_F("");
+
+            _member += value.substring(keyStart - 1, valEnd);
+
+            data = data.substring(0, close) + _member + data.substring(close);
+        }
+    }
+}
+
+// next top level member of the object in data, starting at pos
+bool BlinkerSnapshot::member(const String & data, uint16_t & pos, uint16_t & keyStart, \
+                            uint16_t & keyEnd, uint16_t & valStart, uint16_t & valEnd)
+{
+    uint16_t dataLen = data.length();
+
+    while (pos < dataLen && (data[pos] == ',' || data[pos] == ' ')) pos++;
+
+    if (pos >= dataLen || data[pos] != '"') return false;
+
+    keyStart = ++pos;
+
+    while (pos < dataLen && data[pos] != '"')
+    {
+        if (data[pos] == '\\') pos++;
+        pos++;
+    }
+
+    if (pos >= dataLen) return false;
+
+    keyEnd = pos++;
+
+    while (pos < dataLen && (data[pos] == ' ' || data[pos] == ':')) pos++;
+
+    valStart = pos;
+
+    uint8_t depth = 0;
+    bool quote = false;
+
+    for (; pos < dataLen; pos++)
+    {
+        char c = data[pos];
+
+        if (quote)
+        {
+            if (c == '\\') pos++;
+            else if (c == '"') quote = false;
+        }
+        else if (c == '"') quote = true;
+        else if (c == '{' || c == '[') depth++;
+        else if ((c == '}' || c == ']') && depth) depth--;
+        else if ((c == ',' || c == '}') && depth == 0) break;
+    }
+
+    if (pos >= dataLen) return false;
+
+    valEnd = pos;
+
+    while (valEnd > valStart && data[valEnd - 1] == ' ') valEnd--;
+
+    return true;
+}
+
+#endif
+
+#endif
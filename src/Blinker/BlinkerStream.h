@@ -13,6 +13,8 @@
 
 #include "Blinker/BlinkerUtility.h"
 
+class BlinkerSupervisor;
+
 class BlinkerStream
 {
     public :
@@ -51,6 +53,19 @@ class BlinkerStream
             #endif
         #endif
 
+        #if defined(BLINKER_MQTT) && defined(BLINKER_ARDUINOJSON)
+            // data object parsed in place by the adapter, held while dispatched
+            virtual JsonObject * lastObject() = 0;
+            virtual void hold(bool state) = 0;
+        #endif
+
+        #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
+            defined(BLINKER_GATEWAY) || defined(BLINKER_MQTT_AUTO) || \
+            defined(BLINKER_PRO_ESP)
+            // broker connection supervisor, for its link quality numbers
+            virtual BlinkerSupervisor * link() = 0;
+        #endif
+
         #if defined(BLINKER_MQTT) || defined(BLINKER_PRO) || \
             defined(BLINKER_AT_MQTT) || defined(BLINKER_GATEWAY) || \
             defined(BLINKER_GPRS_AIR202) || defined(BLINKER_NBIOT_SIM7020) || \
@@ -69,6 +84,7 @@ class BlinkerStream
             virtual int init() = 0;
             virtual void begin(const char* _key, const char* _type, String _imei) = 0;
             virtual int deviceRegister() = 0;   
+            virtual int restore(const char* _key, const char* _name) = 0;
         #endif
 
         // #if defined(BLINKER_MQTT) || defined(BLINKER_PRO)
@@ -82,6 +98,7 @@ class BlinkerStream
             virtual int serialPrint(const String & s, bool needCheck = true) = 0;
             virtual int mqttPrint(const String & data);
             virtual char * serialLastRead() = 0;
+            virtual void serialFlush() = 0;
             virtual void aligenieType(int _type) = 0;
             virtual void duerType(int _type) = 0;
             virtual char * deviceId() = 0;
@@ -120,6 +137,7 @@ class BlinkerStream
             virtual void attachConnect(blinker_callback_return_int_t func) = 0;
             virtual void attachConnected(blinker_callback_return_int_t func) = 0;
             virtual void attachDisconnect(blinker_callback_t func) = 0;
+            virtual void subAddress(uint8_t id) = 0;
         #endif
     // #endif
 };
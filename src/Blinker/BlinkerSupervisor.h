@@ -0,0 +1,285 @@
+#ifndef BLINKER_SUPERVISOR_H
+#define BLINKER_SUPERVISOR_H
+
+#if defined(ESP8266) || defined(ESP32)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "modules/mqtt/Adafruit_MQTT.h"
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+enum b_mqtt_link_t {
+    MQTT_LINK_IDLE,
+    MQTT_LINK_CONNECTING,
+    MQTT_LINK_ONLINE
+};
+
+// broker connection supervisor, CONNECT/CONNACK and pings are sent and
+// checked from the loop without waiting on the socket
+// failed connects back off exponentially with jitter, so devices that lost
+// the broker together do not come back in lockstep, the ping interval grows
+// while pings come back and drops below the idle time a NAT forgot us at
+class BlinkerSupervisor
+{
+    public :
+        BlinkerSupervisor()
+            : mqtt(NULL)
+            , state(MQTT_LINK_IDLE)
+            , fail(0)
+            , retryTime(0)
+            , stateTime(0)
+            , pingTime(0)
+            , interval(BLINKER_MQTT_PING_TIMEOUT)
+            , ceiling(BLINKER_MQTT_PING_MAX)
+            , _rtt(0)
+            , reconnect(0)
+            , offline(0)
+            , downTime(0)
+        {}
+
+        void attach(Adafruit_MQTT * _mqtt);
+        int8_t connect();
+        void disconnect();
+        bool keepAlive(uint32_t active);
+        bool connected()
+        { return state == MQTT_LINK_ONLINE && mqtt->connected(); }
+
+        // consecutive failed connects
+        uint8_t failNum()           { return fail; }
+        // last CONNACK or PINGRESP round trip, ms
+        uint16_t rtt()              { return _rtt; }
+        uint32_t reconnectNum()     { return reconnect; }
+        // total ms spent offline after the first connect
+        uint32_t offlineTime();
+        uint32_t pingInterval()     { return interval; }
+
+    private :
+        Adafruit_MQTT * mqtt;
+        uint8_t     state;
+        uint8_t     fail;
+        uint32_t    retryTime;
+        uint32_t    stateTime;
+        uint32_t    pingTime;
+        uint32_t    interval;
+        uint32_t    ceiling;
+        uint16_t    _rtt;
+        uint32_t    reconnect;
+        uint32_t    offline;
+        uint32_t    downTime;
+
+        void down();
+        void shrink();
+        void backoff();
+};
+
+void BlinkerSupervisor::attach(Adafruit_MQTT * _mqtt)
+{
+    if (state == MQTT_LINK_ONLINE) down();
+
+    mqtt = _mqtt;
+    state = MQTT_LINK_IDLE;
+}
+
+// MQTT_CONNECT_WAIT while backing off or waiting for the CONNACK, then
+// 0 once connected or the connect() error code once failed
+int8_t BlinkerSupervisor::connect()
+{
+    if (mqtt == NULL) return MQTT_CONNECT_WAIT;
+
+    if (state == MQTT_LINK_ONLINE)
+    {
+        if (mqtt->connected()) return 0;
+
+        BLINKER_ERR_LOG(BLINKER_F("MQTT connection lost"));
+
+        if (pingTime) shrink();
+
+        down();
+    }
+
+    if (state == MQTT_LINK_IDLE)
+    {
+        if ((int32_t)(millis() - retryTime) < 0) return MQTT_CONNECT_WAIT;
+
+        BLINKER_LOG(BLINKER_F("Connecting to MQTT... "));
+
+        mqtt->disconnect();
+
+        int8_t ret = mqtt->connectBegin();
+
+        if (ret != 0)
+        {
+            backoff();
+            return ret;
+        }
+
+        state = MQTT_LINK_CONNECTING;
+        stateTime = millis();
+
+        return MQTT_CONNECT_WAIT;
+    }
+
+    int8_t ret = mqtt->connectPoll();
+
+    if (ret == MQTT_CONNECT_WAIT)
+    {
+        if (millis() - stateTime < BLINKER_MQTT_CONNACK_TIMEOUT) return ret;
+
+        ret = -3;
+    }
+
+    if (ret != 0)
+    {
+        mqtt->disconnect();
+        state = MQTT_LINK_IDLE;
+        backoff();
+        return ret;
+    }
+
+    _rtt = millis() - stateTime;
+
+    if (downTime)
+    {
+        offline += millis() - downTime;
+        downTime = 0;
+        reconnect++;
+    }
+
+    state = MQTT_LINK_ONLINE;
+    fail = 0;
+    pingTime = 0;
+
+    BLINKER_LOG_ALL(BLINKER_F("MQTT connack rtt: "), _rtt, \
+                    BLINKER_F(", reconnect: "), reconnect);
+
+    return 0;
+}
+
+void BlinkerSupervisor::disconnect()
+{
+    if (mqtt == NULL) return;
+
+    mqtt->disconnect();
+
+    if (state == MQTT_LINK_ONLINE) down();
+
+    state = MQTT_LINK_IDLE;
+}
+
+// ping once nothing was sent or heard for the current interval, call every
+// loop while connected, false once the broker stopped answering
+bool BlinkerSupervisor::keepAlive(uint32_t active)
+{
+    if (!connected()) return false;
+
+    uint32_t now = millis();
+
+    if (pingTime)
+    {
+        if ((int32_t)(mqtt->lastPingResp() - pingTime) >= 0)
+        {
+            _rtt = mqtt->lastPingResp() - pingTime;
+            pingTime = 0;
+
+            // this much silence was survived, stretch it a bit
+            uint32_t limit = ceiling < BLINKER_MQTT_PING_MAX ? \
+                            ceiling - ceiling / 4 : BLINKER_MQTT_PING_MAX;
+
+            if (limit < BLINKER_MQTT_PING_MIN) limit = BLINKER_MQTT_PING_MIN;
+
+            interval += interval / 4;
+            if (interval > limit) interval = limit;
+
+            BLINKER_LOG_ALL(BLINKER_F("MQTT ping rtt: "), _rtt, \
+                            BLINKER_F(", next in: "), interval);
+        }
+        else if (now - pingTime >= BLINKER_MQTT_PING_WAIT)
+        {
+            BLINKER_ERR_LOG(BLINKER_F("MQTT ping timeout"));
+
+            shrink();
+            disconnect();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t last = mqtt->lastRead();
+
+    if ((int32_t)(active - last) > 0) last = active;
+
+    if (now - last < interval) return true;
+
+    BLINKER_LOG_ALL(BLINKER_F("MQTT Ping!"));
+
+    if (!mqtt->pingBegin())
+    {
+        shrink();
+        disconnect();
+
+        return false;
+    }
+
+    pingTime = now ? now : 1;
+
+    return true;
+}
+
+uint32_t BlinkerSupervisor::offlineTime()
+{
+    if (downTime) return offline + millis() - downTime;
+    else return offline;
+}
+
+void BlinkerSupervisor::down()
+{
+    downTime = millis() ? millis() : 1;
+    pingTime = 0;
+    state = MQTT_LINK_IDLE;
+
+    // a broker blip drops everybody at once, spread the first retry
+    retryTime = millis() + random(BLINKER_MQTT_CONNECT_TIMESLOT);
+}
+
+// the path dropped us somewhere inside this much silence
+void BlinkerSupervisor::shrink()
+{
+    ceiling = interval;
+    interval /= 2;
+    if (interval < BLINKER_MQTT_PING_MIN) interval = BLINKER_MQTT_PING_MIN;
+
+    BLINKER_LOG_ALL(BLINKER_F("MQTT ping interval: "), interval);
+}
+
+void BlinkerSupervisor::backoff()
+{
+    if (fail < 0xFF) fail++;
+
+    uint32_t wait = BLINKER_MQTT_CONNECT_TIMESLOT;
+
+    for (uint8_t num = 1; num < fail && wait < BLINKER_MQTT_BACKOFF_MAX; num++)
+    {
+        wait *= 2;
+    }
+
+    if (wait > BLINKER_MQTT_BACKOFF_MAX) wait = BLINKER_MQTT_BACKOFF_MAX;
+
+    // equal jitter, somewhere in [wait/2, wait]
+    wait = wait / 2 + random(wait / 2 + 1);
+
+    retryTime = millis() + wait;
+
+    BLINKER_LOG(BLINKER_F("Retrying MQTT connection in "), \
+                wait / 1000, BLINKER_F(" seconds..."));
+}
+
+#endif
+
+#endif
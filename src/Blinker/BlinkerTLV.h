@@ -0,0 +1,493 @@
+#ifndef BLINKER_TLV_H
+#define BLINKER_TLV_H
+
+#if defined(BLINKER_GATEWAY) || \
+    (defined(BLINKER_SUBDEVICE) && defined(BLINKER_SUB_TLV))
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+#include "modules/ArduinoJson/ArduinoJson.h"
+
+// frame: flags | records ... | crc8, escaped so it holds no 0x00, '\r', '\n'
+// record: tag (type << 5 | key id) | [key len | key] | value
+// key id 0 defines the next dictionary id, 31 is a literal key
+// float value: 4 bytes | decimals it was written with
+// keys defined by encode() are staged, commit() keeps them once the
+// frame went out, a frame that was not sent leaves the dictionary as is
+
+class BlinkerTLV
+{
+    public :
+        BlinkerTLV()
+            : encCount(0)
+            , encStage(0)
+            , decCount(0)
+            , txFlag(BLINKER_TLV_FLAG_RESET)
+            , stageFlag(0)
+        {}
+
+        String encode(const String & json);
+        // the last encoded frame was sent
+        void commit()   { encCount = encStage; txFlag &= ~stageFlag; }
+        bool decode(const String & src, String & json);
+        bool needSync() { return txFlag & BLINKER_TLV_FLAG_RESET_REQ; }
+
+    private :
+        uint32_t    encHash[BLINKER_TLV_DICT_SIZE];
+        char        encKey[BLINKER_TLV_DICT_SIZE][BLINKER_TLV_KEY_SIZE];
+        char        decKey[BLINKER_TLV_DICT_SIZE][BLINKER_TLV_KEY_SIZE];
+        uint8_t     encCount;
+        uint8_t     encStage;
+        uint8_t     decCount;
+        uint8_t     txFlag;
+        // flags the staged frame carries
+        uint8_t     stageFlag;
+
+        uint8_t *   buf;
+        uint16_t    bufLen;
+        uint16_t    bufSize;
+
+        bool put(uint8_t c);
+        bool putVarint(uint32_t data);
+        bool putBytes(const char * data, uint16_t len);
+        bool putKey(const char * key);
+        bool getVarint(uint16_t & pos, uint32_t & data);
+        uint8_t crc8(const uint8_t * data, uint16_t len);
+};
+
+String BlinkerTLV::encode(const String & json)
+{
+    BlinkerJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+
+    String frame = BLINKER_F("");
+
+    if (!root.success()) return frame;
+
+    bufSize = json.length() + 8;
+    bufLen = 0;
+    buf = (uint8_t*)BLINKER_MALLOC(HEAP_MSG, bufSize*sizeof(uint8_t));
+
+    if (buf == NULL)
+    {
+        BLINKER_ERR_LOG(BLINKER_F("TLV encode failed, no memory"));
+        return frame;
+    }
+
+    put(txFlag);
+    stageFlag = txFlag;
+
+    // new keys go after the committed ones, or from 0 on a reset
+    encStage = (txFlag & BLINKER_TLV_FLAG_RESET) ? 0 : encCount;
+
+    bool state = true;
+
+    for (JsonObject::iterator it = root.begin(); it != root.end() && state; ++it)
+    {
+        uint16_t tagPos = bufLen;
+
+        state = put(0) && putKey(it->key);
+
+        if (!state) break;
+
+        uint8_t type;
+
+        if (it->value.is<bool>())
+        {
+            type = it->value.as<bool>() ? BLINKER_TLV_TYPE_TRUE : BLINKER_TLV_TYPE_FALSE;
+        }
+        else if (it->value.is<long>())
+        {
+            int32_t data = it->value.as<long>();
+
+            type = BLINKER_TLV_TYPE_INT;
+            state = putVarint(((uint32_t)data << 1) ^ (uint32_t)(data >> 31));
+        }
+        else if (it->value.is<float>())
+        {
+            float data = it->value.as<float>();
+
+            // as many decimals as the json had, float can not hold more than 9
+            String text;
+            it->value.printTo(text);
+
+            int dot = text.indexOf('.');
+            uint8_t decimals = 0;
+
+            if (text.indexOf('e') != -1) decimals = 9;
+            else if (dot != -1) decimals = BlinkerMin((int)text.length() - dot - 1, 9);
+
+            type = BLINKER_TLV_TYPE_FLOAT;
+            state = putBytes((const char *)&data, sizeof(float)) && put(decimals);
+        }
+        else if (it->value.is<const char*>())
+        {
+            const char * data = it->value.as<const char*>();
+
+            type = BLINKER_TLV_TYPE_STRING;
+            state = putVarint(strlen(data)) && putBytes(data, strlen(data));
+        }
+        else
+        {
+            String data;
+            it->value.printTo(data);
+
+            type = BLINKER_TLV_TYPE_JSON;
+
+            if (it->value.is<JsonArray>())
+            {
+                JsonArray& array = it->value.as<JsonArray>();
+
+                type = BLINKER_TLV_TYPE_BYTES;
+
+                for (JsonArray::iterator a_it = array.begin(); a_it != array.end(); ++a_it)
+                {
+                    if (!a_it->is<long>() || a_it->as<long>() < 0 || a_it->as<long>() > 255)
+                    {
+                        type = BLINKER_TLV_TYPE_JSON;
+                        break;
+                    }
+                }
+
+                if (type == BLINKER_TLV_TYPE_BYTES)
+                {
+                    state = putVarint(array.size());
+
+                    for (JsonArray::iterator a_it = array.begin(); a_it != array.end() && state; ++a_it)
+                    {
+                        state = put(a_it->as<long>());
+                    }
+                }
+            }
+
+            if (type == BLINKER_TLV_TYPE_JSON)
+            {
+                state = putVarint(data.length()) && putBytes(data.c_str(), data.length());
+            }
+        }
+
+        buf[tagPos] |= type << 5;
+    }
+
+    if (state && put(crc8(buf, bufLen)))
+    {
+        frame.reserve(bufLen + 8);
+
+        for (uint16_t num = 0; num < bufLen; num++)
+        {
+            switch (buf[num])
+            {
+                case 0x00 : frame += (char)BLINKER_TLV_ESCAPE; frame += (char)0xDC; break;
+                case '\n' : frame += (char)BLINKER_TLV_ESCAPE; frame += (char)0xDD; break;
+                case '\r' : frame += (char)BLINKER_TLV_ESCAPE; frame += (char)0xDE; break;
+                case BLINKER_TLV_ESCAPE :
+                            frame += (char)BLINKER_TLV_ESCAPE; frame += (char)0xDF; break;
+                default :   frame += (char)buf[num]; break;
+            }
+        }
+    }
+    else
+    {
+        BLINKER_ERR_LOG_ALL(BLINKER_F("TLV encode failed: "), json);
+    }
+
+    BLINKER_FREE(buf);
+
+    return frame;
+}
+
+bool BlinkerTLV::decode(const String & src, String & json)
+{
+    bufSize = src.length();
+    bufLen = 0;
+    buf = (uint8_t*)BLINKER_MALLOC(HEAP_MSG, (bufSize + 1)*sizeof(uint8_t));
+
+    if (buf == NULL)
+    {
+        BLINKER_ERR_LOG(BLINKER_F("TLV decode failed, no memory"));
+        return false;
+    }
+
+    for (uint16_t num = 0; num < src.length(); num++)
+    {
+        uint8_t c = src[num];
+
+        if (c == BLINKER_TLV_ESCAPE && num + 1 < src.length())
+        {
+            switch ((uint8_t)src[++num])
+            {
+                case 0xDC : c = 0x00; break;
+                case 0xDD : c = '\n'; break;
+                case 0xDE : c = '\r'; break;
+                default :   c = BLINKER_TLV_ESCAPE; break;
+            }
+        }
+
+        buf[bufLen++] = c;
+    }
+
+    bool state = bufLen >= 2 && crc8(buf, bufLen - 1) == buf[bufLen - 1];
+
+    if (state)
+    {
+        uint8_t flag = buf[0];
+
+        if (flag & BLINKER_TLV_FLAG_RESET) decCount = 0;
+
+        if (flag & BLINKER_TLV_FLAG_RESET_REQ)
+        {
+            encCount = 0;
+            txFlag |= BLINKER_TLV_FLAG_RESET;
+        }
+
+        json = BLINKER_F("{");
+
+        uint16_t pos = 1;
+        uint16_t end = bufLen - 1;
+
+        while (pos < end && state)
+        {
+            uint8_t type = buf[pos] >> 5;
+            uint8_t id = buf[pos] & 0x1F;
+            uint32_t len;
+            pos++;
+
+            if (json.length() > 1) json += BLINKER_F(",");
+            json += BLINKER_F("\"");
+
+            if (id == BLINKER_TLV_ID_DEFINE || id == BLINKER_TLV_ID_LITERAL)
+            {
+                state = pos < end && (pos + buf[pos] + 1) <= end;
+
+                if (!state) break;
+
+                len = buf[pos++];
+
+                if (id == BLINKER_TLV_ID_DEFINE)
+                {
+                    if (decCount >= BLINKER_TLV_DICT_SIZE || len >= BLINKER_TLV_KEY_SIZE)
+                    {
+                        state = false;
+                        break;
+                    }
+
+                    memcpy(decKey[decCount], buf + pos, len);
+                    decKey[decCount][len] = '\0';
+                    decCount++;
+                }
+
+                for (uint32_t num = 0; num < len; num++) json += (char)buf[pos + num];
+
+                pos += len;
+            }
+            else if (id <= decCount)
+            {
+                json += decKey[id - 1];
+            }
+            else
+            {
+                state = false;
+                break;
+            }
+
+            json += BLINKER_F("\":");
+
+            switch (type)
+            {
+                case BLINKER_TLV_TYPE_TRUE :
+                    json += BLINKER_F("true");
+                    break;
+                case BLINKER_TLV_TYPE_FALSE :
+                    json += BLINKER_F("false");
+                    break;
+                case BLINKER_TLV_TYPE_INT :
+                    state = getVarint(pos, len);
+                    json += STRING_format((int32_t)((len >> 1) ^ (~(len & 1) + 1)));
+                    break;
+                case BLINKER_TLV_TYPE_FLOAT :
+                    {
+                        float data;
+
+                        state = (pos + sizeof(float) + 1) <= end;
+
+                        if (!state) break;
+
+                        memcpy(&data, buf + pos, sizeof(float));
+                        pos += sizeof(float);
+                        json += String(data, BlinkerMin(buf[pos++], (uint8_t)9));
+                    }
+                    break;
+                case BLINKER_TLV_TYPE_BYTES :
+                    state = getVarint(pos, len) && (pos + len) <= end;
+
+                    if (!state) break;
+
+                    json += BLINKER_F("[");
+                    for (uint32_t num = 0; num < len; num++)
+                    {
+                        if (num) json += BLINKER_F(",");
+                        json += STRING_format(buf[pos + num]);
+                    }
+                    json += BLINKER_F("]");
+                    pos += len;
+                    break;
+                case BLINKER_TLV_TYPE_STRING :
+                case BLINKER_TLV_TYPE_JSON :
+                    state = getVarint(pos, len) && (pos + len) <= end;
+
+                    if (!state) break;
+
+                    if (type == BLINKER_TLV_TYPE_STRING) json += BLINKER_F("\"");
+                    for (uint32_t num = 0; num < len; num++)
+                    {
+                        if (type == BLINKER_TLV_TYPE_STRING && \
+                            (buf[pos + num] == '"' || buf[pos + num] == '\\'))
+                        {
+                            json += BLINKER_F("\\");
+                        }
+                        json += (char)buf[pos + num];
+                    }
+                    if (type == BLINKER_TLV_TYPE_STRING) json += BLINKER_F("\"");
+                    pos += len;
+                    break;
+                default :
+                    json += BLINKER_F("null");
+                    break;
+            }
+        }
+
+        json += BLINKER_F("}");
+    }
+
+    BLINKER_FREE(buf);
+
+    if (!state)
+    {
+        BLINKER_ERR_LOG_ALL(BLINKER_F("TLV decode failed, request sync"));
+
+        txFlag |= BLINKER_TLV_FLAG_RESET_REQ;
+    }
+
+    return state;
+}
+
+bool BlinkerTLV::put(uint8_t c)
+{
+    if (bufLen >= bufSize)
+    {
+        uint8_t * grown = (uint8_t*)BLINKER_REALLOC(HEAP_MSG, buf, (bufSize + 16)*sizeof(uint8_t));
+
+        if (grown == NULL)
+        {
+            BLINKER_ERR_LOG(BLINKER_F("TLV encode failed, no memory"));
+            return false;
+        }
+
+        buf = grown;
+        bufSize += 16;
+    }
+
+    buf[bufLen++] = c;
+
+    return true;
+}
+
+bool BlinkerTLV::putVarint(uint32_t data)
+{
+    while (data >= 0x80)
+    {
+        if (!put((data & 0x7F) | 0x80)) return false;
+        data >>= 7;
+    }
+
+    return put(data);
+}
+
+bool BlinkerTLV::putBytes(const char * data, uint16_t len)
+{
+    for (uint16_t num = 0; num < len; num++)
+    {
+        if (!put(data[num])) return false;
+    }
+
+    return true;
+}
+
+bool BlinkerTLV::putKey(const char * key)
+{
+    if (strlen(key) > 0xFF) return false;
+
+    uint8_t len = strlen(key);
+    uint32_t _hash = STRING_hash(key);
+    uint16_t tagPos = bufLen - 1;
+
+    for (uint8_t num = 0; num < encStage; num++)
+    {
+        if (encHash[num] == _hash && strcmp(encKey[num], key) == 0)
+        {
+            buf[tagPos] = num + 1;
+            return true;
+        }
+    }
+
+    if (encStage < BLINKER_TLV_DICT_SIZE && len < BLINKER_TLV_KEY_SIZE)
+    {
+        encHash[encStage] = _hash;
+        memcpy(encKey[encStage], key, len + 1);
+        encStage++;
+        buf[tagPos] = BLINKER_TLV_ID_DEFINE;
+    }
+    else
+    {
+        buf[tagPos] = BLINKER_TLV_ID_LITERAL;
+    }
+
+    return put(len) && putBytes(key, len);
+}
+
+bool BlinkerTLV::getVarint(uint16_t & pos, uint32_t & data)
+{
+    data = 0;
+
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (pos >= bufLen - 1) return false;
+
+        uint8_t c = buf[pos++];
+
+        data |= (uint32_t)(c & 0x7F) << shift;
+
+        if (!(c & 0x80)) return true;
+    }
+
+    return false;
+}
+
+uint8_t BlinkerTLV::crc8(const uint8_t * data, uint16_t len)
+{
+    uint8_t crc = 0;
+
+    while (len--)
+    {
+        crc ^= *data++;
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef BLINKER_TOKEN_H
+#define BLINKER_TOKEN_H
+
+#if !defined(BLINKER_ARDUINOJSON)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+#include "Blinker/BlinkerUtility.h"
+
+enum b_token_type_t {
+    BLINKER_TOKEN_NONE,
+    BLINKER_TOKEN_STRING,
+    BLINKER_TOKEN_PRIMITIVE,
+    BLINKER_TOKEN_OBJECT,
+    BLINKER_TOKEN_ARRAY
+};
+
+typedef struct
+{
+    uint16_t    key;
+    uint16_t    value;
+    uint16_t    valueLen;
+    uint8_t     keyLen;
+    uint8_t     type;
+} b_token_t;
+
+// one pass over a message for builds without ArduinoJson, every
+// "key":value pair at any depth goes in a fixed table of spans into the
+// message, so widget lookups neither rescan the text nor touch the heap
+// the message must outlive the table, keys past a full table are looked
+// up with the old STRING_find_* scan instead
+class BlinkerToken
+{
+    public :
+        BlinkerToken(const char * data);
+
+        uint8_t size() const    { return count; }
+        bool contains(const char * key) const;
+        bool equal(const char * key, const char * value) const;
+        bool value(const char * key, String & dst) const;
+        int32_t number(const char * key) const;
+        int32_t arrayNumber(const char * key, uint8_t num) const;
+        float arrayFloat(const char * key, uint8_t num) const;
+
+    private :
+        const char *    src;
+        b_token_t       token[BLINKER_MAX_TOKEN_SIZE];
+        uint8_t         count;
+        bool            full;
+
+        int8_t find(const char * key) const;
+        const char * element(const char * key, uint8_t num) const;
+};
+
+BlinkerToken::BlinkerToken(const char * data)
+    : src(data)
+    , count(0)
+    , full(false)
+{
+    int8_t  open[BLINKER_TOKEN_DEPTH];
+    uint8_t object = 0;
+    uint8_t depth = 0;
+    int8_t  cur = BLINKER_OBJECT_NOT_AVAIL;
+    int8_t  pend = BLINKER_OBJECT_NOT_AVAIL;
+    bool    isKey = false;
+    bool    isValue = false;
+
+    for (uint16_t pos = 0; data[pos]; pos++)
+    {
+        char c = data[pos];
+
+        if (c == '"')
+        {
+            uint16_t start = pos + 1;
+
+            for (pos++; data[pos] && data[pos] != '"'; pos++)
+            {
+                if (data[pos] == '\\' && data[pos + 1]) pos++;
+            }
+
+            if (!data[pos]) return;
+
+            if (isKey)
+            {
+                cur = BLINKER_OBJECT_NOT_AVAIL;
+
+                if (count < BLINKER_MAX_TOKEN_SIZE)
+                {
+                    cur = count++;
+                    token[cur].key = start;
+                    token[cur].keyLen = pos - start;
+                    token[cur].valueLen = 0;
+                    token[cur].type = BLINKER_TOKEN_NONE;
+                }
+                else if (!full)
+                {
+                    BLINKER_ERR_LOG(BLINKER_F("token table full, raise BLINKER_MAX_TOKEN_SIZE"));
+                    full = true;
+                }
+
+                isKey = false;
+            }
+            else if (isValue)
+            {
+                if (cur != BLINKER_OBJECT_NOT_AVAIL)
+                {
+                    token[cur].value = start;
+                    token[cur].valueLen = pos - start;
+                    token[cur].type = BLINKER_TOKEN_STRING;
+                }
+
+                isValue = false;
+            }
+        }
+        else if (c == ':')
+        {
+            isValue = true;
+        }
+        else if (c == '{' || c == '[')
+        {
+            depth++;
+
+            if (depth < BLINKER_TOKEN_DEPTH)
+            {
+                open[depth] = isValue ? cur : BLINKER_OBJECT_NOT_AVAIL;
+
+                if (c == '{') object |= (1 << depth);
+                else object &= ~(1 << depth);
+            }
+
+            if (isValue && cur != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                token[cur].value = pos;
+                token[cur].type = c == '{' ? BLINKER_TOKEN_OBJECT : BLINKER_TOKEN_ARRAY;
+            }
+
+            isValue = false;
+            isKey = c == '{';
+        }
+        else if (c == ',' || c == '}' || c == ']')
+        {
+            // a number, bool or null ends at the next delimiter
+            if (pend != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                uint16_t end = pos;
+
+                while (end > token[pend].value && data[end - 1] == ' ') end--;
+
+                token[pend].valueLen = end - token[pend].value;
+                pend = BLINKER_OBJECT_NOT_AVAIL;
+            }
+
+            if (c == ',')
+            {
+                isKey = depth < BLINKER_TOKEN_DEPTH && (object & (1 << depth));
+            }
+            else if (depth)
+            {
+                if (depth < BLINKER_TOKEN_DEPTH && open[depth] != BLINKER_OBJECT_NOT_AVAIL)
+                {
+                    token[open[depth]].valueLen = pos + 1 - token[open[depth]].value;
+                }
+
+                depth--;
+                isKey = false;
+            }
+        }
+        else if (isValue && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+        {
+            if (cur != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                token[cur].value = pos;
+                token[cur].type = BLINKER_TOKEN_PRIMITIVE;
+                pend = cur;
+            }
+
+            isValue = false;
+        }
+    }
+}
+
+int8_t BlinkerToken::find(const char * key) const
+{
+    size_t keyLen = strlen(key);
+
+    for (uint8_t num = 0; num < count; num++)
+    {
+        if (token[num].keyLen == keyLen && \
+            token[num].type != BLINKER_TOKEN_NONE && \
+            strncmp(src + token[num].key, key, keyLen) == 0)
+        {
+            return num;
+        }
+    }
+
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+bool BlinkerToken::contains(const char * key) const
+{
+    if (find(key) != BLINKER_OBJECT_NOT_AVAIL) return true;
+
+    return full && STRING_contains_string(src, key);
+}
+
+bool BlinkerToken::equal(const char * key, const char * value) const
+{
+    int8_t num = find(key);
+
+    if (num == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        String dst;
+
+        return full && STRING_find_string_value(src, dst, key) && dst == value;
+    }
+
+    return strlen(value) == token[num].valueLen && \
+            strncmp(src + token[num].value, value, token[num].valueLen) == 0;
+}
+
+bool BlinkerToken::value(const char * key, String & dst) const
+{
+    int8_t num = find(key);
+
+    if (num == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        return full && STRING_find_string_value(src, dst, key);
+    }
+
+    dst = "";
+    dst.reserve(token[num].valueLen);
+
+    for (uint16_t pos = 0; pos < token[num].valueLen; pos++)
+    {
+        dst += src[token[num].value + pos];
+    }
+
+    return true;
+}
+
+int32_t BlinkerToken::number(const char * key) const
+{
+    int8_t num = find(key);
+
+    if (num == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        return full ? STRING_find_numberic_value(src, key) : FIND_KEY_VALUE_FAILED;
+    }
+
+    // "12" reads as 12, atol stops at the closing quote
+    if (token[num].type != BLINKER_TOKEN_PRIMITIVE && \
+        token[num].type != BLINKER_TOKEN_STRING)
+    {
+        return FIND_KEY_VALUE_FAILED;
+    }
+
+    return atol(src + token[num].value);
+}
+
+int32_t BlinkerToken::arrayNumber(const char * key, uint8_t num) const
+{
+    const char * item = element(key, num);
+
+    if (!item && full && find(key) == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        return STRING_find_array_numberic_value(src, key, num);
+    }
+
+    if (!item) return FIND_KEY_VALUE_FAILED;
+
+    return atol(item);
+}
+
+float BlinkerToken::arrayFloat(const char * key, uint8_t num) const
+{
+    const char * item = element(key, num);
+
+    if (!item && full && find(key) == BLINKER_OBJECT_NOT_AVAIL)
+    {
+        return STRING_find_array_float_value(src, key, num);
+    }
+
+    if (!item) return (float)FIND_KEY_VALUE_FAILED;
+
+    return atof(item);
+}
+
+// start of the num-th item of an array value, quotes skipped
+const char * BlinkerToken::element(const char * key, uint8_t num) const
+{
+    int8_t idx = find(key);
+
+    if (idx == BLINKER_OBJECT_NOT_AVAIL || \
+        token[idx].type != BLINKER_TOKEN_ARRAY)
+    {
+        return NULL;
+    }
+
+    const char * pos = src + token[idx].value + 1;
+    const char * end = src + token[idx].value + token[idx].valueLen - 1;
+    uint8_t depth = 0;
+
+    while (num && pos < end)
+    {
+        if (*pos == '"')
+        {
+            for (pos++; pos < end && *pos != '"'; pos++)
+            {
+                if (*pos == '\\') pos++;
+            }
+        }
+        else if (*pos == '{' || *pos == '[') depth++;
+        else if (*pos == '}' || *pos == ']') depth--;
+        else if (*pos == ',' && depth == 0) num--;
+
+        pos++;
+    }
+
+    while (pos < end && (*pos == ' ' || *pos == '"')) pos++;
+
+    if (pos >= end) return NULL;
+
+    return pos;
+}
+
+#endif
+
+#endif
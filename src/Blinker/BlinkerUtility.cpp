@@ -262,4 +262,63 @@ String STRING_find_array_string_value(const String & src, const String & key, ui
         String value = src.substring(addr_start, addr_end);
         return value;
     }
-}
\ No newline at end of file
+}
+
+uint32_t STRING_hash(const char * src, uint32_t seed)
+{
+    // FNV-1a, pass a previous hash as seed to chain strings
+    uint32_t hash = seed;
+
+    while (*src) {
+        hash ^= (uint8_t)(*src++);
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+String STRING_frame_encode(uint8_t id, const String & data, uint8_t magic)
+{
+    // magic | 0x80 + node id | 7 bit length lo | 7 bit length hi,
+    // no 0x00 or line break in header
+    uint16_t len = data.length();
+
+    String frame;
+
+    if (data.length() > BLINKER_FRAME_MAX_LEN) return frame;
+
+    frame.reserve(len + BLINKER_FRAME_HEAD_SIZE);
+    frame += (char)magic;
+    frame += (char)(0x80 | (id & 0x7F));
+    frame += (char)(0x80 | (len & 0x7F));
+    frame += (char)(0x80 | ((len >> 7) & 0x7F));
+    frame += data;
+
+    return frame;
+}
+
+int8_t STRING_frame_decode(const String & src, uint8_t & id, String & dst)
+{
+    uint8_t magic = src.length() ? (uint8_t)src[0] : 0;
+
+    if (magic != BLINKER_FRAME_MAGIC && magic != BLINKER_FRAME_MAGIC_TLV) {
+        id = 0;
+        dst = src;
+        return BLINKER_FRAME_RAW;
+    }
+
+    if (src.length() < BLINKER_FRAME_HEAD_SIZE) {
+        return BLINKER_FRAME_ERROR;
+    }
+
+    uint16_t len = ((uint8_t)src[2] & 0x7F) | (((uint16_t)src[3] & 0x7F) << 7);
+
+    if (src.length() < len + BLINKER_FRAME_HEAD_SIZE) {
+        return BLINKER_FRAME_ERROR;
+    }
+
+    id = (uint8_t)src[1] & 0x7F;
+    dst = src.substring(BLINKER_FRAME_HEAD_SIZE, BLINKER_FRAME_HEAD_SIZE + len);
+
+    return magic == BLINKER_FRAME_MAGIC_TLV ? BLINKER_FRAME_TLV : BLINKER_FRAME_JSON;
+}
@@ -21,9 +21,20 @@
 
 #define FIND_KEY_VALUE_FAILED               -1000
 
+#define BLINKER_FRAME_MAGIC                 0xB1
+#define BLINKER_FRAME_MAGIC_TLV             0xB2
+#define BLINKER_FRAME_HEAD_SIZE             4
+#define BLINKER_FRAME_BROADCAST             0x7F
+#define BLINKER_FRAME_MAX_LEN               0x3FFF
+#define BLINKER_FRAME_ERROR                 -1
+#define BLINKER_FRAME_RAW                   0
+#define BLINKER_FRAME_JSON                  1
+#define BLINKER_FRAME_TLV                   2
+
 #if defined(BLINKER_ARDUINOJSON) || defined(BLINKER_PRO) || \
     defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
     #include "modules/ArduinoJson/ArduinoJson.h"
+    #include "Blinker/BlinkerJson.h"
 #endif
 
 extern "C" {
@@ -61,19 +72,178 @@ extern "C" {
     defined(BLINKER_NBIOT_SIM7020) || defined(BLINKER_GPRS_AIR202) || \
     defined(BLINKER_PRO_SIM7020) || defined(BLINKER_PRO_AIR202) || \
     defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
-class BlinkerSharer
+#include "Blinker/BlinkerConfig.h"
+
+// sharer uuids are 32 hex digits, kept as 16 bytes each in one block and
+// found through a small open addressed index, a refresh keeps the slots
+// of sharers still listed so only the changes touch the table
+class BlinkerSharers
 {
     public :
-        BlinkerSharer(const String & _uuid)
+        BlinkerSharers()
+            : used(0)
+            , seen(0)
+            , upper(0)
+            , num(0)
         {
-            name = (char*)malloc((_uuid.length()+1)*sizeof(char));
-            strcpy(name, _uuid.c_str());
+            for (uint8_t pos = 0; pos < BLINKER_SHARER_INDEX_SIZE; pos++)
+            {
+                index[pos] = BLINKER_SHARER_EMPTY;
+            }
+        }
+
+        uint8_t count() { return num; }
+
+        int8_t find(const char * _uuid)
+        {
+            uint8_t bin[16];
+            bool isUpper;
+
+            if (!decode(_uuid, bin, isUpper)) return BLINKER_OBJECT_NOT_AVAIL;
+
+            uint8_t pos = hash(bin);
+
+            while (index[pos] != BLINKER_SHARER_EMPTY)
+            {
+                if (memcmp(id[index[pos]], bin, 16) == 0) return index[pos];
+
+                pos = (pos + 1) & (BLINKER_SHARER_INDEX_SIZE - 1);
+            }
+
+            return BLINKER_OBJECT_NOT_AVAIL;
         }
 
-        char * uuid() { return name; }
+        // hex text of a slot, valid until the next call
+        const char * uuid(uint8_t slot)
+        {
+            const char * digit = (upper & (1 << slot)) ? \
+                                "0123456789ABCDEF" : "0123456789abcdef";
+
+            for (uint8_t pos = 0; pos < 16; pos++)
+            {
+                text[pos * 2] = digit[id[slot][pos] >> 4];
+                text[pos * 2 + 1] = digit[id[slot][pos] & 0x0F];
+            }
+            text[32] = '\0';
+
+            return text;
+        }
+
+        // a refresh is mark(), add() for every listed uuid, then sweep()
+        void mark() { seen = 0; }
+
+        int8_t add(const char * _uuid)
+        {
+            int8_t slot = find(_uuid);
+
+            if (slot != BLINKER_OBJECT_NOT_AVAIL)
+            {
+                seen |= 1 << slot;
+                return slot;
+            }
+
+            uint8_t bin[16];
+            bool isUpper;
+
+            if (!decode(_uuid, bin, isUpper)) return BLINKER_OBJECT_NOT_AVAIL;
+
+            for (slot = 0; slot < BLINKER_MQTT_MAX_SHARERS_NUM; slot++)
+            {
+                if (!(used & (1 << slot))) break;
+            }
+
+            if (slot == BLINKER_MQTT_MAX_SHARERS_NUM) return BLINKER_OBJECT_NOT_AVAIL;
+
+            memcpy(id[slot], bin, 16);
+            used |= 1 << slot;
+            seen |= 1 << slot;
+            if (isUpper) upper |= 1 << slot;
+            else upper &= ~(1 << slot);
+            num++;
+
+            uint8_t pos = hash(bin);
+
+            while (index[pos] != BLINKER_SHARER_EMPTY)
+            {
+                pos = (pos + 1) & (BLINKER_SHARER_INDEX_SIZE - 1);
+            }
+
+            index[pos] = slot;
+
+            return slot;
+        }
+
+        void sweep()
+        {
+            if (used == seen) return;
+
+            used = seen;
+            num = 0;
+
+            for (uint8_t pos = 0; pos < BLINKER_SHARER_INDEX_SIZE; pos++)
+            {
+                index[pos] = BLINKER_SHARER_EMPTY;
+            }
+
+            for (uint8_t slot = 0; slot < BLINKER_MQTT_MAX_SHARERS_NUM; slot++)
+            {
+                if (!(used & (1 << slot))) continue;
+
+                uint8_t pos = hash(id[slot]);
+
+                while (index[pos] != BLINKER_SHARER_EMPTY)
+                {
+                    pos = (pos + 1) & (BLINKER_SHARER_INDEX_SIZE - 1);
+                }
+
+                index[pos] = slot;
+                num++;
+            }
+        }
 
     private :
-        char * name;
+        uint8_t     id[BLINKER_MQTT_MAX_SHARERS_NUM][16];
+        uint8_t     index[BLINKER_SHARER_INDEX_SIZE];
+        uint16_t    used;
+        uint16_t    seen;
+        uint16_t    upper;
+        uint8_t     num;
+        char        text[BLINKER_MQTT_USER_UUID_SIZE + 1];
+
+        uint8_t hash(const uint8_t * bin)
+        {
+            uint32_t _hash = 2166136261UL;
+
+            for (uint8_t pos = 0; pos < 16; pos++)
+            {
+                _hash = (_hash ^ bin[pos]) * 16777619UL;
+            }
+
+            return _hash & (BLINKER_SHARER_INDEX_SIZE - 1);
+        }
+
+        // exactly 32 hex digits, all in one case so the text round trips
+        bool decode(const char * _uuid, uint8_t * bin, bool & isUpper)
+        {
+            bool lower = false;
+            isUpper = false;
+
+            for (uint8_t pos = 0; pos < BLINKER_MQTT_USER_UUID_SIZE; pos++)
+            {
+                char c = _uuid[pos];
+                uint8_t nibble;
+
+                if (c >= '0' && c <= '9') nibble = c - '0';
+                else if (c >= 'a' && c <= 'f') { nibble = c - 'a' + 10; lower = true; }
+                else if (c >= 'A' && c <= 'F') { nibble = c - 'A' + 10; isUpper = true; }
+                else return false;
+
+                if (pos & 1) bin[pos / 2] |= nibble;
+                else bin[pos / 2] = nibble << 4;
+            }
+
+            return _uuid[BLINKER_MQTT_USER_UUID_SIZE] == '\0' && !(lower && isUpper);
+        }
 };
 #endif
 
@@ -108,4 +278,11 @@ float STRING_find_array_float_value(const String & src, const String & key, uint
 
 String STRING_find_array_string_value(const String & src, const String & key, uint8_t num);
 
+uint32_t STRING_hash(const char * src, uint32_t seed = 2166136261UL);
+
+// empty when data is longer than BLINKER_FRAME_MAX_LEN
+String STRING_frame_encode(uint8_t id, const String & data, uint8_t magic = BLINKER_FRAME_MAGIC);
+
+int8_t STRING_frame_decode(const String & src, uint8_t & id, String & dst);
+
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
 
 class BLINKERALIGENIE
 {
@@ -78,10 +79,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 0 & 0x01) {
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
-            aState = (char*)malloc((payload.length()+1)*sizeof(char));
+            aState = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aState, payload.c_str());
 
             _fresh |= 0x01 << 0;
@@ -98,10 +99,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 0 & 0x01) {
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
-            aState = (char*)malloc((payload.length()+1)*sizeof(char));
+            aState = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aState, payload.c_str());
 
             _fresh |= 0x01 << 0;
@@ -123,10 +124,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 1 & 0x01) {
-                free(aColor);
+                BLINKER_FREE(aColor);
             }
 
-            aColor = (char*)malloc((payload.length()+1)*sizeof(char));
+            aColor = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aColor, payload.c_str());
 
             _fresh |= 0x01 << 1;
@@ -143,10 +144,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 2 & 0x01) {
-                free(aMode);
+                BLINKER_FREE(aMode);
             }
 
-            aMode = (char*)malloc((payload.length()+1)*sizeof(char));
+            aMode = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aMode, payload.c_str());
 
             _fresh |= 0x01 << 2;
@@ -163,10 +164,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 3 & 0x01) {
-                free(aCtemp);
+                BLINKER_FREE(aCtemp);
             }
 
-            aCtemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aCtemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aCtemp, payload.c_str());
 
             _fresh |= 0x01 << 3;
@@ -183,10 +184,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 4 & 0x01) {
-                free(aBright);
+                BLINKER_FREE(aBright);
             }
 
-            aBright = (char*)malloc((payload.length()+1)*sizeof(char));
+            aBright = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aBright, payload.c_str());
 
             _fresh |= 0x01 << 4;
@@ -203,10 +204,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -223,10 +224,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -243,10 +244,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -263,10 +264,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -283,10 +284,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -303,10 +304,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -323,10 +324,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -343,10 +344,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -363,10 +364,10 @@ class BLINKERALIGENIE
             // Blinker.aligeniePrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -384,7 +385,7 @@ class BLINKERALIGENIE
                 
                 aliData += aState;
                 
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
             if (_fresh >> 1 & 0x01) {
@@ -393,7 +394,7 @@ class BLINKERALIGENIE
                 
                 aliData += aColor;
                 
-                free(aColor);
+                BLINKER_FREE(aColor);
             }
 
             if (_fresh >> 2 & 0x01) {
@@ -402,7 +403,7 @@ class BLINKERALIGENIE
                 
                 aliData += aMode;
                 
-                free(aMode);
+                BLINKER_FREE(aMode);
             }
 
             if (_fresh >> 3 & 0x01) {
@@ -411,7 +412,7 @@ class BLINKERALIGENIE
                 
                 aliData += aCtemp;
                 
-                free(aCtemp);
+                BLINKER_FREE(aCtemp);
             }
 
             if (_fresh >> 4 & 0x01) {
@@ -420,7 +421,7 @@ class BLINKERALIGENIE
                 
                 aliData += aBright;
                 
-                free(aBright);
+                BLINKER_FREE(aBright);
             }
 
             if (_fresh >> 5 & 0x01) {
@@ -429,7 +430,7 @@ class BLINKERALIGENIE
                 
                 aliData += aTemp;
                 
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
             if (_fresh >> 6 & 0x01) {
@@ -438,7 +439,7 @@ class BLINKERALIGENIE
                 
                 aliData += aHumi;
                 
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
             if (_fresh >> 7 & 0x01) {
@@ -447,7 +448,7 @@ class BLINKERALIGENIE
                 
                 aliData += aPm25;
                 
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
             aliData += BLINKER_F("}");
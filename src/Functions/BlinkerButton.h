@@ -3,6 +3,7 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerShadow.h"
 
 class BlinkerButton
 {
@@ -19,89 +20,34 @@ class BlinkerButton
             Blinker.freshAttachWidget(Blinker.widgetName_str(wNum), _func);
         }
 
-        void icon(const String & _icon)
-        {
-            if (_fresh >> 0 & 0x01) free(bicon);
-
-            bicon = (char*)malloc((_icon.length()+1)*sizeof(char));
-            strcpy(bicon, _icon.c_str());
-
-            _fresh |= 0x01 << 0;
-        }
+        bool icon(const String & _icon) { return _shadow.stage(0, _icon); }
 
-        void color(const String & _clr)
-        {
-            if (_fresh >> 1 & 0x01) free(iconClr);
-
-            iconClr = (char*)malloc((_clr.length()+1)*sizeof(char));
-            strcpy(iconClr, _clr.c_str());
-
-            _fresh |= 0x01 << 1;
-        }
+        bool color(const String & _clr) { return _shadow.stage(1, _clr); }
 
         template <typename T>
-        void content(T _con)
-        {
-            if (_fresh >> 2 & 0x01) free(bcon);
-
-            String _bcon = STRING_format(_con);
-            bcon = (char*)malloc((_bcon.length()+1)*sizeof(char));
-            strcpy(bcon, _bcon.c_str());
-
-            _fresh |= 0x01 << 2;
-        }
+        bool content(T _con) { return _shadow.stage(2, STRING_format(_con)); }
 
         template <typename T>
-        void text(T _text)
-        {
-            if (_fresh >> 3 & 0x01) free(btext);
-
-            String _btext = STRING_format(_text);
-            btext = (char*)malloc((_btext.length()+1)*sizeof(char));
-            strcpy(btext, _btext.c_str());
-
-            _fresh |= 0x01 << 3;
-        }
+        bool text(T _text) { return _shadow.stage(3, STRING_format(_text)); }
 
         template <typename T1, typename T2>
-        void text(T1 _text1, T2 _text2)
+        bool text(T1 _text1, T2 _text2)
         {
-            if (_fresh >> 3 & 0x01) free(btext);
-
-            String _btext = STRING_format(_text1);
-            btext = (char*)malloc((_btext.length()+1)*sizeof(char));
-            strcpy(btext, _btext.c_str());
-
-            _fresh |= 0x01 << 3;
-
-            if (_fresh >> 4 & 0x01) free(btext1);
-
-            _btext = STRING_format(_text2);
-            btext1 = (char*)malloc((_btext.length()+1)*sizeof(char));
-            strcpy(btext1, _btext.c_str());
-
-            _fresh |= 0x01 << 4;
+            bool state = _shadow.stage(3, STRING_format(_text1));
+            return _shadow.stage(4, STRING_format(_text2)) && state;
         }
 
-        void textColor(const String & _clr)
-        {
-            if (_fresh >> 5 & 0x01) free(textClr);
-
-            textClr = (char*)malloc((_clr.length()+1)*sizeof(char));
-            strcpy(textClr, _clr.c_str());
-
-            _fresh |= 0x01 << 5;
-        }
+        bool textColor(const String & _clr) { return _shadow.stage(5, _clr); }
 
         void print() { print(""); }
 
         void print(const String & _state)
         {
-            if ((_fresh == 0 && _state.length() == 0) || \
-                wNum == 0)
-            {
-                return;
-            }
+            if (wNum == 0) return;
+
+            _shadow.sync(Blinker.shadowEpoch());
+
+            if (!_shadow.isDirty() && _state.length() == 0) return;
 
             String buttonData;
 
@@ -113,108 +59,24 @@ class BlinkerButton
                 buttonData += (_state);
                 buttonData += BLINKER_F("\"");
             }
-            
-            if (_fresh >> 0 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += BLINKER_F("{");
-                
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_ICON);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (bicon);
-                buttonData += BLINKER_F("\"");
-                
-                free(bicon);
-            }
-            
-            if (_fresh >> 1 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += STRING_format(BLINKER_F("{"));
-                
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_COLOR);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (iconClr);
-                buttonData += BLINKER_F("\"");
-                
-                free(iconClr);
-            }
-            
-            if (_fresh >> 2 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += BLINKER_F("{");
-                
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_CONTENT);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (bcon);
-                buttonData += BLINKER_F("\"");
-                
-                free(bcon);
-            }
-            
-            if (_fresh >> 3 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += BLINKER_F("{");
 
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_TEXT);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (btext);
-                buttonData += BLINKER_F("\"");
-                
-                free(btext);
-            }
-            
-            if (_fresh >> 4 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += BLINKER_F("{");
-                
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_TEXT1);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (btext1);
-                buttonData += BLINKER_F("\"");
-                
-                free(btext1);
-            }
-            
-            if (_fresh >> 5 & 0x01)
-            {
-                if (buttonData.length()) buttonData += BLINKER_F(",");
-                else buttonData += BLINKER_F("{");
-                
-                buttonData += BLINKER_F("\"");
-                buttonData += BLINKER_F(BLINKER_CMD_TEXTCOLOR);
-                buttonData += BLINKER_F("\":\"");
-                buttonData += (textClr);
-                buttonData += BLINKER_F("\"");
-                
-                free(textClr);
-            }
+            _shadow.emit(buttonData, 0, BLINKER_F(BLINKER_CMD_ICON));
+            _shadow.emit(buttonData, 1, BLINKER_F(BLINKER_CMD_COLOR));
+            _shadow.emit(buttonData, 2, BLINKER_F(BLINKER_CMD_CONTENT));
+            _shadow.emit(buttonData, 3, BLINKER_F(BLINKER_CMD_TEXT));
+            _shadow.emit(buttonData, 4, BLINKER_F(BLINKER_CMD_TEXT1));
+            _shadow.emit(buttonData, 5, BLINKER_F(BLINKER_CMD_TEXTCOLOR));
 
             buttonData += BLINKER_F("}");
 
-            _fresh = 0;
+            _shadow.commit();
 
             Blinker.printArray(Blinker.widgetName_str(wNum), buttonData);
         }
 
     private :
         uint8_t wNum;
-        
-        char * bicon;
-        char * iconClr;
-        char * bcon;
-        char * btext;
-        char * btext1;
-        char * textClr;
-        uint8_t _fresh = 0;
+        BlinkerShadow _shadow;
 };
 
 #endif
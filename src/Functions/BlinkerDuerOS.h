@@ -3,6 +3,7 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
 
 class BLINKERDUEROS
 {
@@ -68,10 +69,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 0 & 0x01) {
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
-            aState = (char*)malloc((payload.length()+1)*sizeof(char));
+            aState = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aState, payload.c_str());
 
             _fresh |= 0x01 << 0;
@@ -88,10 +89,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 0 & 0x01) {
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
-            aState = (char*)malloc((payload.length()+1)*sizeof(char));
+            aState = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aState, payload.c_str());
 
             _fresh |= 0x01 << 0;
@@ -113,10 +114,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 1 & 0x01) {
-                free(aColor);
+                BLINKER_FREE(aColor);
             }
 
-            aColor = (char*)malloc((payload.length()+1)*sizeof(char));
+            aColor = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aColor, payload.c_str());
 
             _fresh |= 0x01 << 1;
@@ -133,10 +134,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 2 & 0x01) {
-                free(aMode);
+                BLINKER_FREE(aMode);
             }
 
-            aMode = (char*)malloc((payload.length()+1)*sizeof(char));
+            aMode = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aMode, payload.c_str());
 
             _fresh |= 0x01 << 2;
@@ -155,10 +156,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 2 & 0x01) {
-                free(aMode);
+                BLINKER_FREE(aMode);
             }
 
-            aMode = (char*)malloc((payload.length()+1)*sizeof(char));
+            aMode = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aMode, payload.c_str());
 
             _fresh |= 0x01 << 2;
@@ -175,10 +176,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 3 & 0x01) {
-                free(aBright);
+                BLINKER_FREE(aBright);
             }
 
-            aBright = (char*)malloc((payload.length()+1)*sizeof(char));
+            aBright = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aBright, payload.c_str());
 
             _fresh |= 0x01 << 3;
@@ -197,10 +198,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 3 & 0x01) {
-                free(aBright);
+                BLINKER_FREE(aBright);
             }
 
-            aBright = (char*)malloc((payload.length()+1)*sizeof(char));
+            aBright = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aBright, payload.c_str());
 
             _fresh |= 0x01 << 3;
@@ -217,10 +218,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 4 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 4;
@@ -237,10 +238,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 4 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 4;
@@ -257,10 +258,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 4 & 0x01) {
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
-            aTemp = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTemp = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTemp, payload.c_str());
 
             _fresh |= 0x01 << 4;
@@ -277,10 +278,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -297,10 +298,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -317,10 +318,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 5 & 0x01) {
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
-            aHumi = (char*)malloc((payload.length()+1)*sizeof(char));
+            aHumi = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aHumi, payload.c_str());
 
             _fresh |= 0x01 << 5;
@@ -337,10 +338,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -357,10 +358,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -377,10 +378,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 6 & 0x01) {
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
-            aPm25 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm25 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm25, payload.c_str());
 
             _fresh |= 0x01 << 6;
@@ -397,10 +398,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm10);
+                BLINKER_FREE(aPm10);
             }
 
-            aPm10 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm10 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm10, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -417,10 +418,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm10);
+                BLINKER_FREE(aPm10);
             }
 
-            aPm10 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm10 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm10, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -437,10 +438,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 7 & 0x01) {
-                free(aPm10);
+                BLINKER_FREE(aPm10);
             }
 
-            aPm10 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aPm10 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aPm10, payload.c_str());
 
             _fresh |= 0x01 << 7;
@@ -457,10 +458,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 8 & 0x01) {
-                free(aCO2);
+                BLINKER_FREE(aCO2);
             }
 
-            aCO2 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aCO2 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aCO2, payload.c_str());
 
             _fresh |= 0x01 << 8;
@@ -477,10 +478,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 8 & 0x01) {
-                free(aCO2);
+                BLINKER_FREE(aCO2);
             }
 
-            aCO2 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aCO2 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aCO2, payload.c_str());
 
             _fresh |= 0x01 << 8;
@@ -497,10 +498,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 8 & 0x01) {
-                free(aCO2);
+                BLINKER_FREE(aCO2);
             }
 
-            aCO2 = (char*)malloc((payload.length()+1)*sizeof(char));
+            aCO2 = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aCO2, payload.c_str());
 
             _fresh |= 0x01 << 8;
@@ -517,10 +518,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 9 & 0x01) {
-                free(aAQI);
+                BLINKER_FREE(aAQI);
             }
 
-            aAQI = (char*)malloc((payload.length()+1)*sizeof(char));
+            aAQI = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aAQI, payload.c_str());
 
             _fresh |= 0x01 << 9;
@@ -536,10 +537,10 @@ class BLINKERDUEROS
             // Blinker.DuerOSPrint(payload);
 
             if (_fresh >> 10 & 0x01) {
-                free(aTIME);
+                BLINKER_FREE(aTIME);
             }
 
-            aTIME = (char*)malloc((payload.length()+1)*sizeof(char));
+            aTIME = (char*)BLINKER_MALLOC(HEAP_ATTR, (payload.length()+1)*sizeof(char));
             strcpy(aTIME, payload.c_str());
 
             _fresh |= 0x01 << 10;
@@ -557,7 +558,7 @@ class BLINKERDUEROS
                 
                 duerData += aState;
                 
-                free(aState);
+                BLINKER_FREE(aState);
             }
 
             if (_fresh >> 1 & 0x01) {
@@ -566,7 +567,7 @@ class BLINKERDUEROS
                 
                 duerData += aColor;
                 
-                free(aColor);
+                BLINKER_FREE(aColor);
             }
 
             if (_fresh >> 2 & 0x01) {
@@ -575,7 +576,7 @@ class BLINKERDUEROS
                 
                 duerData += aMode;
                 
-                free(aMode);
+                BLINKER_FREE(aMode);
             }
 
             if (_fresh >> 3 & 0x01) {
@@ -584,7 +585,7 @@ class BLINKERDUEROS
                 
                 duerData += aBright;
                 
-                free(aBright);
+                BLINKER_FREE(aBright);
             }
 
             if (_fresh >> 4 & 0x01) {
@@ -593,7 +594,7 @@ class BLINKERDUEROS
                 
                 duerData += aTemp;
                 
-                free(aTemp);
+                BLINKER_FREE(aTemp);
             }
 
             if (_fresh >> 5 & 0x01) {
@@ -602,7 +603,7 @@ class BLINKERDUEROS
                 
                 duerData += aHumi;
                 
-                free(aHumi);
+                BLINKER_FREE(aHumi);
             }
 
             if (_fresh >> 6 & 0x01) {
@@ -611,7 +612,7 @@ class BLINKERDUEROS
                 
                 duerData += aPm25;
                 
-                free(aPm25);
+                BLINKER_FREE(aPm25);
             }
 
             if (_fresh >> 7 & 0x01) {
@@ -620,7 +621,7 @@ class BLINKERDUEROS
                 
                 duerData += aPm10;
                 
-                free(aPm10);
+                BLINKER_FREE(aPm10);
             }
 
             if (_fresh >> 8 & 0x01) {
@@ -629,7 +630,7 @@ class BLINKERDUEROS
                 
                 duerData += aCO2;
                 
-                free(aCO2);
+                BLINKER_FREE(aCO2);
             }
 
             if (_fresh >> 9 & 0x01) {
@@ -638,7 +639,7 @@ class BLINKERDUEROS
                 
                 duerData += aAQI;
                 
-                free(aAQI);
+                BLINKER_FREE(aAQI);
             }
 
             if (_fresh >> 10 & 0x01) {
@@ -647,7 +648,7 @@ class BLINKERDUEROS
                 
                 duerData += aTIME;
                 
-                free(aTIME);
+                BLINKER_FREE(aTIME);
             }
 
             duerData += BLINKER_F("}");
@@ -3,57 +3,26 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+#include "Blinker/BlinkerShadow.h"
 
 class BlinkerNumber
 {
     public :
         BlinkerNumber(char _name[])
         {
-            numName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            numName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(numName, _name);
         }
         
-        void icon(const String & _icon)
-        {
-            if (_fresh >> 0 & 0x01) free(nicon);
-
-            nicon = (char*)malloc((_icon.length()+1)*sizeof(char));
-            strcpy(nicon, _icon.c_str());
-
-            _fresh |= 0x01 << 0;
-        }
-
-        void color(const String & _clr)
-        {
-            if (_fresh >> 1 & 0x01) free(ncolor);
-
-            ncolor = (char*)malloc((_clr.length()+1)*sizeof(char));
-            strcpy(ncolor, _clr.c_str());
-
-            _fresh |= 0x01 << 1;
-        }
-
-        void unit(const String & _unit)
-        {
-            if (_fresh >> 2 & 0x01) free(nunit);
+        bool icon(const String & _icon) { return _shadow.stage(1, _icon); }
 
-            nunit = (char*)malloc((_unit.length()+1)*sizeof(char));
-            strcpy(nunit, _unit.c_str());
+        bool color(const String & _clr) { return _shadow.stage(2, _clr); }
 
-            _fresh |= 0x01 << 2;
-        }
+        bool unit(const String & _unit) { return _shadow.stage(3, _unit); }
 
         template <typename T>
-        void text(T _text)
-        {
-            if (_fresh >> 3 & 0x01) free(ntext);
-
-            String _ntext = STRING_format(_text);
-            ntext = (char*)malloc((_ntext.length()+1)*sizeof(char));
-            strcpy(ntext, _ntext.c_str());
-
-            _fresh |= 0x01 << 3;
-        }
+        bool text(T _text) { return _shadow.stage(4, STRING_format(_text)); }
         
         void print(char value)              { _print(STRING_format(value)); }
         void print(unsigned char value)     { _print(STRING_format(value)); }
@@ -66,87 +35,39 @@ class BlinkerNumber
     
     private :
         char * numName;
-        char * nicon;// = "";
-        char * ncolor;// = "";
-        char * nunit;// = "";
-        char * ntext;
-        uint8_t _fresh = 0;
+        BlinkerShadow _shadow;
 
         void _print(const String & value)
         {
-            if (_fresh == 0 && value.length() == 0) return;
-
-            String numberData = "";
+            _shadow.sync(Blinker.shadowEpoch());
 
             if (value.length())
             {
-                numberData += BLINKER_F("{\"");
-                numberData += BLINKER_F(BLINKER_CMD_VALUE);
-                numberData += BLINKER_F("\":");
-                numberData += value;
-                
                 Blinker.printNumArray(numName, value);
-            }
-
-            if (_fresh >> 0 & 0x01)
-            {
-                if (numberData.length()) numberData += BLINKER_F(",");
-                else numberData += BLINKER_F("{");
-
-                numberData += BLINKER_F("\"");
-                numberData += BLINKER_F(BLINKER_CMD_ICON);
-                numberData += BLINKER_F("\":\"");
-                numberData += nicon;
-                numberData += BLINKER_F("\"");
-
-                free(nicon);
-            }
-            
-            if (_fresh >> 1 & 0x01)
-            {
-                if (numberData.length()) numberData += BLINKER_F(",");
-                else numberData += BLINKER_F("{");
-
-                numberData += BLINKER_F("\"");
-                numberData += BLINKER_F(BLINKER_CMD_COLOR);
-                numberData += BLINKER_F("\":\"");
-                numberData += ncolor;
-                numberData += BLINKER_F("\"");
 
-                free(ncolor);
+                _shadow.check(0, value);
             }
-            
-            if (_fresh >> 2 & 0x01)
-            {
-                if (numberData.length()) numberData += BLINKER_F(",");
-                else numberData += BLINKER_F("{");
 
-                numberData += BLINKER_F("\"");
-                numberData += BLINKER_F(BLINKER_CMD_UNIT);
-                numberData += BLINKER_F("\":\"");
-                numberData += nunit;
-                numberData += BLINKER_F("\"");
+            if (!_shadow.isDirty()) return;
 
-                free(nunit);
-            }
+            String numberData = "";
 
-            if (_fresh >> 3 & 0x01)
+            if (_shadow.isDirty(0))
             {
-                if (numberData.length()) numberData += BLINKER_F(",");
-                else numberData += BLINKER_F("{");
-
-                numberData += BLINKER_F("\"");
-                numberData += BLINKER_F(BLINKER_CMD_TEXT);
-                numberData += BLINKER_F("\":\"");
-                numberData += (ntext);
-                numberData += BLINKER_F("\"");
-
-                free(ntext);
+                numberData += BLINKER_F("{\"");
+                numberData += BLINKER_F(BLINKER_CMD_VALUE);
+                numberData += BLINKER_F("\":");
+                numberData += value;
             }
 
+            _shadow.emit(numberData, 1, BLINKER_F(BLINKER_CMD_ICON));
+            _shadow.emit(numberData, 2, BLINKER_F(BLINKER_CMD_COLOR));
+            _shadow.emit(numberData, 3, BLINKER_F(BLINKER_CMD_UNIT));
+            _shadow.emit(numberData, 4, BLINKER_F(BLINKER_CMD_TEXT));
+
             numberData += BLINKER_F("}");
 
-            _fresh = 0;
+            _shadow.commit();
 
             Blinker.printArray(numName, numberData);
         }
@@ -3,6 +3,7 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerShadow.h"
 
 class BlinkerSlider
 {
@@ -20,15 +21,7 @@ class BlinkerSlider
             Blinker.freshAttachWidget(Blinker.widgetName_int(wNum), _func);
         }
         
-        void color(const String & _clr)
-        {
-            if (_fresh >> 0 & 0x01) free(textClr);
-
-            textClr = (char*)malloc((_clr.length()+1)*sizeof(char));
-            strcpy(textClr, _clr.c_str());
-
-            _fresh |= 0x01 << 0;
-        }
+        bool color(const String & _clr) { return _shadow.stage(0, _clr); }
         
         void print(char value)              { _print(STRING_format(value)); }
         void print(unsigned char value)     { _print(STRING_format(value)); }
@@ -41,16 +34,15 @@ class BlinkerSlider
     
     private :
         uint8_t wNum;
-        char * textClr;
-        uint8_t _fresh = 0;
+        BlinkerShadow _shadow;
 
         void _print(const String & n)
         {
-            if ((_fresh == 0 && n.length() == 0) || \
-                wNum == 0)
-            {
-                return;
-            }
+            if (wNum == 0) return;
+
+            _shadow.sync(Blinker.shadowEpoch());
+
+            if (!_shadow.isDirty() && n.length() == 0) return;
 
             String sliderData;
 
@@ -62,23 +54,11 @@ class BlinkerSlider
                 sliderData += n;
             }
 
-            if (_fresh >> 0 & 0x01)
-            {
-                if (sliderData.length()) sliderData += BLINKER_F(",");
-                else sliderData += BLINKER_F("{");
-
-                sliderData += BLINKER_F("\"");
-                sliderData += BLINKER_F(BLINKER_CMD_COLOR);
-                sliderData += BLINKER_F("\":\"");
-                sliderData += (textClr);
-                sliderData += BLINKER_F("\"");
-
-                free(textClr);
-            }
+            _shadow.emit(sliderData, 0, BLINKER_F(BLINKER_CMD_COLOR));
 
             sliderData += BLINKER_F("}");
 
-            _fresh = 0;
+            _shadow.commit();
 
             Blinker.printArray(Blinker.widgetName_int(wNum), sliderData);
         }
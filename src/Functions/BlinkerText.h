@@ -3,122 +3,81 @@
 
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
+#include "Blinker/BlinkerShadow.h"
 
 class BlinkerText
 {
     public :
         BlinkerText(char _name[])
         {
-            textName = (char*)malloc((strlen(_name)+1)*sizeof(char));
+            textName = (char*)BLINKER_MALLOC(HEAP_WIDGET, (strlen(_name)+1)*sizeof(char));
             strcpy(textName, _name);
         }
         
         template <typename T>
         void print(T _text)
         {
+            String _str = STRING_format(_text);
+
+            _shadow.sync(Blinker.shadowEpoch());
+
+            if (!_shadow.check(0, _str) && !_shadow.isDirty()) return;
+
             String textData = BLINKER_F("{\"");
             textData += BLINKER_F(BLINKER_CMD_TEXT);
             textData += BLINKER_F("\":\"");
-            textData += STRING_format(_text);
+            textData += _str;
             textData += BLINKER_F("\"");
-            if (_fresh >> 0 & 0x01)
-            {
-                
-                textData += BLINKER_F(",\"");
-                textData += BLINKER_F(BLINKER_CMD_ICON);
-                textData += BLINKER_F("\":\"");
-                textData += nicon;
-                textData += BLINKER_F("\"");
-
-                free(nicon);
-            }
-
-            if (_fresh >> 1 & 0x01)
-            {
-                textData += BLINKER_F(",\"");
-                textData += BLINKER_F(BLINKER_CMD_COLOR);
-                textData += BLINKER_F("\":\"");
-                textData += ncolor;
-                textData += BLINKER_F("\"");
-
-                free(ncolor);
-            }
 
-            textData += BLINKER_F("}");
-
-            _fresh = 0;
-
-            Blinker.printArray(textName, textData);
+            _print(textData);
         }
 
         template <typename T1, typename T2>
         void print(T1 _text1, T2 _text2)
         {
+            String _str1 = STRING_format(_text1);
+            String _str2 = STRING_format(_text2);
+
+            _shadow.sync(Blinker.shadowEpoch());
+
+            bool _change = _shadow.check(0, _str1);
+            _change = _shadow.check(1, _str2) || _change;
+
+            if (!_change && !_shadow.isDirty()) return;
+
             String textData = BLINKER_F("{\"");
             textData += BLINKER_F(BLINKER_CMD_TEXT);
             textData += BLINKER_F("\":\"");
-            textData += STRING_format(_text1);
+            textData += _str1;
             textData += BLINKER_F("\",\"");
             textData += BLINKER_F(BLINKER_CMD_TEXT1);
             textData += BLINKER_F("\":\"");
-            textData += STRING_format(_text2);
+            textData += _str2;
             textData += BLINKER_F("\"");
 
-            if (_fresh >> 0 & 0x01)
-            {
-                
-                textData += BLINKER_F(",\"");
-                textData += BLINKER_F(BLINKER_CMD_ICON);
-                textData += BLINKER_F("\":\"");
-                textData += nicon;
-                textData += BLINKER_F("\"");
-
-                free(nicon);
-            }
-
-            if (_fresh >> 1 & 0x01)
-            {
-                textData += BLINKER_F(",\"");
-                textData += BLINKER_F(BLINKER_CMD_COLOR);
-                textData += BLINKER_F("\":\"");
-                textData += ncolor;
-                textData += BLINKER_F("\"");
-
-                free(ncolor);
-            }
-
-            textData += BLINKER_F("}");
-
-            _fresh = 0;
-
-            Blinker.printArray(textName, textData);
+            _print(textData);
         }
 
-        void icon(const String & _icon)
-        {
-            if (_fresh >> 0 & 0x01) free(nicon);
-
-            nicon = (char*)malloc((_icon.length()+1)*sizeof(char));
-            strcpy(nicon, _icon.c_str());
+        bool icon(const String & _icon) { return _shadow.stage(2, _icon); }
 
-            _fresh |= 0x01 << 0;
-        }
+        bool color(const String & _clr) { return _shadow.stage(3, _clr); }
+    
+    private :
+        char * textName;
+        BlinkerShadow _shadow;
 
-        void color(const String & _clr)
+        void _print(String & textData)
         {
-            if (_fresh >> 1 & 0x01) free(ncolor);
+            _shadow.emit(textData, 2, BLINKER_F(BLINKER_CMD_ICON));
+            _shadow.emit(textData, 3, BLINKER_F(BLINKER_CMD_COLOR));
+
+            textData += BLINKER_F("}");
 
-            ncolor = (char*)malloc((_clr.length()+1)*sizeof(char));
-            strcpy(ncolor, _clr.c_str());
+            _shadow.commit();
 
-            _fresh |= 0x01 << 1;
+            Blinker.printArray(textName, textData);
         }
-    
-    private :
-        char * nicon;// = "";
-        char * ncolor;// = "";
-        char * textName;
-        uint8_t _fresh = 0;
 };
 
 #endif
@@ -4,15 +4,19 @@
 #if defined(ESP8266) || defined(ESP32)
 #include "Blinker/BlinkerConfig.h"
 #include "Blinker/BlinkerUtility.h"
+#include "Blinker/BlinkerHeap.h"
 
 class BlinkerTimingTimer
 {
     public :
         BlinkerTimingTimer()
-            : timerState(false)
+            : actionData(NULL)
+            , timerState(false)
             , isLoopTask(false)
         {}
 
+        ~BlinkerTimingTimer() { BLINKER_FREE(actionData); }
+
         // BlinkerTimingTimer(uint32_t _timerData, String _action, String _text)
         BlinkerTimingTimer(uint32_t _timerData, String _action)
             : timerState(false)
@@ -21,7 +25,7 @@ class BlinkerTimingTimer
             timerData  = _timerData;
             // actionData = _action;
 
-            actionData = (char*)malloc((_action.length()+1)*sizeof(char));
+            actionData = (char*)BLINKER_MALLOC(HEAP_TIMER, (_action.length()+1)*sizeof(char));
             strcpy(actionData, _action.c_str());
 
             // timerText = _text;
@@ -41,7 +45,7 @@ class BlinkerTimingTimer
             timingDay  = _timingDay;
             timingTime = _timingTime;
 
-            actionData = (char*)malloc((_action.length()+1)*sizeof(char));
+            actionData = (char*)BLINKER_MALLOC(HEAP_TIMER, (_action.length()+1)*sizeof(char));
             strcpy(actionData, _action.c_str());
 
             // actionData = _action;
@@ -55,7 +59,8 @@ class BlinkerTimingTimer
         void freshTimer(uint32_t _timerData, String _action) {
             timerData = _timerData;
 
-            actionData = (char*)malloc((_action.length()+1)*sizeof(char));
+            BLINKER_FREE(actionData);
+            actionData = (char*)BLINKER_MALLOC(HEAP_TIMER, (_action.length()+1)*sizeof(char));
             strcpy(actionData, _action.c_str());
             
             // actionData = _action;
@@ -31,7 +31,9 @@
 #include "Blinker/BlinkerDebug.h"
 #include "Blinker/BlinkerUtility.h"
 #include "Functions/BlinkerWlan.h"
+#include "Functions/BlinkerWlanCache.h"
 #include "modules/ArduinoJson/ArduinoJson.h"
+#include "Blinker/BlinkerJson.h"
 
 #if defined(ESP8266)
     #include <ESP8266WiFi.h>
@@ -114,6 +116,7 @@ class BlinkerWlan
         uint16_t timeout;
         bwl_status_t _status;
         uint32_t debugStatusTime;
+        BlinkerWlanCache _cache;
 };
 
 bool BlinkerWlan::checkConfig() {
@@ -184,6 +187,8 @@ void BlinkerWlan::deleteConfig() {
     EEPROM.commit();
     EEPROM.end();
 
+    _cache.erase();
+
     BLINKER_LOG(BLINKER_F("Erase wlan config"));
 }
 
@@ -300,6 +305,7 @@ bool BlinkerWlan::connected() {
                 BLINKER_LOG(BLINKER_F("IP address: "));
                 BLINKER_LOG(deviceIP);
                 BLINKER_LOG(BLINKER_F("SSID: "), WiFi.SSID(), BLINKER_F(" PSWD: "), WiFi.psk());
+                _cache.save();
                 
                 SSID = (char*)malloc(BLINKER_SSID_SIZE*sizeof(char));
                 PSWD = (char*)malloc(BLINKER_PSWD_SIZE*sizeof(char));
@@ -338,6 +344,7 @@ bool BlinkerWlan::connected() {
                 BLINKER_LOG(BLINKER_F("IP address: "));
                 BLINKER_LOG(deviceIP);
                 BLINKER_LOG(BLINKER_F("SSID: "), WiFi.SSID(), BLINKER_F(" PSWD: "), WiFi.psk());
+                _cache.save();
                 
                 // SSID = (char*)malloc(BLINKER_SSID_SIZE*sizeof(char));
                 // PSWD = (char*)malloc(BLINKER_PSWD_SIZE*sizeof(char));
@@ -363,11 +370,13 @@ bool BlinkerWlan::connected() {
                 BLINKER_LOG(BLINKER_F("IP address: "));
                 BLINKER_LOG(deviceIP);
                 BLINKER_LOG(BLINKER_F("SSID: "), WiFi.SSID(), BLINKER_F(" PSWD: "), WiFi.psk());
+                _cache.save();
                 
                 _status = BWL_CONNECTED_CHECK;
                 return true;
             }
             else if (WiFi.status() != WL_CONNECTED) {
+                _cache.poll();
                 return false;
             }
         case BWL_CONNECTED_CHECK :
@@ -391,6 +400,7 @@ bool BlinkerWlan::connected() {
                 BLINKER_LOG(BLINKER_F("IP address: "));
                 BLINKER_LOG(deviceIP);
                 BLINKER_LOG(BLINKER_F("SSID: "), WiFi.SSID(), BLINKER_F(" PSWD: "), WiFi.psk());
+                _cache.save();
                 
                 _status = BWL_CONNECTED_CHECK;
                 return true;
@@ -493,7 +503,7 @@ void BlinkerWlan::serverClient()
 void BlinkerWlan::parseUrl(String data)
 {
     BLINKER_LOG(BLINKER_F("APCONFIG data: "), data);
-    DynamicJsonBuffer jsonBuffer;
+    BlinkerJsonBuffer jsonBuffer;
     JsonObject& wifi_data = jsonBuffer.parseObject(data);
 
     if (!wifi_data.success()) {
@@ -540,12 +550,7 @@ void BlinkerWlan::connectWiFi(const char* _ssid, const char* _pswd)
         WiFi.setHostname(_hostname.c_str());
     #endif
 
-    if (_pswd && strlen(_pswd)) {
-        WiFi.begin(_ssid, _pswd);
-    }
-    else {
-        WiFi.begin(_ssid);
-    }
+    _cache.begin(_ssid, _pswd);
 
     // while (WiFi.status() != WL_CONNECTED) {
     //     ::delay(50);
@@ -0,0 +1,182 @@
+#ifndef BLINKER_WLAN_CACHE_H
+#define BLINKER_WLAN_CACHE_H
+
+#if defined(ESP8266) || defined(ESP32)
+
+#if ARDUINO >= 100
+    #include <Arduino.h>
+#else
+    #include <WProgram.h>
+#endif
+
+#include "Blinker/BlinkerConfig.h"
+#include "Blinker/BlinkerDebug.h"
+
+#if defined(ESP8266)
+    #include <ESP8266WiFi.h>
+#elif defined(ESP32)
+    #include <WiFi.h>
+#endif
+
+#include <EEPROM.h>
+
+struct blinker_wlan_cache_t
+{
+    uint32_t    crc;
+    uint32_t    ssidHash;
+    uint8_t     bssid[6];
+    uint8_t     channel;
+    uint8_t     reserved;
+};
+
+// last good ap of the configured ssid, lets the next boot join that ap on
+// its channel instead of a full scan, the address still comes from dhcp
+// so an expired lease is never reused, a plain begin() is used if it fails
+class BlinkerWlanCache
+{
+    public :
+        BlinkerWlanCache()
+            : isFast(false), isSaved(false), beginTime(0)
+        {
+            ssid[0] = '\0';
+            pswd[0] = '\0';
+        }
+
+        void begin(const char * _ssid, const char * _pswd);
+        // call while not connected, falls back to a scan when the
+        // direct join did not make it in BLINKER_WLAN_FAST_TIMEOUT
+        void poll();
+        // call once connected, only writes when something changed
+        void save();
+        void erase();
+
+    private :
+        bool        isFast;
+        bool        isSaved;
+        uint32_t    beginTime;
+        char        ssid[33];
+        char        pswd[65];
+
+        bool load(blinker_wlan_cache_t & cache);
+        void store(const blinker_wlan_cache_t & cache);
+        uint32_t hash(const char * data);
+        uint32_t crc32(const uint8_t * data, uint16_t len);
+};
+
+void BlinkerWlanCache::begin(const char * _ssid, const char * _pswd)
+{
+    blinker_wlan_cache_t cache;
+
+    if (_ssid != ssid) strncpy(ssid, _ssid, sizeof(ssid) - 1);
+    if (_pswd != pswd) strncpy(pswd, _pswd ? _pswd : "", sizeof(pswd) - 1);
+    ssid[sizeof(ssid) - 1] = '\0';
+    pswd[sizeof(pswd) - 1] = '\0';
+
+    isFast = load(cache);
+    isSaved = false;
+    beginTime = millis();
+
+    WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+
+    if (isFast)
+    {
+        BLINKER_LOG_ALL(BLINKER_F("wlan fast connect, channel: "), cache.channel);
+
+        WiFi.begin(ssid, strlen(pswd) ? pswd : NULL, cache.channel, cache.bssid);
+    }
+    else
+    {
+        if (strlen(pswd)) WiFi.begin(ssid, pswd);
+        else WiFi.begin(ssid);
+    }
+}
+
+void BlinkerWlanCache::poll()
+{
+    if (!isFast || millis() - beginTime < BLINKER_WLAN_FAST_TIMEOUT) return;
+
+    BLINKER_LOG(BLINKER_F("wlan fast connect fail, scan again"));
+
+    // the ap moved, don't try it next boot either
+    erase();
+    WiFi.disconnect();
+    begin(ssid, pswd);
+}
+
+void BlinkerWlanCache::save()
+{
+    if (isSaved || WiFi.status() != WL_CONNECTED) return;
+
+    blinker_wlan_cache_t cache;
+    blinker_wlan_cache_t last;
+
+    isFast = false;
+    isSaved = true;
+
+    // smartconfig and apconfig connect without begin()
+    strncpy(ssid, WiFi.SSID().c_str(), sizeof(ssid) - 1);
+
+    memset(&cache, 0, sizeof(cache));
+    cache.ssidHash = hash(WiFi.SSID().c_str());
+    memcpy(cache.bssid, WiFi.BSSID(), 6);
+    cache.channel = WiFi.channel();
+    cache.crc = crc32((uint8_t *)&cache + 4, sizeof(cache) - 4);
+
+    if (load(last) && last.crc == cache.crc) return;
+
+    store(cache);
+
+    BLINKER_LOG_ALL(BLINKER_F("wlan cache saved"));
+}
+
+void BlinkerWlanCache::erase()
+{
+    blinker_wlan_cache_t cache;
+
+    memset(&cache, 0, sizeof(cache));
+    store(cache);
+}
+
+bool BlinkerWlanCache::load(blinker_wlan_cache_t & cache)
+{
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    EEPROM.get(BLINKER_EEP_ADDR_WLAN_CACHE, cache);
+    EEPROM.end();
+
+    return cache.crc == crc32((uint8_t *)&cache + 4, sizeof(cache) - 4) && \
+            cache.ssidHash == hash(ssid) && cache.channel;
+}
+
+void BlinkerWlanCache::store(const blinker_wlan_cache_t & cache)
+{
+    EEPROM.begin(BLINKER_EEP_SIZE);
+    EEPROM.put(BLINKER_EEP_ADDR_WLAN_CACHE, cache);
+    EEPROM.commit();
+    EEPROM.end();
+}
+
+uint32_t BlinkerWlanCache::hash(const char * data)
+{
+    return crc32((const uint8_t *)data, strlen(data));
+}
+
+uint32_t BlinkerWlanCache::crc32(const uint8_t * data, uint16_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--)
+    {
+        crc ^= *data++;
+
+        for (uint8_t num = 0; num < 8; num++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+    }
+
+    return ~crc;
+}
+
+#endif
+
+#endif
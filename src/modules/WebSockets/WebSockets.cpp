@@ -30,13 +30,7 @@
 #include <core_esp8266_features.h>
 #endif
 
-extern "C" {
-#ifdef CORE_HAS_LIBB64
-#include <libb64/cencode.h>
-#else
-#include "libb64/cencode_inc.h"
-#endif
-}
+#include "../base64/Base64.h"
 
 #ifdef ESP8266
 #include <Hash.h>
@@ -512,13 +506,11 @@ String WebSockets::acceptKey(String & clientKey) {
  * @return base64 encoded String
  */
 String WebSockets::base64_encode(uint8_t * data, size_t length) {
-    size_t size = ((length * 1.6f) + 1);
+    // exact size, word at a time encoder and no line breaks
+    size_t size = ::base64_enc_len(length) + 1;
     char * buffer = (char *) malloc(size);
     if(buffer) {
-        base64_encodestate _state;
-        base64_init_encodestate(&_state);
-        int len = base64_encode_block((const char *) &data[0], length, &buffer[0], &_state);
-        len = base64_encode_blockend((buffer + len), &_state);
+        ::base64_encode(buffer, (char *) &data[0], length);
 
         String base64 = String(buffer);
         free(buffer);
@@ -1,4 +1,5 @@
 #include "Base64.h"
+#include <stdint.h>
 #if (defined(__AVR__))
     #include <avr/pgmspace.h>
 #elif defined(ESP8266) || defined(ESP32)
@@ -8,93 +9,103 @@ const char PROGMEM b64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 		"abcdefghijklmnopqrstuvwxyz"
 		"0123456789+/";
 
+/* b64_table:
+ * 		Description: Reverse of b64_alphabet, 0xff marks a byte that is
+ * 					 not a base64 digit
+ */
+const unsigned char PROGMEM b64_table[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
 /* 'Private' declarations */
-inline void a3_to_a4(unsigned char * a4, unsigned char * a3);
-inline void a4_to_a3(unsigned char * a3, unsigned char * a4);
 inline unsigned char b64_lookup(char c);
 
+/* Whole 3 byte groups are packed into one 24 bit word and split into
+ * four 6 bit indexes, only the tail takes the padding path */
 int base64_encode(char *output, char *input, int inputLen) {
-	int i = 0, j = 0;
-	int encLen = 0;
-	unsigned char a3[3];
-	unsigned char a4[4];
-
-	while(inputLen--) {
-		a3[i++] = *(input++);
-		if(i == 3) {
-			a3_to_a4(a4, a3);
-
-			for(i = 0; i < 4; i++) {
-				output[encLen++] = pgm_read_byte(&b64_alphabet[a4[i]]);
-			}
-
-			i = 0;
-		}
-	}
+	const unsigned char * in = (const unsigned char *)input;
+	char * out = output;
+	uint32_t w;
+
+	while (inputLen >= 3) {
+		w = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+
+		out[0] = pgm_read_byte(&b64_alphabet[(w >> 18) & 0x3f]);
+		out[1] = pgm_read_byte(&b64_alphabet[(w >> 12) & 0x3f]);
+		out[2] = pgm_read_byte(&b64_alphabet[(w >> 6) & 0x3f]);
+		out[3] = pgm_read_byte(&b64_alphabet[w & 0x3f]);
 
-	if(i) {
-		for(j = i; j < 3; j++) {
-			a3[j] = '\0';
-		}
+		in += 3;
+		out += 4;
+		inputLen -= 3;
+	}
 
-		a3_to_a4(a4, a3);
+	if (inputLen > 0) {
+		w = (uint32_t)in[0] << 16;
+		if (inputLen == 2) w |= (uint32_t)in[1] << 8;
 
-		for(j = 0; j < i + 1; j++) {
-			output[encLen++] = pgm_read_byte(&b64_alphabet[a4[j]]);
-		}
+		out[0] = pgm_read_byte(&b64_alphabet[(w >> 18) & 0x3f]);
+		out[1] = pgm_read_byte(&b64_alphabet[(w >> 12) & 0x3f]);
+		out[2] = inputLen == 2 ? pgm_read_byte(&b64_alphabet[(w >> 6) & 0x3f]) : '=';
+		out[3] = '=';
 
-		while((i++ < 3)) {
-			output[encLen++] = '=';
-		}
+		out += 4;
 	}
-	output[encLen] = '\0';
-	return encLen;
+
+	*out = '\0';
+	return out - output;
 }
 
+/* Decoding stops at the first '=', a trailing single digit carries
+ * no full byte and is dropped */
 int base64_decode(char * output, char * input, int inputLen) {
-	int i = 0, j = 0;
-	int decLen = 0;
-	unsigned char a3[3];
-	unsigned char a4[4];
-
-
-	while (inputLen--) {
-		if(*input == '=') {
-			break;
-		}
-
-		a4[i++] = *(input++);
-		if (i == 4) {
-			for (i = 0; i <4; i++) {
-				a4[i] = b64_lookup(a4[i]);
-			}
-
-			a4_to_a3(a3,a4);
-
-			for (i = 0; i < 3; i++) {
-				output[decLen++] = a3[i];
-			}
-			i = 0;
-		}
-	}
+	char * out = output;
+	int len = 0;
+	uint32_t w;
 
-	if (i) {
-		for (j = i; j < 4; j++) {
-			a4[j] = '\0';
-		}
+	while (len < inputLen && input[len] != '=') len++;
 
-		for (j = 0; j <4; j++) {
-			a4[j] = b64_lookup(a4[j]);
-		}
+	while (len >= 4) {
+		w = ((uint32_t)b64_lookup(input[0]) << 18) |
+			((uint32_t)b64_lookup(input[1]) << 12) |
+			((uint32_t)b64_lookup(input[2]) << 6) |
+			b64_lookup(input[3]);
 
-		a4_to_a3(a3,a4);
+		out[0] = w >> 16;
+		out[1] = w >> 8;
+		out[2] = w;
 
-		for (j = 0; j < i - 1; j++) {
-			output[decLen++] = a3[j];
-		}
+		input += 4;
+		out += 3;
+		len -= 4;
 	}
-	output[decLen] = '\0';
-	return decLen;
+
+	if (len > 1) {
+		w = ((uint32_t)b64_lookup(input[0]) << 18) |
+			((uint32_t)b64_lookup(input[1]) << 12);
+		if (len == 3) w |= (uint32_t)b64_lookup(input[2]) << 6;
+
+		*out++ = w >> 16;
+		if (len == 3) *out++ = w >> 8;
+	}
+
+	*out = '\0';
+	return out - output;
 }
 
 int base64_enc_len(int plainLen) {
@@ -112,24 +123,6 @@ int base64_dec_len(char * input, int inputLen) {
 	return ((6 * inputLen) / 8) - numEq;
 }
 
-inline void a3_to_a4(unsigned char * a4, unsigned char * a3) {
-	a4[0] = (a3[0] & 0xfc) >> 2;
-	a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
-	a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
-	a4[3] = (a3[2] & 0x3f);
-}
-
-inline void a4_to_a3(unsigned char * a3, unsigned char * a4) {
-	a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
-	a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
-	a3[2] = ((a4[2] & 0x3) << 6) + a4[3];
-}
-
 inline unsigned char b64_lookup(char c) {
-	if(c >='A' && c <='Z') return c - 'A';
-	if(c >='a' && c <='z') return c - 71;
-	if(c >='0' && c <='9') return c + 4;
-	if(c == '+') return 62;
-	if(c == '/') return 63;
-	return -1;
+	return pgm_read_byte(&b64_table[(unsigned char)c]) & 0x3f;
 }
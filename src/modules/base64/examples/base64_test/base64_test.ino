@@ -0,0 +1,105 @@
+#include <Base64.h>
+
+/*
+ Base64 test vectors and benchmark
+
+ Checks the codec against the RFC 4648 section 10 vectors in both
+ directions, then times encode and decode of a 256 byte block and
+ prints the cost per KB.
+
+ This example code is in the public domain.
+
+ */
+
+const char * const vectors[][2] = {
+  { "",       ""         },
+  { "f",      "Zg=="     },
+  { "fo",     "Zm8="     },
+  { "foo",    "Zm9v"     },
+  { "foob",   "Zm9vYg==" },
+  { "fooba",  "Zm9vYmE=" },
+  { "foobar", "Zm9vYmFy" }
+};
+
+#define BENCH_SIZE    256
+#define BENCH_ROUNDS  200
+
+char plain[BENCH_SIZE + 1];
+char encoded[BENCH_SIZE * 4 / 3 + 4];
+char decoded[BENCH_SIZE + 1];
+
+void setup()
+{
+  // start serial port at 9600 bps:
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect. Needed for Leonardo only
+  }
+
+  Serial.println("Base64 test");
+
+  int failed = 0;
+
+  for (unsigned int i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    int len = strlen(vectors[i][0]);
+
+    strcpy(plain, vectors[i][0]);
+    int encodedLen = base64_encode(encoded, plain, len);
+
+    strcpy(encoded + encodedLen + 1, vectors[i][1]);
+    int decodedLen = base64_decode(decoded, encoded + encodedLen + 1, strlen(vectors[i][1]));
+
+    bool ok = encodedLen == base64_enc_len(len) &&
+              strcmp(encoded, vectors[i][1]) == 0 &&
+              decodedLen == len &&
+              memcmp(decoded, vectors[i][0], len) == 0;
+
+    if (!ok) failed++;
+
+    Serial.print(ok ? "PASS \"" : "FAIL \"");
+    Serial.print(vectors[i][0]);
+    Serial.print("\" = ");
+    Serial.println(encoded);
+  }
+
+  // every byte value, through the tail paths too
+  for (int len = BENCH_SIZE - 2; len <= BENCH_SIZE; len++) {
+    for (int i = 0; i < len; i++) plain[i] = i * 7 + len;
+
+    int encodedLen = base64_encode(encoded, plain, len);
+    int decodedLen = base64_decode(decoded, encoded, encodedLen);
+
+    if (decodedLen != len || memcmp(decoded, plain, len) != 0) {
+      failed++;
+      Serial.print("FAIL round trip ");
+      Serial.println(len);
+    }
+  }
+
+  Serial.print(failed ? "failed: " : "all passed, failed: ");
+  Serial.println(failed);
+
+  // benchmark
+  for (int i = 0; i < BENCH_SIZE; i++) plain[i] = i;
+
+  unsigned long start = micros();
+  for (int i = 0; i < BENCH_ROUNDS; i++) base64_encode(encoded, plain, BENCH_SIZE);
+  unsigned long encodeTime = micros() - start;
+
+  int encodedLen = base64_enc_len(BENCH_SIZE);
+
+  start = micros();
+  for (int i = 0; i < BENCH_ROUNDS; i++) base64_decode(decoded, encoded, encodedLen);
+  unsigned long decodeTime = micros() - start;
+
+  Serial.print("encode us/KB: ");
+  Serial.println(encodeTime * 1024UL / ((unsigned long)BENCH_SIZE * BENCH_ROUNDS));
+  Serial.print("decode us/KB: ");
+  Serial.println(decodeTime * 1024UL / ((unsigned long)BENCH_SIZE * BENCH_ROUNDS));
+}
+
+
+void loop()
+{
+
+}
@@ -119,6 +119,12 @@ Adafruit_MQTT::Adafruit_MQTT(const char *server,
 
   packet_id_counter = 0;
 
+  last_read = 0;
+  last_pingresp = 0;
+  rxReset();
+
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++)
+    inflight_packet[i] = 0;
 }
 
 
@@ -144,12 +150,25 @@ Adafruit_MQTT::Adafruit_MQTT(const char *server,
 
   packet_id_counter = 0;
 
+  last_read = 0;
+  last_pingresp = 0;
+  rxReset();
+
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++)
+    inflight_packet[i] = 0;
+}
+
+// Packets still waiting for their PUBACK are malloc'd copies.
+Adafruit_MQTT::~Adafruit_MQTT() {
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++)
+    free(inflight_packet[i]);
 }
 
 int8_t Adafruit_MQTT::connect() {
   // Connect to the server.
   if (!connectServer())
     return -1;
+  rxReset();
   
   // Construct and send connect packet.
   uint8_t len = connectPacket(buffer);
@@ -196,6 +215,45 @@ int8_t Adafruit_MQTT::connect() {
   return 0;
 }
 
+int8_t Adafruit_MQTT::connectBegin() {
+  if (!connectServer())
+    return -1;
+  rxReset();
+
+  uint8_t len = connectPacket(buffer);
+  if (!sendPacket(buffer, len))
+    return -1;
+
+  return 0;
+}
+
+int8_t Adafruit_MQTT::connectPoll() {
+  if (!connected())
+    return -1;
+
+  uint16_t len = readFullPacket(buffer, MAXBUFFERSIZE, 0);
+  if (len == 0)
+    return MQTT_CONNECT_WAIT;
+  if (len != 4)
+    return -1;
+  if ((buffer[0] != (MQTT_CTRL_CONNECTACK << 4)) || (buffer[1] != 2))
+    return -1;
+  if (buffer[3] != 0)
+    return buffer[3];
+
+  // Send the subscriptions without waiting for the SUBACKs, the server
+  // handles them in order before anything published to us afterwards.
+  for (uint8_t i=0; i<MAXSUBSCRIPTIONS; i++) {
+    if (subscriptions[i] == 0) continue;
+
+    len = subscribePacket(buffer, subscriptions[i]->topic, subscriptions[i]->qos);
+    if (!sendPacket(buffer, len))
+      return -2;
+  }
+
+  return 0;
+}
+
 int8_t Adafruit_MQTT::connect(const char *user, const char *pass)
 {
   username = user;
@@ -226,48 +284,107 @@ uint16_t Adafruit_MQTT::processPacketsUntil(uint8_t *buffer, uint8_t waitforpack
 }
 
 uint16_t Adafruit_MQTT::readFullPacket(uint8_t *buffer, uint16_t maxsize, uint16_t timeout) {
-  // will read a packet and Do The Right Thing with length
-  uint8_t *pbuff = buffer;
+  uint16_t len = readRxPacket(timeout);
+  if (!len) return 0;
+
+  if (len > maxsize) len = maxsize;
+  memcpy(buffer, rxbuf, len);
 
-  uint16_t rlen;
+  return len;
+}
 
-  // read the packet type:
-  rlen = readPacket(pbuff, 1, timeout);
-  if (rlen != 1) return 0;
+// Wait up to timeout ms for a whole packet in rxbuf, 0 does not wait.
+uint16_t Adafruit_MQTT::readRxPacket(uint16_t timeout) {
+  uint32_t start = millis();
+  uint16_t len;
 
-  DEBUG_PRINT(F("Packet Type:\t")); DEBUG_PRINTBUFFER(pbuff, rlen);
-  pbuff++;
+  while (true) {
+    len = decodePacket();
 
-  uint32_t value = 0;
-  uint32_t multiplier = 1;
-  uint8_t encodedByte;
+    // PUBACKs only settle the in-flight window, nobody waits on them
+    if (len == 4 && (rxbuf[0] >> 4) == MQTT_CTRL_PUBACK) {
+      inflightAck(((uint16_t)rxbuf[2] << 8) | rxbuf[3]);
+      last_read = millis();
+      continue;
+    }
 
-  do {
-    rlen = readPacket(pbuff, 1, timeout);
-    if (rlen != 1) return 0;
-    encodedByte = pbuff[0]; // save the last read val
-    pbuff++; // get ready for reading the next byte
-    uint32_t intermediate = encodedByte & 0x7F;
-    intermediate *= multiplier;
-    value += intermediate;
-    multiplier *= 128;
-    if (multiplier > (128UL*128UL*128UL)) {
+    if (len)
+      break;
+
+    if (!connected() || (millis() - start) >= timeout)
+      return 0;
+    delay(1);
+  }
+
+  DEBUG_PRINT(F("Packet Length:\t")); DEBUG_PRINTLN(len);
+
+  last_read = millis();
+  if ((rxbuf[0] >> 4) == MQTT_CTRL_PINGRESP)
+    last_pingresp = last_read;
+
+  return len;
+}
+
+// Feed whatever the socket already holds into rxbuf without waiting.  The
+// decode state survives between calls, so a packet may arrive in pieces.
+// Returns the packet length once one is complete, 0 otherwise.  The tail of
+// a packet too big for rxbuf is read and dropped.
+uint16_t Adafruit_MQTT::decodePacket() {
+  uint8_t c;
+
+  // fixed header and remaining length, a byte at a time so nothing past
+  // this packet is consumed
+  while (rx_mult) {
+    if (readAvailable(&c, 1) != 1)
+      return 0;
+
+    rxbuf[rx_len++] = c;
+    if (rx_len == 1)
+      continue;
+
+    rx_remain += (uint32_t)(c & 0x7F) * rx_mult;
+    if (!(c & 0x80)) {
+      rx_mult = 0;
+      break;
+    }
+
+    rx_mult *= 128;
+    if (rx_mult > (128UL*128UL*128UL)) {
       DEBUG_PRINT(F("Malformed packet len\n"));
+      rxReset();
       return 0;
     }
-  } while (encodedByte & 0x80);
+  }
 
-  DEBUG_PRINT(F("Packet Length:\t")); DEBUG_PRINTLN(value);
+  // remaining bytes in bulk
+  while (rx_remain) {
+    uint16_t room = MAXBUFFERSIZE - 1 - rx_len;
+    uint16_t want, got;
 
-  if (value > (maxsize - (pbuff-buffer) - 1)) {
-      DEBUG_PRINTLN(F("Packet too big for buffer"));
-      rlen = readPacket(pbuff, (maxsize - (pbuff-buffer) - 1), timeout);
-  } else {
-    rlen = readPacket(pbuff, value, timeout);
+    if (room) {
+      want = rx_remain < room ? rx_remain : room;
+      got = readAvailable(rxbuf + rx_len, want);
+      rx_len += got;
+    } else {
+      uint8_t skip[32];
+      want = rx_remain < sizeof(skip) ? rx_remain : sizeof(skip);
+      got = readAvailable(skip, want);
+    }
+
+    if (!got)
+      return 0;
+    rx_remain -= got;
   }
-  //DEBUG_PRINT(F("Remaining packet:\t")); DEBUG_PRINTBUFFER(pbuff, rlen);
-  
-  return ((pbuff - buffer)+rlen);
+
+  uint16_t len = rx_len;
+  rxReset();
+  return len;
+}
+
+void Adafruit_MQTT::rxReset() {
+  rx_len = 0;
+  rx_remain = 0;
+  rx_mult = 1;
 }
 
 const __FlashStringHelper* Adafruit_MQTT::connectErrorString(int8_t code) {
@@ -281,6 +398,7 @@ const __FlashStringHelper* Adafruit_MQTT::connectErrorString(int8_t code) {
       case 7: return F("You have been banned from connecting. Please contact the MQTT server administrator for more details.");
       case -1: return F("Connection failed");
       case -2: return F("Failed to subscribe");
+      case -3: return F("Timed out waiting for the connection ack");
       default: return F("Unknown error");
    }
 }
@@ -302,33 +420,134 @@ bool Adafruit_MQTT::publish(const char *topic, const char *data, uint8_t qos) {
 }
 
 bool Adafruit_MQTT::publish(const char *topic, uint8_t *data, uint16_t bLen, uint8_t qos) {
-  // Construct and send publish packet.
-  uint16_t len = publishPacket(buffer, topic, data, bLen, qos);
-  if (!sendPacket(buffer, len))
-    return false;
+  Adafruit_MQTT_Segment payload(data, bLen);
+  return publish(topic, &payload, 1, qos);
+}
+
+// The payload is written from where its segments live: small ones are
+// gathered behind the header in the shared buffer, big ones go straight to
+// the client, so the message is not limited to MAXBUFFERSIZE.  QoS1 builds
+// the whole packet once in its in-flight copy and sends that.
+bool Adafruit_MQTT::publish(const char *topic, const Adafruit_MQTT_Segment *payload, uint8_t num, uint8_t qos) {
+  uint8_t slot = MQTT_INFLIGHT_MAX;
+
+  // QoS1 needs a free in-flight slot to keep the packet until it is acked
+  if (qos > 0) {
+    for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++) {
+      if (!inflight_packet[i]) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot == MQTT_INFLIGHT_MAX) {
+      DEBUG_PRINTLN(F("In-flight window full"));
+      return false;
+    }
+  }
+
+  uint32_t bLen = 0;
+  for (uint8_t i=0; i<num; i++)
+    bLen += payload[i].len;
+
+  // Construct the header, the payload follows.
+  uint16_t len = publishHeader(buffer, topic, bLen, qos);
 
-  // If QOS level is high enough verify the response packet.
   if (qos > 0) {
-    len = readFullPacket(buffer, MAXBUFFERSIZE, PUBLISH_TIMEOUT_MS);
-    DEBUG_PRINT(F("Publish QOS1+ reply:\t"));
-    DEBUG_PRINTBUFFER(buffer, len);
-    if (len != 4)
+    if (len + bLen > 0xFFFF)
       return false;
-    if ((buffer[0] >> 4) != MQTT_CTRL_PUBACK)
+
+    uint8_t *packet = (uint8_t *)malloc(len + bLen);
+    if (!packet)
+      return false;
+
+    memcpy(packet, buffer, len);
+    for (uint8_t i=0; i<num; i++) {
+      memcpy(packet + len, payload[i].data, payload[i].len);
+      len += payload[i].len;
+    }
+
+    inflight_packet[slot] = packet;
+    inflight_len[slot] = len;
+    inflight_id[slot] = packet_id_counter - 1;
+    inflight_time[slot] = millis();
+    inflight_tries[slot] = 1;
+
+    // queued is as good as sent, when this write fails the packet goes
+    // out again with DUP set, so a caller retry would only duplicate it
+    if (!sendPacket(packet, len))
+      DEBUG_PRINTLN(F("Publish queued, resend pending"));
+    return true;
+  }
+
+  for (uint8_t i=0; i<num; i++) {
+    if (payload[i].len <= MAXBUFFERSIZE - len) {
+      memcpy(buffer + len, payload[i].data, payload[i].len);
+      len += payload[i].len;
+      continue;
+    }
+
+    if (len && !sendPacket(buffer, len))
       return false;
-    uint16_t packnum = buffer[2];
-    packnum <<= 8;
-    packnum |= buffer[3];
+    len = 0;
 
-    // we increment the packet_id_counter right after publishing so inc here too to match
-    packnum++;
-    if (packnum != packet_id_counter)
+    if (!sendPacket((uint8_t *)payload[i].data, payload[i].len))
       return false;
   }
 
+  if (len && !sendPacket(buffer, len))
+    return false;
+
   return true;
 }
 
+uint8_t Adafruit_MQTT::inflightNum() {
+  uint8_t num = 0;
+
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++) {
+    if (inflight_packet[i])
+      num++;
+  }
+
+  return num;
+}
+
+bool Adafruit_MQTT::inflightAck(uint16_t packetid) {
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++) {
+    if (inflight_packet[i] && inflight_id[i] == packetid) {
+      free(inflight_packet[i]);
+      inflight_packet[i] = 0;
+      return true;
+    }
+  }
+
+  DEBUG_PRINT(F("PUBACK for unknown packet ")); DEBUG_PRINTLN(packetid);
+  return false;
+}
+
+// Resend QoS1 publishes whose PUBACK is overdue, only called while the
+// session is up so nothing goes out ahead of the CONNACK.
+void Adafruit_MQTT::inflightRetry() {
+  for (uint8_t i=0; i<MQTT_INFLIGHT_MAX; i++) {
+    if (!inflight_packet[i] || (millis() - inflight_time[i]) < PUBLISH_RETRY_MS)
+      continue;
+
+    if (inflight_tries[i] >= PUBLISH_RETRY_MAX) {
+      ERROR_PRINT(F("No PUBACK, dropped packet ")); ERROR_PRINTLN(inflight_id[i]);
+      free(inflight_packet[i]);
+      inflight_packet[i] = 0;
+      continue;
+    }
+
+    inflight_packet[i][0] |= 0x08;  // DUP
+    inflight_time[i] = millis();
+    inflight_tries[i]++;
+
+    DEBUG_PRINT(F("Resending packet ")); DEBUG_PRINTLN(inflight_id[i]);
+    if (!sendPacket(inflight_packet[i], inflight_len[i]))
+      return;
+  }
+}
+
 bool Adafruit_MQTT::will(const char *topic, const char *payload, uint8_t qos, uint8_t retain) {
 
   if (connected()) {
@@ -511,18 +730,22 @@ void Adafruit_MQTT::processPackets(int16_t timeout) {
 Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
   uint16_t i, topiclen, datalen;
 
+  inflightRetry();
+
   // Check if data is available to read.
-  uint16_t len = readFullPacket(buffer, MAXBUFFERSIZE, timeout); // return one full packet
+  uint16_t len = readRxPacket(timeout > 0 ? timeout : 0); // return one full packet
   if (!len)
     return NULL;  // No data available, just quit.
+  if ((rxbuf[0] >> 4) != MQTT_CTRL_PUBLISH)
+    return NULL;  // a ping response or some other reply, nothing to deliver
   DEBUG_PRINT("Packet len: "); DEBUG_PRINTLN(len); 
-  DEBUG_PRINTBUFFER(buffer, len);
+  DEBUG_PRINTBUFFER(rxbuf, len);
   
   // Parse out length of packet.
   if(len <= 129)
-    topiclen = buffer[3];
+    topiclen = rxbuf[3];
   else
-    topiclen = buffer[4];
+    topiclen = rxbuf[4];
   DEBUG_PRINT(F("Looking for subscription len ")); DEBUG_PRINTLN(topiclen);
 
   // Find subscription associated with this packet.
@@ -535,13 +758,13 @@ Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
       // Stop if the subscription topic matches the received topic. Be careful
       // to make comparison case insensitive.
       if(len <= 129) {
-        if (strncasecmp((char*)buffer+4, subscriptions[i]->topic, topiclen) == 0) {
+        if (strncasecmp((char*)rxbuf+4, subscriptions[i]->topic, topiclen) == 0) {
           DEBUG_PRINT(F("Found sub #")); DEBUG_PRINTLN(i);
           break;
         }
       }
       else  {
-        if (strncasecmp((char*)buffer+5, subscriptions[i]->topic, topiclen) == 0) {
+        if (strncasecmp((char*)rxbuf+5, subscriptions[i]->topic, topiclen) == 0) {
           DEBUG_PRINT(F("Found sub #")); DEBUG_PRINTLN(i);
           break;
         }
@@ -553,11 +776,11 @@ Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
   uint8_t packet_id_len = 0;
   uint16_t packetid = 0;
   // Check if it is QoS 1, TODO: we dont support QoS 2
-  if ((buffer[0] & 0x6) == 0x2) {
+  if ((rxbuf[0] & 0x6) == 0x2) {
     packet_id_len = 2;
-    packetid = buffer[topiclen+4];
+    packetid = rxbuf[topiclen+4];
     packetid <<= 8;
-    packetid |= buffer[topiclen+5];
+    packetid |= rxbuf[topiclen+5];
   }
 
   // zero out the old data
@@ -568,12 +791,12 @@ Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
       datalen = SUBSCRIPTIONDATALEN-1; // cut it off
     }
     // extract out just the data, into the subscription object itself
-    memmove(subscriptions[i]->lastread, buffer+4+topiclen+packet_id_len, datalen);
+    memmove(subscriptions[i]->lastread, rxbuf+4+topiclen+packet_id_len, datalen);
     subscriptions[i]->datalen = datalen;
     DEBUG_PRINT(F("Data len: ")); DEBUG_PRINTLN(datalen);
     DEBUG_PRINT(F("Data: ")); DEBUG_PRINTLN((char *)subscriptions[i]->lastread);
 
-    if ((MQTT_PROTOCOL_LEVEL > 3) &&(buffer[0] & 0x6) == 0x2) {
+    if ((MQTT_PROTOCOL_LEVEL > 3) &&(rxbuf[0] & 0x6) == 0x2) {
       uint8_t ackpacket[4];
       
       // Construct and send puback packet.
@@ -589,12 +812,12 @@ Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
     }
     // extract out just the data, into the subscription object itself
 
-    memmove(subscriptions[i]->lastread, buffer+5+topiclen+packet_id_len, datalen);
+    memmove(subscriptions[i]->lastread, rxbuf+5+topiclen+packet_id_len, datalen);
     subscriptions[i]->datalen = datalen;
     DEBUG_PRINT(F("Data len: ")); DEBUG_PRINTLN(datalen);
     DEBUG_PRINT(F("Data: ")); DEBUG_PRINTLN((char *)subscriptions[i]->lastread);
 
-    if ((MQTT_PROTOCOL_LEVEL > 3) &&(buffer[0] & 0x6) == 0x2) {
+    if ((MQTT_PROTOCOL_LEVEL > 3) &&(rxbuf[0] & 0x6) == 0x2) {
       uint8_t ackpacket[5];
       
       // Construct and send puback packet.
@@ -614,6 +837,11 @@ void Adafruit_MQTT::flushIncoming(uint16_t timeout) {
   while (readPacket(buffer, MAXBUFFERSIZE, timeout));
 }
 
+bool Adafruit_MQTT::pingBegin() {
+  uint8_t len = pingPacket(buffer);
+  return sendPacket(buffer, len);
+}
+
 bool Adafruit_MQTT::ping(uint8_t num) {
   //flushIncoming(100);
 
@@ -739,10 +967,12 @@ uint8_t Adafruit_MQTT::connectPacket(uint8_t *packet) {
 
 
 // as per http://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718040
-uint16_t Adafruit_MQTT::publishPacket(uint8_t *packet, const char *topic,
-                                     uint8_t *data, uint16_t bLen, uint8_t qos) {
+// Fixed header, topic and packet id of a PUBLISH carrying bLen bytes of
+// payload, returns the header length.
+uint16_t Adafruit_MQTT::publishHeader(uint8_t *packet, const char *topic,
+                                     uint32_t bLen, uint8_t qos) {
   uint8_t *p = packet;
-  uint16_t len=0;
+  uint32_t len=0;
 
   // calc length of non-header data
   len += 2;               // two bytes to set the topic size
@@ -773,6 +1003,9 @@ uint16_t Adafruit_MQTT::publishPacket(uint8_t *packet, const char *topic,
 
   // add packet identifier. used for checking PUBACK in QOS > 0
   if(qos > 0) {
+    if (packet_id_counter == 0)  // 0 is not a valid packet id
+      packet_id_counter++;
+
     p[0] = (packet_id_counter >> 8) & 0xFF;
     p[1] = packet_id_counter & 0xFF;
     p+=2;
@@ -781,11 +1014,9 @@ uint16_t Adafruit_MQTT::publishPacket(uint8_t *packet, const char *topic,
     packet_id_counter++;
   }
 
-  memmove(p, data, bLen);
-  p+= bLen;
   len = p - packet;
-  DEBUG_PRINTLN(F("MQTT publish packet:"));
-  DEBUG_PRINTBUFFER(buffer, len);
+  DEBUG_PRINTLN(F("MQTT publish header:"));
+  DEBUG_PRINTBUFFER(packet, len);
   return len;
 }
 
@@ -85,10 +85,20 @@
 #define MQTT_QOS_0 0x0
 
 #define CONNECT_TIMEOUT_MS 6000
+// connectPoll() result while the CONNACK has not arrived yet
+#define MQTT_CONNECT_WAIT  0x7F
 #define PUBLISH_TIMEOUT_MS 500
 #define PING_TIMEOUT_MS    500
 #define SUBACK_TIMEOUT_MS  500
 
+// QoS1 publishes that may wait for their PUBACK at the same time.  One that
+// is not acked in PUBLISH_RETRY_MS is sent again with DUP set, and given
+// up after PUBLISH_RETRY_MAX tries.  Fixed, it sizes arrays of the class
+// that Adafruit_MQTT.cpp is built with.
+#define MQTT_INFLIGHT_MAX  4
+#define PUBLISH_RETRY_MS   5000
+#define PUBLISH_RETRY_MAX  3
+
 // Adjust as necessary, in seconds.  Default to 5 minutes.
 #define MQTT_CONN_KEEPALIVE 300
 
@@ -130,6 +140,18 @@ extern void printBuffer(uint8_t *buffer, uint16_t len);
 
 class Adafruit_MQTT_Subscribe;  // forward decl
 
+// One piece of a payload published in segments, it must stay valid until
+// publish() returns.
+struct Adafruit_MQTT_Segment {
+  Adafruit_MQTT_Segment(const char *str)
+    : data((const uint8_t *)str), len(strlen(str)) {}
+  Adafruit_MQTT_Segment(const uint8_t *buf, uint16_t buflen)
+    : data(buf), len(buflen) {}
+
+  const uint8_t *data;
+  uint16_t len;
+};
+
 class Adafruit_MQTT {
  public:
   Adafruit_MQTT(const char *server,
@@ -142,7 +164,7 @@ class Adafruit_MQTT {
                 uint16_t port,
                 const char *user = "",
                 const char *pass = "");
-  virtual ~Adafruit_MQTT() {}
+  virtual ~Adafruit_MQTT();
 
   // Connect to the MQTT server.  Returns 0 on success, otherwise an error code
   // that indicates something went wrong:
@@ -158,6 +180,12 @@ class Adafruit_MQTT {
   int8_t connect();
   int8_t connect(const char *user, const char *pass);
 
+  // Non-blocking connect. connectBegin() opens the connection and sends the
+  // connect packet, then connectPoll() returns MQTT_CONNECT_WAIT until the
+  // connect ack is in, and the same codes as connect() after that.
+  int8_t connectBegin();
+  int8_t connectPoll();
+
   // Return a printable string version of the error code returned by
   // connect(). This returns a __FlashStringHelper*, which points to a
   // string stored in flash, but can be directly passed to e.g.
@@ -176,9 +204,15 @@ class Adafruit_MQTT {
   bool will(const char *topic, const char *payload, uint8_t qos = 0, uint8_t retain = 0);
 
   // Publish a message to a topic using the specified QoS level.  Returns true
-  // if the message was published, false otherwise.
+  // if the message was published, false otherwise.  QoS1 does not wait for
+  // the PUBACK, the message stays in flight until readSubscription() sees
+  // it and true means it was queued, even if the first write failed, false
+  // means the in-flight window is full or the copy could not be made.
   bool publish(const char *topic, const char *payload, uint8_t qos = 0);
   bool publish(const char *topic, uint8_t *payload, uint16_t bLen, uint8_t qos = 0);
+  // Publish a payload made of num segments, sent in order without first
+  // copying them together.
+  bool publish(const char *topic, const Adafruit_MQTT_Segment *payload, uint8_t num, uint8_t qos = 0);
 
   // Add a subscription to receive messages for a topic.  Returns true if the
   // subscription could be added or was already present, false otherwise.
@@ -202,6 +236,17 @@ class Adafruit_MQTT {
   // Ping the server to ensure the connection is still alive.
   bool ping(uint8_t n = 1);
 
+  // Send a ping without waiting, the response is picked up by whatever
+  // reads the next packet and shows in lastPingResp().
+  bool pingBegin();
+
+  // millis() of the last packet / ping response read from the server.
+  uint32_t lastRead() { return last_read; }
+  uint32_t lastPingResp() { return last_pingresp; }
+
+  // QoS1 publishes still waiting for their PUBACK.
+  uint8_t inflightNum();
+
  protected:
   // Interface that subclasses need to implement:
 
@@ -219,6 +264,12 @@ class Adafruit_MQTT {
   // milliseconds) for data to be available. 
   virtual uint16_t readPacket(uint8_t *buffer, uint16_t maxlen, int16_t timeout) = 0;
 
+  // Read up to maxlen bytes that have already arrived, without waiting.
+  // The default falls back on a short readPacket().
+  virtual uint16_t readAvailable(uint8_t *buffer, uint16_t maxlen) {
+    return readPacket(buffer, 1, 0);
+  }
+
   // Read a full packet, keeping note of the correct length
   uint16_t readFullPacket(uint8_t *buffer, uint16_t maxsize, uint16_t timeout);
   // Properly process packets until you get to one you want
@@ -236,16 +287,37 @@ class Adafruit_MQTT {
   uint8_t will_retain;
   uint8_t buffer[MAXBUFFERSIZE];  // one buffer, used for all incoming/outgoing
   uint16_t packet_id_counter;
+  uint32_t last_read;
+  uint32_t last_pingresp;
+  uint8_t rxbuf[MAXBUFFERSIZE];  // incoming packet, filled as bytes arrive
+  uint16_t rx_len;
+  uint32_t rx_remain;
+  uint32_t rx_mult;
+  // QoS1 publishes waiting for a PUBACK, the packet is kept to resend it
+  uint8_t *inflight_packet[MQTT_INFLIGHT_MAX];
+  uint16_t inflight_len[MQTT_INFLIGHT_MAX];
+  uint16_t inflight_id[MQTT_INFLIGHT_MAX];
+  uint32_t inflight_time[MQTT_INFLIGHT_MAX];
+  uint8_t inflight_tries[MQTT_INFLIGHT_MAX];
 
  private:
   Adafruit_MQTT_Subscribe *subscriptions[MAXSUBSCRIPTIONS];
 
   void    flushIncoming(uint16_t timeout);
 
+  // Incremental packet decoder behind readFullPacket() / readSubscription().
+  uint16_t readRxPacket(uint16_t timeout);
+  uint16_t decodePacket();
+  void    rxReset();
+
+  // In-flight window for QoS1 publishes.
+  bool    inflightAck(uint16_t packetid);
+  void    inflightRetry();
+
   // Functions to generate MQTT packets.
   uint8_t connectPacket(uint8_t *packet);
   uint8_t disconnectPacket(uint8_t *packet);
-  uint16_t publishPacket(uint8_t *packet, const char *topic, uint8_t *payload, uint16_t bLen, uint8_t qos);
+  uint16_t publishHeader(uint8_t *packet, const char *topic, uint32_t bLen, uint8_t qos);
   uint8_t subscribePacket(uint8_t *packet, const char *topic, uint8_t qos);
   uint8_t unsubscribePacket(uint8_t *packet, const char *topic);
   uint8_t pingPacket(uint8_t *packet);
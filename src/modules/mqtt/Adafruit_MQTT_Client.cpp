@@ -80,6 +80,18 @@ uint16_t Adafruit_MQTT_Client::readPacket(uint8_t *buffer, uint16_t maxlen,
   return len;
 }
 
+uint16_t Adafruit_MQTT_Client::readAvailable(uint8_t *buffer, uint16_t maxlen) {
+  int len = client->available();
+  if (len <= 0)
+    return 0;
+
+  if (len > maxlen)
+    len = maxlen;
+
+  len = client->read(buffer, len);
+  return len > 0 ? len : 0;
+}
+
 bool Adafruit_MQTT_Client::sendPacket(uint8_t *buffer, uint16_t len) {
     uint16_t ret = 0;
 
@@ -94,6 +106,7 @@ bool Adafruit_MQTT_Client::sendPacket(uint8_t *buffer, uint16_t len) {
             DEBUG_PRINT(F("Client sendPacket sendlen: ")); DEBUG_PRINTLN(sendlen);
             DEBUG_PRINT(F("Client sendPacket len: ")); DEBUG_PRINTLN(len);
             len -= ret;
+            buffer += ret;
 
             if (ret != sendlen) {
                 DEBUG_PRINTLN("Failed to send packet.");
@@ -51,6 +51,7 @@ class Adafruit_MQTT_Client : public Adafruit_MQTT {
   bool disconnectServer();
   bool connected();
   uint16_t readPacket(uint8_t *buffer, uint16_t maxlen, int16_t timeout);
+  uint16_t readAvailable(uint8_t *buffer, uint16_t maxlen);
   bool sendPacket(uint8_t *buffer, uint16_t len);
 
  private: